@@ -0,0 +1,370 @@
+// Compares FlatHashMap with std::unordered_map on course-ID keys, loads the same catalog
+// under each index policy, times the catalog's course graph, the catalog as a disk catalog
+// and a timetable query on it, then compares in-place reloads with rebuilds by time and peak
+// heap.
+// Usage: catalog_index_bench [CATALOG_FILE]
+// Without a file, a synthetic 300k-course catalog is written to the temp directory.
+
+#include "catalog/catalog.hpp"
+#include "catalog/catalog_report.hpp"
+#include "catalog/course_graph.hpp"
+#include "catalog/disk_catalog.hpp"
+#include "catalog/flat_hash_map.hpp"
+#include "catalog/reclaimer.hpp"
+#include "catalog/timetable.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <ostream>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kKeys = 300000;
+constexpr int kRounds = 5;
+
+// Live and high-water heap bytes, counted by the replacement operator new below.
+std::atomic<std::size_t> heapInUse{0};
+std::atomic<std::size_t> heapPeak{0};
+
+// Each block carries its size in a header kept at max_align_t alignment.
+constexpr std::size_t kHeaderBytes = alignof(std::max_align_t);
+
+// Best of kRounds runs, in nanoseconds.
+template <typename Work>
+double bestOf(Work work) {
+    double best = 1e300;
+    for (int round = 0; round < kRounds; ++round) {
+        const auto started = std::chrono::steady_clock::now();
+        work();
+        best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count());
+    }
+    return best;
+}
+
+void compareMaps() {
+    std::vector<std::string> keys;
+    std::vector<std::string> absent;
+    for (std::size_t i = 0; i < kKeys; ++i) {
+        keys.push_back("CS" + std::to_string(100000 + i * 7));
+        absent.push_back("MA" + std::to_string(100000 + i * 7));
+    }
+    std::vector<std::string> probes = keys;
+    std::shuffle(probes.begin(), probes.end(), std::mt19937_64(7));
+
+    FlatHashMap<std::string, std::size_t, StringHash> flat;
+    std::unordered_map<std::string, std::size_t> unordered;
+    volatile std::size_t sink = 0;
+
+    const double flatBuild = bestOf([&] {
+        FlatHashMap<std::string, std::size_t, StringHash> built;
+        for (std::size_t i = 0; i < kKeys; ++i) {
+            built.try_emplace(keys[i], i);
+        }
+        flat = std::move(built);
+    });
+    const double unorderedBuild = bestOf([&] {
+        std::unordered_map<std::string, std::size_t> built;
+        for (std::size_t i = 0; i < kKeys; ++i) {
+            built.try_emplace(keys[i], i);
+        }
+        unordered = std::move(built);
+    });
+    const double flatHit = bestOf([&] {
+        std::size_t sum = 0;
+        for (const auto& key : probes) {
+            sum += flat.find(key)->second;
+        }
+        sink = sum;
+    });
+    const double unorderedHit = bestOf([&] {
+        std::size_t sum = 0;
+        for (const auto& key : probes) {
+            sum += unordered.find(key)->second;
+        }
+        sink = sum;
+    });
+    const double flatMiss = bestOf([&] {
+        std::size_t sum = 0;
+        for (const auto& key : absent) {
+            sum += flat.contains(key) ? 1 : 0;
+        }
+        sink = sum;
+    });
+    const double unorderedMiss = bestOf([&] {
+        std::size_t sum = 0;
+        for (const auto& key : absent) {
+            sum += unordered.count(key);
+        }
+        sink = sum;
+    });
+    (void)sink;
+
+    const double keyCount = static_cast<double>(kKeys);
+    std::printf("%zu keys          FlatHashMap   unordered_map   speedup\n", kKeys);
+    std::printf("build (ns/key)   %11.1f   %13.1f   %6.2fx\n", flatBuild / keyCount, unorderedBuild / keyCount,
+                unorderedBuild / flatBuild);
+    std::printf("hit (ns)         %11.1f   %13.1f   %6.2fx\n", flatHit / keyCount, unorderedHit / keyCount,
+                unorderedHit / flatHit);
+    std::printf("miss (ns)        %11.1f   %13.1f   %6.2fx\n\n", flatMiss / keyCount, unorderedMiss / keyCount,
+                unorderedMiss / flatMiss);
+}
+
+// Courses CS100000 up, each with up to three prerequisites among the courses before it.
+std::filesystem::path writeSyntheticCatalog() {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "catalog_index_bench.csv";
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    std::mt19937_64 random(11);
+    for (std::size_t i = 0; i < kKeys; ++i) {
+        out << "CS" << 100000 + i << ",Course number " << i << " title";
+        const std::size_t prerequisites = i == 0 ? 0 : random() % 4;
+        for (std::size_t p = 0; p < prerequisites; ++p) {
+            out << ",CS" << 100000 + random() % i;
+        }
+        out << '\n';
+    }
+    return path;
+}
+
+template <typename Index>
+void measureCatalog(const char* label, const std::string& fileName) {
+    BasicCatalog<Index> catalog;
+    LoadOptions options;
+    options.skipUnchanged = false;
+    double loadNs = 0;
+    const double bestLoad = bestOf([&] { catalog.load(fileName, options); });
+    loadNs = bestLoad;
+
+    const std::vector<std::string>& ids = catalog.sortedIds();
+    volatile std::size_t sink = 0;
+    const double lookups = bestOf([&] {
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < ids.size(); ++i) {
+            found += catalog.get(ids[(i * 7919) % ids.size()]) != nullptr ? 1 : 0;
+        }
+        sink = found;
+    });
+    (void)sink;
+    std::printf("%-12s %8.0f ms load   %6.1f M lookups/s   %6.1f MB\n", label, loadNs / 1e6,
+                static_cast<double>(ids.size()) / lookups * 1e3, static_cast<double>(catalog.memoryFootprint()) / 1e6);
+}
+
+// Swallows the catalog book so only formatting is timed.
+class DiscardBuffer : public std::streambuf {
+protected:
+    int overflow(int character) override { return character; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+// Builds the course graph and reports what it adds to the catalog's footprint, then times
+// every prerequisite closure and the whole catalog book, both of which walk the graph.
+void measureCourseGraph(const std::string& fileName) {
+    Catalog catalog;
+    catalog.load(fileName);
+    CourseGraph graph;
+    const double buildNs = bestOf([&] { graph.build(catalog); });
+    const double closuresNs = bestOf([&] { computePrerequisiteClosures(graph); });
+    DiscardBuffer discard;
+    std::ostream book(&discard);
+    const double bookNs = bestOf([&] { writeCatalogReport(catalog, book); });
+    std::size_t hotBytes = graph.size() * sizeof(CourseGraph::HotCourse);
+    for (std::size_t handle = 0; handle < graph.size(); ++handle) {
+        hotBytes += graph.prerequisites(handle).size() * sizeof(std::uint32_t);
+    }
+    std::printf("\nCourse graph: built in %.0f ms, %.1f MB on top of the catalog's %.1f MB (hot half %.1f MB)\n",
+                buildNs / 1e6, static_cast<double>(graph.memoryFootprint()) / 1e6,
+                static_cast<double>(catalog.memoryFootprint()) / 1e6, static_cast<double>(hotBytes) / 1e6);
+    std::printf("all closures %5.0f ms   catalog book %5.0f ms\n", closuresNs / 1e6, bookNs / 1e6);
+}
+
+// Writes the catalog as a disk catalog, then times random gets with the default cache and
+// with the cache effectively off, and a full scan. The file stays in the OS page cache.
+void measureDiskCatalog(const std::string& fileName) {
+    Catalog catalog;
+    catalog.load(fileName);
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "catalog_index_bench.cdb";
+    std::string error;
+    const double writeNs = bestOf([&] { writeDiskCatalog(catalog, path, error); });
+
+    std::vector<std::string> probes = catalog.sortedIds();
+    std::shuffle(probes.begin(), probes.end(), std::mt19937_64(13));
+    volatile std::size_t sink = 0;
+    const auto randomGets = [&](const DiskCatalog& disk) {
+        return bestOf([&] {
+            std::size_t found = 0;
+            for (const std::string& id : probes) {
+                found += disk.get(id, error) ? 1 : 0;
+            }
+            sink = found;
+        }) / static_cast<double>(probes.size());
+    };
+
+    DiskCatalog cached;
+    cached.open(path, error);
+    const double cachedGetNs = randomGets(cached);
+    const double scanNs = bestOf([&] {
+        std::size_t seen = 0;
+        cached.scan("", [&](const Course&) { return ++seen != 0; }, error);
+        sink = seen;
+    });
+    DiskCatalog uncached;
+    uncached.open(path, error, 1);
+    const double uncachedGetNs = randomGets(uncached);
+    (void)sink;
+
+    std::printf("\nDisk catalog: %.1f MB, %u levels, written in %.0f ms%s\n",
+                static_cast<double>(std::filesystem::file_size(path)) / 1e6, cached.height(), writeNs / 1e6,
+                error.empty() ? "" : "  FAILED");
+    std::printf("random get %5.1f us (%zu MB cache)   %5.1f us (no cache)   full scan %4.0f ms\n",
+                cachedGetNs / 1e3, DiskCatalog::kDefaultCacheBytes >> 20, uncachedGetNs / 1e3, scanNs / 1e6);
+    std::filesystem::remove(path);
+}
+
+// 3,000 sections of random courses at random hours, then openSections() for 40 completed
+// courses and a four-section schedule, averaged over many random students.
+void measureTimetable(const std::string& fileName) {
+    Catalog catalog;
+    catalog.load(fileName);
+    const std::vector<std::string>& ids = catalog.sortedIds();
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "catalog_index_bench_sections.csv";
+    std::mt19937_64 random(17);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        const char* const patterns[] = {"MWF", "TR", "M", "W", "F", "MTWRF"};
+        for (std::size_t section = 0; section < 3000; ++section) {
+            const std::size_t start = 8 * 60 + (random() % 120) * 5;
+            const std::size_t end = start + (random() % 2 == 0 ? 50 : 75);
+            char times[32];
+            std::snprintf(times, sizeof times, "%02zu:%02zu,%02zu:%02zu", start / 60, start % 60, end / 60, end % 60);
+            out << ids[random() % ids.size()] << ",S" << section << ',' << patterns[random() % 6] << ',' << times
+                << ",30\n";
+        }
+    }
+    Timetable timetable;
+    timetable.load(path.string(), catalog);
+
+    constexpr std::size_t kStudents = 2000;
+    std::vector<std::vector<std::string>> taken(kStudents);
+    std::vector<std::vector<std::uint32_t>> schedules(kStudents);
+    for (std::size_t student = 0; student < kStudents; ++student) {
+        for (int course = 0; course < 40; ++course) {
+            taken[student].push_back(ids[random() % ids.size()]);
+        }
+        for (int section = 0; section < 4; ++section) {
+            schedules[student].push_back(static_cast<std::uint32_t>(random() % timetable.size()));
+        }
+    }
+    volatile std::size_t sink = 0;
+    const double queryNs = bestOf([&] {
+        std::size_t open = 0;
+        for (std::size_t student = 0; student < kStudents; ++student) {
+            open += timetable.openSections(taken[student], schedules[student]).size();
+        }
+        sink = open;
+    }) / kStudents;
+    (void)sink;
+    std::printf("\nTimetable: %zu sections, openSections %.1f us (40 completed courses, 4 scheduled sections)\n",
+                timetable.size(), queryNs / 1e3);
+    std::filesystem::remove(path);
+}
+
+// Courses CS100000 up; the first `replaced` of them get new IDs (MA...) and every name
+// carries tag, so a reload from one variant to another rewrites every record.
+std::filesystem::path writeVariant(const char* name, std::size_t replaced, const char* tag) {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    for (std::size_t i = 0; i < kKeys; ++i) {
+        out << (i < replaced ? "MA" : "CS") << 100000 + i << ",Course number " << i << ' ' << tag << " title\n";
+    }
+    return path;
+}
+
+// Time and peak heap of one reload from base to next, over what the loaded base held.
+void measureReload(const char* label, const std::filesystem::path& base, const std::filesystem::path& next,
+                   ReloadMode mode) {
+    Catalog catalog;
+    LoadOptions options;
+    options.skipUnchanged = false;
+    catalog.load(base.string(), options);
+    CatalogReclaimer::instance().drain();
+    const std::size_t before = heapInUse.load();
+    heapPeak.store(before);
+
+    options.reloadMode = mode;
+    const auto started = std::chrono::steady_clock::now();
+    const LoadResult result = catalog.load(next.string(), options);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    CatalogReclaimer::instance().drain();
+    std::printf("%-22s %-8s %7.0f ms   peak %6.1f MB over %6.1f MB (%4.2fx)%s\n", label,
+                mode == ReloadMode::InPlace ? "in-place" : "rebuild", ms,
+                static_cast<double>(heapPeak.load() - before) / 1e6, static_cast<double>(before) / 1e6,
+                static_cast<double>(heapPeak.load()) / static_cast<double>(before), result.ok ? "" : "  FAILED");
+}
+
+void compareReloads() {
+    const std::filesystem::path base = writeVariant("catalog_reload_base.csv", 0, "old");
+    const std::filesystem::path renamed = writeVariant("catalog_reload_renamed.csv", 0, "new");
+    const std::filesystem::path half = writeVariant("catalog_reload_half.csv", kKeys / 2, "new");
+    const std::filesystem::path replaced = writeVariant("catalog_reload_replaced.csv", kKeys, "new");
+    std::printf("\nReloads of %zu courses (maxStagedFraction %.2f)\n", kKeys, LoadOptions().maxStagedFraction);
+    for (const ReloadMode mode : {ReloadMode::Rebuild, ReloadMode::InPlace}) {
+        measureReload("same IDs, new names", base, renamed, mode);
+        measureReload("half the IDs replaced", base, half, mode);
+        measureReload("every ID replaced", base, replaced, mode);
+    }
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    void* block = std::malloc(size + kHeaderBytes);
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    *static_cast<std::size_t*>(block) = size;
+    const std::size_t inUse = heapInUse.fetch_add(size) + size;
+    std::size_t peak = heapPeak.load();
+    while (inUse > peak && !heapPeak.compare_exchange_weak(peak, inUse)) {
+    }
+    return static_cast<char*>(block) + kHeaderBytes;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    char* block = static_cast<char*>(pointer) - kHeaderBytes;
+    heapInUse.fetch_sub(*reinterpret_cast<std::size_t*>(block));
+    std::free(block);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    operator delete(pointer);
+}
+
+int main(int argc, char** argv) {
+    compareMaps();
+
+    const std::string fileName = argc > 1 ? std::string(argv[1]) : writeSyntheticCatalog().string();
+    std::printf("Catalog %s\n", fileName.c_str());
+    measureCatalog<FlatHashIndex>("FlatHashIndex", fileName);
+    measureCatalog<HashIndex>("HashIndex", fileName);
+    measureCatalog<SortedIndex>("SortedIndex", fileName);
+    measureCourseGraph(fileName);
+    measureDiskCatalog(fileName);
+    measureTimetable(fileName);
+
+    compareReloads();
+    return 0;
+}
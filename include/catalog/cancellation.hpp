@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+/**
+ * Read-only view of a cancellation request plus an optional deadline. Long catalog
+ * operations poll it cooperatively; a default-constructed token never stops anything.
+ */
+class CancellationToken {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    CancellationToken() = default;
+
+    // Token that only expires at the deadline (for request timeouts with no cancel button).
+    static CancellationToken withDeadline(Clock::time_point deadline);
+    static CancellationToken withTimeout(Clock::duration timeout);
+
+    // Returns a copy of this token that additionally expires at the given deadline.
+    CancellationToken withEarlierDeadline(Clock::time_point deadline) const;
+
+    // True once the source was cancelled, the deadline has passed, or a linked parent stopped.
+    bool stopRequested() const;
+
+private:
+    friend class CancellationSource;
+
+    std::shared_ptr<const std::atomic<bool>> flag;
+    std::shared_ptr<const CancellationToken> parent;  // Set for tokens of a linked source.
+    Clock::time_point deadline = Clock::time_point::max();
+};
+
+// Owner side of a token: hand out token() to workers and call cancel() from the UI.
+class CancellationSource {
+public:
+    CancellationSource();
+    // A source whose tokens also stop when parent does, e.g. to add an internal stop
+    // condition to a caller's token.
+    explicit CancellationSource(const CancellationToken& parent);
+
+    CancellationToken token() const;
+    void cancel();
+    bool cancelled() const;
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag;
+    std::shared_ptr<const CancellationToken> parent;
+};
+
+/**
+ * Counts work items and only consults the token every `interval` items, so the check
+ * costs an increment and a compare per row. Once it reports a stop it keeps doing so.
+ */
+class CancellationCheckpoint {
+public:
+    static constexpr std::size_t kDefaultInterval = 1024;
+
+    explicit CancellationCheckpoint(const CancellationToken& token,
+                                    std::size_t interval = kDefaultInterval)
+        : token(token), interval(interval == 0 ? 1 : interval) {}
+
+    bool shouldStop() {
+        if (stopped) {
+            return true;
+        }
+        if (++count < interval) {
+            return false;
+        }
+        count = 0;
+        stopped = token.stopRequested();
+        return stopped;
+    }
+
+    bool wasStopped() const { return stopped; }
+
+private:
+    const CancellationToken& token;
+    std::size_t interval;
+    std::size_t count = 0;
+    bool stopped = false;
+};
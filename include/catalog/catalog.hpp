@@ -1,17 +1,21 @@
 #pragma once
 
+#include "catalog/cancellation.hpp"
+#include "catalog/catalog_index.hpp"
+#include "catalog/course.hpp"
+#include "catalog/id_scheme.hpp"
+#include "catalog/worker_pool.hpp"
+
 #include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iosfwd>
+#include <optional>
 #include <string>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
-// Represents a single course entry including the ID, title, and prerequisite IDs.
-struct Course {
-    std::string courseNumber;
-    std::string courseName;
-    std::vector<std::string> prerequisites;
-};
-
 // Collects the outcome from a catalog load attempt so callers can report results.
 struct LoadResult {
     bool ok = false;
@@ -19,16 +23,149 @@ struct LoadResult {
     std::vector<std::string> warnings;
     std::vector<std::string> missingPrerequisites;
     std::string path;
+    bool cancelled = false;  // Set when a cancellation token or deadline stopped the load.
+    bool unchanged = false;  // Set when the file matched the loaded generation and was not parsed again.
+};
+
+// How load() treats a catalog that is already in memory.
+enum class ReloadMode {
+    Rebuild,  // Parse into a fresh directory and swap it in; the old data survives a failed load.
+    InPlace   // Update the live directory in place so a reload never holds two full copies.
+};
+
+// Which parser load() uses.
+enum class InputFormat {
+    Auto,      // JSON Lines for .jsonl/.ndjson files, CSV for everything else.
+    Csv,
+    JsonLines  // One JSON object per line; keys are matched with ColumnMapping's header names.
+};
+
+// Whether the first non-empty CSV line names the columns.
+enum class HeaderMode {
+    Auto,     // Treat the first line as a header when it names a course ID column.
+    Present,  // Always treat the first line as a header.
+    Absent    // Never look for a header; use the fixed positions.
 };
 
-class Catalog {
+/**
+ * Where the loader finds the fields it needs. With a header row, columns are matched by
+ * name (case-insensitive) and every other column is skipped without being parsed; without
+ * one, the fixed positions below reproduce the original "ID, name, prerequisites..." layout.
+ * JSON Lines records use the same header names as object keys.
+ */
+struct ColumnMapping {
+    std::vector<std::string> idHeaders{"course id", "course_id", "courseid", "course number",
+                                       "course_number", "coursenumber", "course", "id"};
+    std::vector<std::string> nameHeaders{"course name", "course_name", "coursename", "course title",
+                                         "course_title", "title", "name"};
+    std::string prerequisiteHeaderPrefix = "prereq";  // Matches "Prereq 1", "Prerequisites", ...
+
+    std::size_t idColumn = 0;
+    std::size_t nameColumn = 1;
+    std::size_t firstPrerequisiteColumn = 2;  // This column and every later one hold prerequisites.
+
+    bool operator==(const ColumnMapping&) const = default;
+};
+
+// Optional knobs for load(); the defaults reproduce the original behaviour.
+struct LoadOptions {
+    ReloadMode reloadMode = ReloadMode::Rebuild;
+    // InPlace only: courses that are new to the catalog are staged in batches of at most this
+    // fraction of the live course count before they are merged in. Courses the file drops
+    // are erased before any are added, so the staged batch is the reload's main overhead.
+    double maxStagedFraction = 0.25;
+    InputFormat format = InputFormat::Auto;
+    HeaderMode header = HeaderMode::Auto;
+    ColumnMapping columns;
+    // How course and prerequisite IDs are validated and normalized for this catalog.
+    CourseIdScheme idScheme = kLettersDigitsIds;
+    // Polled about once per thousand rows; a cancelled Rebuild leaves the catalog untouched.
+    CancellationToken cancellation;
+    // Scheduling class for any parsing handed to the shared worker pool.
+    TaskPriority priority = TaskPriority::Interactive;
+    // Rebuild only: a catalog whose estimated footprint exceeds this many bytes is rejected
+    // and the loaded one is kept. Staged courses are counted while the file is parsed, so an
+    // oversized file stops being read within about a thousand rows of passing the budget
+    // rather than after it is fully staged. 0 means no limit.
+    std::size_t memoryBudget = 0;
+    // Reloading the file behind the current generation returns its earlier result without
+    // parsing when the file is byte-identical (see LoadResult::unchanged).
+    bool skipUnchanged = true;
+};
+
+/**
+ * Identifies the file and parse settings behind a catalog generation. Size and
+ * modification time vouch for the bytes on their own only once the file is older than a
+ * couple of seconds; otherwise the content hash is what decides.
+ */
+struct SourceFingerprint {
+    std::string path;  // Resolved, as in LoadResult::path.
+    std::uintmax_t size = 0;
+    std::filesystem::file_time_type modified;
+    bool modifiedSettled = false;  // The file had been untouched for a while when it was read.
+    std::uint64_t contentHash = 0;
+    // Options that change what the file parses to.
+    InputFormat format = InputFormat::Auto;
+    HeaderMode header = HeaderMode::Auto;
+    ColumnMapping columns;
+    CourseIdScheme idScheme = kLettersDigitsIds;
+    std::uint64_t generation = 0;  // Only valid while the catalog is still at this generation.
+    LoadResult result;
+};
+
+/**
+ * What one successful load, reload, or build changed. Added and changed courses are given
+ * as ascending indices into sortedIds() as it stands after the change, so a view can
+ * update exactly those rows; removed courses no longer have an index and are listed by ID.
+ */
+struct CatalogChangeSet {
+    std::uint64_t generation = 0;      // Catalog::generation() after the change.
+    std::vector<std::size_t> added;    // New courses.
+    std::vector<std::size_t> changed;  // Courses whose title or prerequisites differ.
+    std::vector<std::string> removed;  // Sorted IDs that are gone.
+
+    bool empty() const { return added.empty() && changed.empty() && removed.empty(); }
+};
+
+// Called after the new data is in place, on the thread that changed the catalog.
+using CatalogSubscriber = std::function<void(const CatalogChangeSet&)>;
+
+/**
+ * In-memory course catalog. Index picks how records are stored and looked up (see
+ * catalog_index.hpp); everything else—loading, the sorted ID list, generations, and
+ * change sets—is shared. Catalog is the default FlatHashIndex instantiation that every
+ * front end uses; BasicCatalog<SortedIndex> trades O(1) lookups for a smaller footprint,
+ * and BasicCatalog<HashIndex> is the std::unordered_map baseline. Policies are
+ * instantiated explicitly in catalog.cpp, so a new one is added there. The index is the
+ * only axis: IDs are std::string throughout and records keep their own copies.
+ */
+template <typename Index = FlatHashIndex>
+class BasicCatalog {
 public:
+    using IndexPolicy = Index;
+    using SubscriptionId = std::uint64_t;
+
     /**
      * Reads the CSV file, validates the data, and populates the in-memory catalog.
      * No output occurs here; the caller should surface the messages from the result.
      */
     LoadResult load(const std::string& fileName);
 
+    /**
+     * Same as load(fileName) with explicit options. With ReloadMode::InPlace the file is
+     * read twice: once to find the courses it drops, which are then erased, and once to
+     * update the live catalog row by row. Peak memory stays near one catalog, but a read
+     * error or cancellation in the second pass leaves the catalog partially updated.
+     */
+    LoadResult load(const std::string& fileName, const LoadOptions& options);
+
+    /**
+     * Populates the catalog from course records that were already parsed elsewhere
+     * (for example by a merge). IDs are expected to be normalized and validated.
+     * Duplicate IDs follow the same last-one-wins rule as load().
+     */
+    LoadResult build(std::vector<Course> courses, const std::string& sourceLabel);
+
     /**
      * Finds a course by ID (case-sensitive to match the normalized entries).
      * Returns nullptr when the course is not in the catalog.
@@ -41,7 +178,73 @@ public:
      */
     std::vector<std::string> ids() const;
 
+    /**
+     * Read-only view of the sorted course IDs for callers that walk the whole catalog
+     * (diffs, merges). The reference stays valid until the next successful load.
+     */
+    const std::vector<std::string>& sortedIds() const;
+
+    // Number of courses currently loaded.
+    std::size_t size() const;
+
+    /**
+     * Estimated heap bytes held by the catalog: the index structure, the sorted ID list,
+     * and every string and prerequisite list that outgrew its inline storage.
+     */
+    std::size_t memoryFootprint() const;
+
+    // Bumped by every successful load, reload, or build; 0 until the first one.
+    std::uint64_t generation() const;
+
+    /**
+     * Registers a callback that receives the change set of every later generation, so
+     * views and caches can invalidate just the affected courses. Change sets are only
+     * computed while at least one subscriber is registered. Subscriptions stay with this
+     * object: a copy or moved-to catalog starts with none.
+     */
+    SubscriptionId subscribe(CatalogSubscriber subscriber);
+
+    // Removes a subscription; unknown IDs are ignored. Safe to call from inside a callback.
+    void unsubscribe(SubscriptionId id);
+
 private:
-    std::unordered_map<std::string, Course> courseDirectory;
+    // Body of load(); the public overload wraps it in the load__start/load__done probes.
+    LoadResult loadFile(const std::string& fileName, const LoadOptions& options);
+    // The earlier result when path still holds the bytes behind the current generation.
+    std::optional<LoadResult> reuseUnchangedSource(const std::filesystem::path& path, std::uintmax_t size,
+                                                   std::filesystem::file_time_type modified,
+                                                   const LoadOptions& options);
+    // Shared tail of load()/build(): reports missing prerequisites, sorts IDs, swaps data in.
+    LoadResult commit(CourseMap loadedCourseDirectory, LoadResult result, std::size_t memoryBudget = 0,
+                      TaskPriority priority = TaskPriority::Interactive);
+    // Streams rows straight into the existing directory (ReloadMode::InPlace).
+    LoadResult reloadInPlace(std::istream& input, InputFormat format, const LoadOptions& options,
+                             LoadResult result);
+
+    // Stamps the next generation on changes and hands it to every subscriber.
+    void publishChanges(CatalogChangeSet changes);
+
+    // Subscriptions belong to the catalog object they were made on, so copying or moving a
+    // catalog carries its data but not its subscribers: the new catalog starts with none,
+    // and assignment leaves the target's own list as it was.
+    struct SubscriberList {
+        std::vector<std::pair<SubscriptionId, CatalogSubscriber>> entries;
+        SubscriptionId nextId = 1;
+
+        SubscriberList() = default;
+        SubscriberList(const SubscriberList&) {}
+        SubscriberList& operator=(const SubscriberList&) { return *this; }
+    };
+
+    Index courseDirectory;
     std::vector<std::string> sortedCourseIds;
+    std::uint64_t currentGeneration = 0;
+    std::optional<SourceFingerprint> loadedSource;
+    SubscriberList subscribers;
 };
+
+extern template class BasicCatalog<FlatHashIndex>;
+extern template class BasicCatalog<HashIndex>;
+extern template class BasicCatalog<SortedIndex>;
+
+using Catalog = BasicCatalog<>;
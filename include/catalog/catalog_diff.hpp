@@ -0,0 +1,43 @@
+#pragma once
+
+#include "catalog/catalog.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Classifies how a course moved between two catalog versions.
+enum class CourseChangeKind {
+    Added,
+    Removed,
+    Changed
+};
+
+// One row of a catalog diff, including the prerequisite-level breakdown.
+struct CourseDiffEntry {
+    CourseChangeKind kind = CourseChangeKind::Changed;
+    std::string courseNumber;
+    std::string beforeName;                          // Empty for added courses.
+    std::string afterName;                           // Empty for removed courses.
+    std::vector<std::string> addedPrerequisites;     // Present only in the newer catalog.
+    std::vector<std::string> removedPrerequisites;   // Present only in the older catalog.
+    std::vector<std::string> keptPrerequisites;      // Present in both versions.
+};
+
+// Full comparison between two catalogs, sorted by course ID.
+struct CatalogDiff {
+    std::vector<CourseDiffEntry> entries;
+    std::size_t added = 0;
+    std::size_t removed = 0;
+    std::size_t changed = 0;
+    std::size_t unchanged = 0;
+    bool cancelled = false;  // The entries only cover the IDs visited before the stop.
+};
+
+/**
+ * Compares two loaded catalogs with a single sorted-merge pass over their ID lists.
+ * Unchanged courses are counted but not stored so the result stays proportional to the change.
+ * The token is polled between chunks of courses so a cancelled comparison returns promptly.
+ */
+CatalogDiff diffCatalogs(const Catalog& before, const Catalog& after,
+                         const CancellationToken& cancellation = {});
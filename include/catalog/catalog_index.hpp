@@ -0,0 +1,129 @@
+#pragma once
+
+#include "catalog/course.hpp"
+#include "catalog/flat_hash_map.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Index policies for BasicCatalog. A policy owns the Course records and answers lookups by
+// ID; the catalog itself keeps the sorted ID list, change tracking, and generations.
+// Every policy provides:
+//
+//   static Index adopt(CourseMap&& staged, const std::vector<std::string>& sortedIds);
+//   const Course* find(const std::string& id) const;  Course* find(const std::string& id);
+//   std::size_t size() const;  bool empty() const;
+//   void reserve(std::size_t count);  // Room for count courses without growing again.
+//   void upsert(std::vector<Course>& batch, const ReplaceCallback& onReplace);
+//   void erase(const std::vector<std::string>& sortedIds);
+//   template <typename Visit> void forEach(Visit visit) const;  // visit(const Course&)
+//   std::size_t overheadBytes() const;  // The index structure itself, not the course strings.
+//
+// upsert() inserts or replaces the batch in order (later entries win) and reports every ID
+// that replaced an existing entry, earlier ones in the same batch included, in batch order.
+// erase() takes IDs that are all present, in ascending order.
+
+using ReplaceCallback = std::function<void(const std::string&)>;
+
+// Courses keyed by ID as the loader collects them, before a policy adopts them.
+using CourseMap = FlatHashMap<std::string, Course, StringHash>;
+
+// Heap bytes behind a string for memory footprints; short strings live inline and cost
+// nothing extra. Shared by the policies' overheadBytes() and the catalog's own estimate.
+inline std::size_t heapBytes(const std::string& text) {
+    static const std::size_t inlineCapacity = std::string().capacity();
+    return text.capacity() > inlineCapacity ? text.capacity() + 1 : 0;
+}
+
+/**
+ * Swiss-table map keyed by ID (flat_hash_map.hpp). Records sit inline in one array, so a
+ * lookup is one hash, one 16-byte control compare, and usually a single key compare, with
+ * no node pointers to chase. Adopting the loader's map is a move. The default.
+ */
+class FlatHashIndex {
+public:
+    static FlatHashIndex adopt(CourseMap&& staged, const std::vector<std::string>& sortedIds);
+
+    const Course* find(const std::string& id) const;
+    Course* find(const std::string& id);
+    std::size_t size() const { return courses.size(); }
+    bool empty() const { return courses.empty(); }
+
+    void reserve(std::size_t count) { courses.reserve(count); }
+    void upsert(std::vector<Course>& batch, const ReplaceCallback& onReplace);
+    void erase(const std::vector<std::string>& sortedIds);
+
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (const auto& entry : courses) {
+            visit(entry.second);
+        }
+    }
+
+    std::size_t overheadBytes() const;
+
+private:
+    CourseMap courses;
+};
+
+// std::unordered_map keyed by ID, with one heap node per course. Kept as the baseline the
+// flat policy is measured against.
+class HashIndex {
+public:
+    static HashIndex adopt(CourseMap&& staged, const std::vector<std::string>& sortedIds);
+
+    const Course* find(const std::string& id) const;
+    Course* find(const std::string& id);
+    std::size_t size() const { return courses.size(); }
+    bool empty() const { return courses.empty(); }
+
+    void reserve(std::size_t count) { courses.reserve(count); }
+    void upsert(std::vector<Course>& batch, const ReplaceCallback& onReplace);
+    void erase(const std::vector<std::string>& sortedIds);
+
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (const auto& entry : courses) {
+            visit(entry.second);
+        }
+    }
+
+    std::size_t overheadBytes() const;
+
+private:
+    std::unordered_map<std::string, Course> courses;
+};
+
+/**
+ * One array of records in ID order, searched by binary search. No per-course nodes or
+ * key copies, so it is the most compact policy and walks in ID order for free; lookups
+ * cost O(log n) string compares and in-place reloads merge each batch in O(n).
+ */
+class SortedIndex {
+public:
+    static SortedIndex adopt(CourseMap&& staged, const std::vector<std::string>& sortedIds);
+
+    const Course* find(const std::string& id) const;
+    Course* find(const std::string& id);
+    std::size_t size() const { return courses.size(); }
+    bool empty() const { return courses.empty(); }
+
+    void reserve(std::size_t count) { courses.reserve(count); }
+    void upsert(std::vector<Course>& batch, const ReplaceCallback& onReplace);
+    void erase(const std::vector<std::string>& sortedIds);
+
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (const auto& course : courses) {
+            visit(course);
+        }
+    }
+
+    std::size_t overheadBytes() const;
+
+private:
+    std::vector<Course> courses;  // Ascending courseNumber.
+};
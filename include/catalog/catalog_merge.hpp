@@ -0,0 +1,44 @@
+#pragma once
+
+#include "catalog/catalog.hpp"
+
+#include <string>
+#include <vector>
+
+// Decides which source supplies a course title when several sources define the course.
+enum class NamePrecedence {
+    HighestPriority,  // Always take the title from the highest-priority source.
+    FirstNonEmpty     // Walk down the priorities until a non-empty title turns up.
+};
+
+// Decides how prerequisite lists from several sources are combined.
+enum class PrerequisiteMerge {
+    Replace,             // The highest-priority source's list wins outright.
+    ReplaceUnlessEmpty,  // Like Replace, but an empty list defers to lower priorities.
+    Union                // Combine every source's list in priority order, without duplicates.
+};
+
+// One already-loaded catalog taking part in a merge.
+struct MergeSource {
+    const Catalog* catalog = nullptr;
+    std::string label;  // Shown in conflict warnings, e.g. "registrar" or "overrides".
+    int priority = 0;   // Higher wins; ties go to the source listed later, like load().
+};
+
+// Field-level rules applied to every course defined by more than one source.
+struct MergePolicy {
+    NamePrecedence namePrecedence = NamePrecedence::HighestPriority;
+    PrerequisiteMerge prerequisites = PrerequisiteMerge::Replace;
+    bool reportConflicts = true;  // Emit a warning whenever sources disagree on a field.
+};
+
+/**
+ * Combines already-loaded catalogs into target by policy without re-reading any file.
+ * The sources' sorted ID lists are merged in one linear pass; target may also be a source.
+ * The returned LoadResult mirrors load() so front ends can report it the same way.
+ * A cancelled merge leaves target untouched and sets LoadResult::cancelled.
+ */
+LoadResult mergeCatalogs(const std::vector<MergeSource>& sources,
+                         const MergePolicy& policy,
+                         Catalog& target,
+                         const CancellationToken& cancellation = {});
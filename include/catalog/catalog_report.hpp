@@ -0,0 +1,63 @@
+#pragma once
+
+#include "catalog/cancellation.hpp"
+#include "catalog/catalog.hpp"
+#include "catalog/course_graph.hpp"
+#include "catalog/worker_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+/**
+ * Transitive prerequisites of every course, as handles (positions in Catalog::sortedIds()).
+ * Courses in a prerequisite cycle share one closure that includes every course in the
+ * cycle, themselves included, and are flagged in `cyclic`.
+ */
+struct PrerequisiteClosures {
+    std::vector<std::uint32_t> componentOf;                // Handle -> closure index.
+    std::vector<std::vector<std::uint32_t>> closures;      // Sorted handles per closure index.
+    std::vector<bool> cyclic;                              // Per handle.
+    std::size_t levels = 0;                                // Depth of the prerequisite graph.
+    bool cancelled = false;
+
+    const std::vector<std::uint32_t>& of(std::size_t handle) const { return closures[componentOf[handle]]; }
+};
+
+/**
+ * Computes every closure level by level: cycles are collapsed first, then all courses
+ * whose prerequisites are already done are handled in parallel on the worker pool, each
+ * merging its direct prerequisites' closures. Missing prerequisites are left out.
+ */
+PrerequisiteClosures computePrerequisiteClosures(const Catalog& catalog,
+                                                 TaskPriority priority = TaskPriority::Batch,
+                                                 const CancellationToken& cancellation = {});
+
+// Same, over a graph already built for the catalog; only the graph's hot half is read.
+PrerequisiteClosures computePrerequisiteClosures(const CourseGraph& graph,
+                                                 TaskPriority priority = TaskPriority::Batch,
+                                                 const CancellationToken& cancellation = {});
+
+struct CatalogReportOptions {
+    TaskPriority priority = TaskPriority::Batch;
+    CancellationToken cancellation;
+    std::size_t coursesPerChunk = 256;  // Sections formatted by one task.
+};
+
+struct CatalogReportResult {
+    bool ok = false;              // False when the output stream failed or the run was cancelled.
+    bool cancelled = false;
+    std::size_t courses = 0;      // Sections written.
+    std::size_t cyclicCourses = 0;
+    std::size_t bytesWritten = 0;
+};
+
+/**
+ * Writes the catalog book: one plain-text section per course in ID order with its direct
+ * prerequisites and the full transitive list, each with titles. Sections are formatted in
+ * parallel chunks a window at a time and streamed out in order, so memory stays bounded
+ * by the window rather than the whole report.
+ */
+CatalogReportResult writeCatalogReport(const Catalog& catalog, std::ostream& out,
+                                       const CatalogReportOptions& options = {});
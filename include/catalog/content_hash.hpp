@@ -0,0 +1,31 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+/**
+ * Streaming 64-bit content hash (XXH64 with seed 0) used to recognize byte-identical
+ * input files. Bytes may be fed in any split; digest() does not disturb the state, so
+ * hashing can continue afterwards.
+ */
+class ContentHasher {
+public:
+    ContentHasher();
+
+    void update(const void* data, std::size_t size);
+    std::uint64_t digest() const;
+
+    // Total bytes fed so far.
+    std::uint64_t size() const { return totalBytes; }
+
+private:
+    std::array<std::uint64_t, 4> lanes;
+    std::array<unsigned char, 32> pending{};  // Bytes of a stripe that is not full yet.
+    std::size_t pendingBytes = 0;
+    std::uint64_t totalBytes = 0;
+};
+
+// Hashes a whole file with ContentHasher. Returns false when it cannot be read.
+bool hashFileContents(const std::filesystem::path& path, std::uint64_t& hash);
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Represents a single course entry including the ID, title, and prerequisite IDs.
+struct Course {
+    std::string courseNumber;
+    std::string courseName;
+    std::vector<std::string> prerequisites;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "catalog/catalog.hpp"
+#include "catalog/flat_hash_map.hpp"
+#include "catalog/worker_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <string_view>
+#include <vector>
+
+/**
+ * Prerequisite graph of one catalog generation, split into hot and cold halves. Courses are
+ * numbered by handle, their position in Catalog::sortedIds(). The hot half is one 8-byte
+ * record per course plus a single array of prerequisite handles, which is everything a
+ * traversal reads; titles and the original prerequisite IDs stay in the catalog's Course
+ * records (the cold half), reached through course(). A graph walk over 300k courses then
+ * streams a few megabytes instead of chasing a Course and its strings per edge.
+ *
+ * The graph points into the catalog and is valid only while the catalog stays at the
+ * generation it was built from; isCurrent() tells when to rebuild.
+ */
+class CourseGraph {
+public:
+    // Prerequisite slot of an ID that the catalog does not have.
+    static constexpr std::uint32_t kMissing = UINT32_MAX;
+
+    enum Flags : std::uint8_t {
+        kHasMissingPrerequisite = 1,  // At least one prerequisite slot is kMissing.
+        kSelfPrerequisite = 2,        // The course lists itself.
+    };
+
+    struct HotCourse {
+        std::uint32_t firstPrerequisite = 0;  // Into prerequisiteHandles().
+        std::uint32_t prerequisiteCount : 24 = 0;
+        std::uint32_t flags : 8 = 0;
+    };
+
+    explicit CourseGraph(std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * Rebuilds the graph for the catalog's current generation. Prerequisite handles are
+     * resolved in parallel slices on the shared pool; the calling thread does all the
+     * allocation, so the memory resource need not be thread-safe.
+     */
+    void build(const Catalog& catalog, TaskPriority priority = TaskPriority::Batch);
+
+    // True once build() has run for the catalog's current generation.
+    bool isCurrent(const Catalog& catalog) const;
+
+    std::size_t size() const { return hotCourses.size(); }
+
+    const HotCourse& hot(std::size_t handle) const { return hotCourses[handle]; }
+
+    // Handles of a course's prerequisites in the order the catalog lists them.
+    std::span<const std::uint32_t> prerequisites(std::size_t handle) const {
+        const HotCourse& record = hotCourses[handle];
+        return {prerequisiteHandles.data() + record.firstPrerequisite, record.prerequisiteCount};
+    }
+
+    // Cold data: the catalog's record, with the title and prerequisite IDs.
+    const Course& course(std::size_t handle) const { return *coldCourses[handle]; }
+
+    // Handle of a course ID, or kMissing.
+    std::uint32_t handleOf(std::string_view id) const;
+
+    // Heap bytes held by the graph itself (the cold records belong to the catalog).
+    std::size_t memoryFootprint() const;
+
+private:
+    std::pmr::vector<HotCourse> hotCourses;
+    std::pmr::vector<std::uint32_t> prerequisiteHandles;
+    std::pmr::vector<const Course*> coldCourses;
+    // Keys view the catalog's sortedIds(), which stay put until the generation changes.
+    FlatHashMap<std::string_view, std::uint32_t, StringHash, std::equal_to<>,
+                std::pmr::polymorphic_allocator<std::pair<std::string_view, std::uint32_t>>>
+        handles;
+    const Catalog* builtFrom = nullptr;
+    std::uint64_t builtGeneration = 0;
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "catalog/catalog.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Returns a view with spaces, tabs, and line endings removed from both ends.
+std::string_view trimView(std::string_view text);
+
+// Uppercases into a new string so IDs are normalized the same way on every path.
+std::string toUpperCopy(std::string_view text);
+
+// Drops a leading UTF-8 byte order mark, as written by many Windows exports.
+std::string_view stripUtf8Bom(std::string_view text);
+
+/**
+ * Checks a line for invalid UTF-8. Valid lines come back unchanged; otherwise each
+ * invalid byte is replaced with U+FFFD in scratch, a warning naming the first bad byte is
+ * recorded, and a view of scratch is returned so bad text never reaches the front ends.
+ */
+std::string_view repairUtf8Line(std::string_view line, std::size_t lineNumber, std::string& scratch,
+                                std::vector<std::string>& warnings);
+
+/**
+ * Makes sure a course ID starts with letters and ends with digits (think "CSCI200"),
+ * the default kLettersDigitsIds scheme. Anything that breaks that pattern is rejected.
+ */
+bool isCourseIdValid(std::string_view courseId);
+
+/**
+ * Validates and normalizes one course's raw fields into `course`, regardless of which
+ * file format they came from. Returns false (after recording a warning) when the row
+ * must be skipped; bad or duplicate prerequisites are dropped with a warning.
+ */
+bool buildCourseRecord(std::string_view rawId,
+                       std::string_view name,
+                       const std::vector<std::string_view>& rawPrerequisites,
+                       std::size_t lineNumber,
+                       const CourseIdScheme& idScheme,
+                       Course& course,
+                       std::vector<std::string>& warnings);
+
+// What the loader does with a CSV column; Skip columns are stepped over unparsed.
+enum class ColumnRole : unsigned char {
+    Skip,
+    Id,
+    Name,
+    Prerequisite
+};
+
+// Column roles for one file, resolved once from the header row or the fixed positions.
+struct CsvColumnLayout {
+    std::vector<ColumnRole> roles;       // Role of each column by index.
+    bool trailingPrerequisites = false;  // Columns past roles.size() hold prerequisites.
+    std::size_t lastNeededColumn = 0;    // Parsing stops here unless trailingPrerequisites.
+
+    ColumnRole roleFor(std::size_t column) const {
+        if (column < roles.size()) {
+            return roles[column];
+        }
+        return trailingPrerequisites ? ColumnRole::Prerequisite : ColumnRole::Skip;
+    }
+};
+
+// The original positional layout: ID, name, then prerequisites to the end of the line.
+CsvColumnLayout positionalLayout(const ColumnMapping& mapping);
+
+/**
+ * Builds a layout from a header line by matching column names against the mapping.
+ * Returns nullopt when no course ID column can be found; missing name columns are
+ * reported through warnings.
+ */
+std::optional<CsvColumnLayout> headerLayout(std::string_view headerLine,
+                                            const ColumnMapping& mapping,
+                                            std::vector<std::string>& warnings);
+
+/**
+ * Decides whether the first non-empty line is a header under HeaderMode::Auto:
+ * the ID position does not hold a valid course ID but some cell names an ID column.
+ */
+bool looksLikeHeader(std::string_view firstLine, const ColumnMapping& mapping, const CourseIdScheme& idScheme);
+
+/**
+ * Projected CSV row parser. Only the columns the layout needs are trimmed and copied;
+ * the rest are skipped with a delimiter scan. Quoted fields ("Smith, J.") are honoured.
+ * Keeps its scratch buffers between rows, so reuse one instance per load.
+ */
+class CsvRowParser {
+public:
+    CsvRowParser(CsvColumnLayout layout, const CourseIdScheme& idScheme);
+
+    bool parse(std::string_view line, std::size_t lineNumber, Course& course,
+               std::vector<std::string>& warnings);
+
+private:
+    CsvColumnLayout layout;
+    CourseIdScheme idScheme;
+    std::vector<std::string_view> prerequisiteCells;
+    std::string nameScratch;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * CRC-32C (Castagnoli) of size bytes, continuing from crc; pass 0 to start a new checksum,
+ * so crc32c(b, crc32c(a)) equals the checksum of a followed by b. Runs on the SSE4.2 crc32
+ * instruction when the CPU has it (checked once per process) and on a slicing-by-8 table
+ * otherwise; both give identical results.
+ */
+std::uint32_t crc32c(const void* data, std::size_t size, std::uint32_t crc = 0);
+
+// True when crc32c() uses the hardware instruction on this machine.
+bool crc32cHardwareAccelerated();
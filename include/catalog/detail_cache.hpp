@@ -0,0 +1,65 @@
+#pragma once
+
+#include "catalog/catalog.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Rendered course detail blocks keyed by output style and course ID. Blocks are built on
+ * first request for the current catalog generation and all dropped as soon as the catalog
+ * moves on, so a repeated lookup is one hash probe and one buffer write. Lookups take a
+ * shared lock and rendering runs outside any lock, so sessions can share one cache.
+ */
+class CourseDetailCache {
+public:
+    using StyleId = std::uint32_t;
+    // Turns one course into its finished text (prerequisite titles, escape codes, and all).
+    using Renderer = std::function<std::string(const Catalog&, const Course&)>;
+    using Block = std::shared_ptr<const std::pmr::string>;
+
+    static constexpr std::size_t kDefaultMaxEntries = 4096;
+
+    // Blocks and index are allocated from memory, so a tenant's cache counts against its quota.
+    explicit CourseDetailCache(const Catalog& catalog, std::size_t maxEntries = kDefaultMaxEntries,
+                               std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    // Registers an output style (one per theme and format); call before sharing the cache.
+    StyleId addStyle(Renderer render);
+
+    /**
+     * Rendered block for courseId in style, or nullptr when the catalog has no such course.
+     * Once maxEntries blocks are cached, further misses are rendered but not kept.
+     */
+    Block get(StyleId style, const std::string& courseId);
+
+    std::size_t size() const;
+    std::size_t hits() const;
+    std::size_t misses() const;
+
+private:
+    // Drops every block when the catalog generation no longer matches.
+    void revalidate();
+
+    using Key = std::pmr::string;  // Style ID bytes followed by the course ID.
+    Key keyFor(StyleId style, const std::string& courseId) const;
+
+    const Catalog& catalog;
+    const std::size_t maxEntries;
+    std::pmr::memory_resource* memory;
+    std::vector<Renderer> styles;
+
+    mutable std::shared_mutex mutex;
+    std::uint64_t cachedGeneration = 0;
+    std::pmr::unordered_map<Key, Block> blocks;
+    std::atomic<std::size_t> hitCount{0};
+    std::atomic<std::size_t> missCount{0};
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "catalog/catalog.hpp"
+#include "catalog/course.hpp"
+#include "catalog/flat_hash_map.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// On-disk B+tree of course records for catalogs too large to hold in memory.
+//
+// The file is a sequence of 4 KiB pages. Page 0 is the header:
+//   "CATBTRE1", u32 page size, u32 height, u64 course count, u32 root page, u32 page count,
+//   u32 CRC-32C of the fields before it
+// Every other page starts a node:
+//   u8 level (0 for leaves), 3 reserved bytes, u32 entry count, u32 span (pages),
+//   u32 entry offsets from the node start, the entries, and a CRC-32C of the node in its
+//   last 4 bytes
+// Leaf entries are course records in ID order (wire_format.hpp's putCourse). Interior
+// entries are a u32 child page plus the first ID under that child. A node that cannot fit
+// even one entry in a page spans as many whole pages as it needs.
+
+inline constexpr std::size_t kDiskCatalogPageSize = 4096;
+
+/**
+ * Writes a disk catalog from courses handed over in strictly ascending ID order. Nodes are
+ * appended as they fill, so memory stays at one node per tree level however large the
+ * catalog is.
+ */
+class DiskCatalogWriter {
+public:
+    bool open(const std::filesystem::path& path, std::string& error);
+
+    // Appends the next course. Fails when its ID does not sort after the previous one.
+    bool add(const Course& course, std::string& error);
+
+    // Writes the remaining nodes and the header; the file is complete only after this.
+    bool finish(std::string& error);
+
+    std::uint64_t courseCount() const { return courses; }
+    std::uint32_t pageCount() const { return nextPage; }
+
+private:
+    // The node being filled on one level of the tree.
+    struct PendingNode {
+        std::string entries;
+        std::vector<std::uint32_t> offsets;  // Into entries.
+        std::string firstKey;
+        std::uint64_t nodesWritten = 0;
+    };
+
+    // Adds an entry on level, writing that level's node first when the entry would not fit.
+    bool appendEntry(std::size_t level, std::string_view key, const std::string& entry, std::string& error);
+    // Writes level's pending node at the next free page and empties it.
+    bool writeNode(std::size_t level, std::uint32_t& page, std::string& error);
+    // Writes level's node and adds it to the level above.
+    bool flushNode(std::size_t level, std::string& error);
+
+    std::ofstream out;
+    std::vector<PendingNode> levels;  // levels[0] holds leaves.
+    std::string lastId;
+    std::string scratch;
+    std::uint64_t courses = 0;
+    std::uint32_t nextPage = 1;  // Page 0 is the header.
+};
+
+// Writes every course of catalog to path as a disk catalog.
+bool writeDiskCatalog(const Catalog& catalog, const std::filesystem::path& path, std::string& error);
+
+struct DiskCatalogCacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;       // Nodes read from the file.
+    std::uint64_t evictions = 0;
+    std::uint64_t bytesRead = 0;
+    std::size_t cachedBytes = 0;
+    std::size_t capacityBytes = 0;
+};
+
+/**
+ * Read-only view of a disk catalog. Nodes are read on demand through an LRU cache bounded
+ * by cacheBytes (the most recently read node always stays, even when it alone is larger),
+ * and each one is checked against its CRC-32C when it is read. A lookup touches one node
+ * per level; with the upper levels cached that is usually a single read. Methods may be
+ * called from several threads; file reads are serialized.
+ *
+ * Like SnapshotReader, failures come back as false or an empty result with a reason in
+ * error; a damaged node affects only the lookups and scans that reach it.
+ */
+class DiskCatalog {
+public:
+    static constexpr std::size_t kDefaultCacheBytes = 8 << 20;
+
+    bool open(const std::filesystem::path& path, std::string& error, std::size_t cacheBytes = kDefaultCacheBytes);
+
+    std::uint64_t size() const { return courseCount; }
+    std::uint32_t height() const { return treeHeight; }
+
+    // The course with this ID; nothing when it is absent, and then error is set if a node was damaged.
+    std::optional<Course> get(std::string_view courseId, std::string& error) const;
+
+    /**
+     * Calls visit for each course in ID order, starting at the first ID not below from,
+     * until visit returns false or the catalog ends. Returns false when a node is damaged.
+     */
+    bool scan(std::string_view from, const std::function<bool(const Course&)>& visit, std::string& error) const;
+
+    // Calls visit for every course whose ID starts with prefix, in ID order.
+    bool scanPrefix(std::string_view prefix, const std::function<void(const Course&)>& visit,
+                    std::string& error) const;
+
+    DiskCatalogCacheStats cacheStats() const;
+
+private:
+    using NodeBytes = std::shared_ptr<const std::string>;
+
+    struct CachedNode {
+        std::uint32_t page = 0;
+        NodeBytes bytes;
+    };
+
+    // The node starting at page, from the cache or the file. Null with error set when damaged.
+    NodeBytes loadNode(std::uint32_t page, std::string& error) const;
+    // Reads and checks one node; called with cacheMutex held.
+    NodeBytes readNode(std::uint32_t page, std::string& error) const;
+    // Visits the subtree at page; false once visit asked to stop or error was set.
+    bool scanNode(std::uint32_t page, std::uint32_t level, std::string_view from,
+                  const std::function<bool(const Course&)>& visit, std::string& error) const;
+
+    std::uint32_t rootPage = 0;
+    std::uint32_t treeHeight = 0;
+    std::uint32_t totalPages = 0;
+    std::uint64_t courseCount = 0;
+    std::size_t cacheCapacity = kDefaultCacheBytes;
+
+    mutable std::mutex cacheMutex;
+    mutable std::ifstream file;
+    mutable std::list<CachedNode> recentNodes;  // Most recently used first.
+    mutable FlatHashMap<std::uint32_t, std::list<CachedNode>::iterator> cachedNodes;
+    mutable DiskCatalogCacheStats stats;
+};
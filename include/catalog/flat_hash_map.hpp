@@ -0,0 +1,539 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CATALOG_FLAT_MAP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Hashes std::string and std::string_view alike, so string-keyed maps can be probed with a
+// view and no temporary string.
+struct StringHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view text) const noexcept { return std::hash<std::string_view>{}(text); }
+};
+
+/**
+ * Open-addressing hash map in the Swiss-table layout. Every slot has one control byte
+ * (empty, deleted, or the low 7 bits of its key's hash) and the entries sit inline in one
+ * array. A lookup hashes once, compares those 7 bits against 16 control bytes at a time
+ * (one SSE2 compare where available), and only compares keys in slots whose bits match.
+ * A hit usually costs one group load and one key compare; a miss usually none.
+ *
+ * Unlike std::unordered_map, an insert that grows the table (and reserve()) moves every
+ * entry, invalidating iterators, pointers, and references. Entries are
+ * std::pair<Key, Value>, and their keys must not be modified in place. Erasing leaves a
+ * tombstone. When tombstones fill the table and entries hold at most 25/32 of the slots,
+ * the next insert clears them in place, moving entries within the same slot array and
+ * allocating nothing; otherwise the table doubles, which clears them too.
+ * Lookups are transparent: find("CS101"sv) works whenever Hash and KeyEqual accept the
+ * argument.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<>,
+          typename Allocator = std::allocator<std::pair<Key, Value>>>
+class FlatHashMap {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+
+    template <bool Const>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = FlatHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+
+        Iterator() = default;
+        // iterator converts to const_iterator.
+        template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+        Iterator(const Iterator<OtherConst>& other) : control(other.control), slot(other.slot), end(other.end) {}
+
+        reference operator*() const { return *slot; }
+        pointer operator->() const { return slot; }
+
+        Iterator& operator++() {
+            ++control;
+            ++slot;
+            skipFree();
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        friend bool operator==(const Iterator& left, const Iterator& right) { return left.control == right.control; }
+
+    private:
+        friend class FlatHashMap;
+        template <bool>
+        friend class Iterator;
+
+        Iterator(const std::int8_t* controlByte, pointer entry, const std::int8_t* controlEnd)
+            : control(controlByte), slot(entry), end(controlEnd) {}
+
+        void skipFree() {
+            while (control != end && !isFull(*control)) {
+                ++control;
+                ++slot;
+            }
+        }
+
+        const std::int8_t* control = nullptr;
+        pointer slot = nullptr;
+        const std::int8_t* end = nullptr;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatHashMap() = default;
+    explicit FlatHashMap(const Allocator& allocator) : slotAllocator(allocator) {}
+
+    FlatHashMap(const FlatHashMap& other)
+        : hashFunction(other.hashFunction),
+          keysEqual(other.keysEqual),
+          slotAllocator(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.slotAllocator)) {
+        copyFrom(other);
+    }
+
+    FlatHashMap(FlatHashMap&& other) noexcept
+        : hashFunction(std::move(other.hashFunction)),
+          keysEqual(std::move(other.keysEqual)),
+          slotAllocator(std::move(other.slotAllocator)) {
+        stealFrom(other);
+    }
+
+    FlatHashMap& operator=(const FlatHashMap& other) {
+        if (this != &other) {
+            clear();
+            hashFunction = other.hashFunction;
+            keysEqual = other.keysEqual;
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    FlatHashMap& operator=(FlatHashMap&& other) noexcept(
+        std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+        std::allocator_traits<Allocator>::is_always_equal::value) {
+        if (this == &other) {
+            return *this;
+        }
+        release();
+        hashFunction = std::move(other.hashFunction);
+        keysEqual = std::move(other.keysEqual);
+        if constexpr (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) {
+            slotAllocator = std::move(other.slotAllocator);
+        } else if (!std::allocator_traits<Allocator>::is_always_equal::value &&
+                   slotAllocator != other.slotAllocator) {
+            // Memory from another resource cannot be adopted; move the entries one by one.
+            reserve(other.size());
+            for (auto& entry : other) {
+                insertUnique(hashOf(entry.first), std::move(entry));
+            }
+            other.clear();
+            return *this;
+        }
+        stealFrom(other);
+        return *this;
+    }
+
+    ~FlatHashMap() { release(); }
+
+    iterator begin() {
+        iterator first(control, slots, control + slotCount);
+        first.skipFree();
+        return first;
+    }
+    iterator end() { return iterator(control + slotCount, slots + slotCount, control + slotCount); }
+    const_iterator begin() const {
+        const_iterator first(control, slots, control + slotCount);
+        first.skipFree();
+        return first;
+    }
+    const_iterator end() const {
+        return const_iterator(control + slotCount, slots + slotCount, control + slotCount);
+    }
+
+    size_type size() const { return entryCount; }
+    bool empty() const { return entryCount == 0; }
+    // Number of slots; every one costs sizeof(value_type) + 1 bytes whether used or not.
+    size_type capacity() const { return slotCount; }
+    allocator_type get_allocator() const { return slotAllocator; }
+
+    template <typename K>
+    iterator find(const K& key) {
+        const size_type index = findIndex(key, hashOf(key));
+        return index == kNotFound ? end() : iteratorAt(index);
+    }
+
+    template <typename K>
+    const_iterator find(const K& key) const {
+        const size_type index = findIndex(key, hashOf(key));
+        return index == kNotFound ? end() : const_iterator(control + index, slots + index, control + slotCount);
+    }
+
+    template <typename K>
+    bool contains(const K& key) const {
+        return findIndex(key, hashOf(key)) != kNotFound;
+    }
+
+    // Inserts Value(args...) under key unless the key is present; never touches an existing value.
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        const std::uint64_t hash = hashOf(key);
+        if (const size_type index = findIndex(key, hash); index != kNotFound) {
+            return {iteratorAt(index), false};
+        }
+        const size_type index = insertUnique(hash, std::piecewise_construct,
+                                             std::forward_as_tuple(std::forward<K>(key)),
+                                             std::forward_as_tuple(std::forward<Args>(args)...));
+        return {iteratorAt(index), true};
+    }
+
+    template <typename K>
+    Value& operator[](K&& key) {
+        return try_emplace(std::forward<K>(key)).first->second;
+    }
+
+    template <typename K>
+    size_type erase(const K& key) {
+        const size_type index = findIndex(key, hashOf(key));
+        if (index == kNotFound) {
+            return 0;
+        }
+        eraseAt(index);
+        return 1;
+    }
+
+    void erase(const_iterator position) { eraseAt(static_cast<size_type>(position.control - control)); }
+    void erase(iterator position) { erase(const_iterator(position)); }
+
+    // Makes room for count entries in total without growing again.
+    void reserve(size_type count) {
+        const size_type needed = capacityFor(count);
+        if (needed > slotCount) {
+            resize(needed);
+        }
+    }
+
+    // Destroys every entry but keeps the slots for reuse.
+    void clear() {
+        destroyEntries();
+        if (slotCount != 0) {
+            std::memset(control, kEmpty, slotCount + kGroupWidth);
+        }
+        entryCount = 0;
+        growthLeft = maxLoad(slotCount);
+    }
+
+private:
+    using SlotTraits = std::allocator_traits<Allocator>;
+    using ControlAllocator = typename SlotTraits::template rebind_alloc<std::int8_t>;
+    using ControlTraits = std::allocator_traits<ControlAllocator>;
+
+    static constexpr size_type kGroupWidth = 16;
+    static constexpr size_type kMinCapacity = 16;
+    static constexpr size_type kNotFound = static_cast<size_type>(-1);
+    static constexpr std::int8_t kEmpty = -128;  // 0b10000000
+    static constexpr std::int8_t kDeleted = -2;  // 0b11111110
+
+    static bool isFull(std::int8_t byte) { return byte >= 0; }
+
+    // Sixteen control bytes; each mask has bit i set for the matching byte i.
+    class Group {
+    public:
+        explicit Group(const std::int8_t* bytes) {
+#ifdef CATALOG_FLAT_MAP_SSE2
+            block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+#else
+            std::memcpy(block, bytes, kGroupWidth);
+#endif
+        }
+
+        unsigned match(std::int8_t tag) const {
+#ifdef CATALOG_FLAT_MAP_SSE2
+            return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(tag))));
+#else
+            unsigned mask = 0;
+            for (size_type i = 0; i < kGroupWidth; ++i) {
+                mask |= static_cast<unsigned>(block[i] == tag) << i;
+            }
+            return mask;
+#endif
+        }
+
+        unsigned matchEmpty() const { return match(kEmpty); }
+
+        // Empty and deleted bytes are the only negative ones below -1.
+        unsigned matchFree() const {
+#ifdef CATALOG_FLAT_MAP_SSE2
+            return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), block)));
+#else
+            unsigned mask = 0;
+            for (size_type i = 0; i < kGroupWidth; ++i) {
+                mask |= static_cast<unsigned>(block[i] < -1) << i;
+            }
+            return mask;
+#endif
+        }
+
+    private:
+#ifdef CATALOG_FLAT_MAP_SSE2
+        __m128i block;
+#else
+        std::int8_t block[kGroupWidth];
+#endif
+    };
+
+    // Visits groups at triangular offsets, which reaches every group of a power-of-two table.
+    struct Probe {
+        Probe(std::uint64_t hash, size_type mask)
+            : offset(static_cast<size_type>(hash >> 7) & mask), mask(mask) {}
+
+        void next() {
+            stride += kGroupWidth;
+            offset = (offset + stride) & mask;
+        }
+
+        size_type offset;
+        size_type mask;
+        size_type stride = 0;
+    };
+
+    // The low 7 bits tag the slot; the rest pick where probing starts.
+    template <typename K>
+    std::uint64_t hashOf(const K& key) const {
+        const auto raw = static_cast<std::uint64_t>(hashFunction(key));
+        return (raw ^ (raw >> 32)) * 0x9E3779B97F4A7C15ULL;
+    }
+
+    static std::int8_t tagOf(std::uint64_t hash) { return static_cast<std::int8_t>(hash & 0x7F); }
+
+    static size_type maxLoad(size_type capacity) { return capacity - capacity / 8; }
+
+    static size_type capacityFor(size_type count) {
+        size_type capacity = kMinCapacity;
+        while (maxLoad(capacity) < count) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    iterator iteratorAt(size_type index) { return iterator(control + index, slots + index, control + slotCount); }
+
+    template <typename K>
+    size_type findIndex(const K& key, std::uint64_t hash) const {
+        if (slotCount == 0) {
+            return kNotFound;
+        }
+        const std::int8_t tag = tagOf(hash);
+        for (Probe probe(hash, slotCount - 1);; probe.next()) {
+            const Group group(control + probe.offset);
+            for (unsigned bits = group.match(tag); bits != 0; bits &= bits - 1) {
+                const size_type index = (probe.offset + static_cast<size_type>(std::countr_zero(bits))) & (slotCount - 1);
+                if (keysEqual(slots[index].first, key)) {
+                    return index;
+                }
+            }
+            if (group.matchEmpty() != 0) {
+                return kNotFound;
+            }
+        }
+    }
+
+    // First empty or deleted slot on the key's probe path.
+    size_type findFreeSlot(std::uint64_t hash) const {
+        for (Probe probe(hash, slotCount - 1);; probe.next()) {
+            if (const unsigned bits = Group(control + probe.offset).matchFree(); bits != 0) {
+                return (probe.offset + static_cast<size_type>(std::countr_zero(bits))) & (slotCount - 1);
+            }
+        }
+    }
+
+    // Bytes 0..14 are mirrored after the table so a group load never has to wrap around.
+    void setControl(size_type index, std::int8_t value) {
+        control[index] = value;
+        control[((index - (kGroupWidth - 1)) & (slotCount - 1)) + (kGroupWidth - 1)] = value;
+    }
+
+    // Places an entry whose key is known to be absent; returns its slot.
+    template <typename... Args>
+    size_type insertUnique(std::uint64_t hash, Args&&... args) {
+        if (growthLeft == 0) {
+            // Room left once tombstones are gone: clear them without a second table. The
+            // 25/32 bound keeps at least 3/32 of the slots free afterwards, so in-place
+            // rehashes stay amortized under steady churn. Otherwise double.
+            if (slotCount == 0) {
+                resize(kMinCapacity);
+            } else if (entryCount <= slotCount / 32 * 25) {
+                dropTombstones();
+            } else {
+                resize(slotCount * 2);
+            }
+        }
+        const size_type index = findFreeSlot(hash);
+        SlotTraits::construct(slotAllocator, slots + index, std::forward<Args>(args)...);
+        if (control[index] == kEmpty) {
+            --growthLeft;
+        }
+        setControl(index, tagOf(hash));
+        ++entryCount;
+        return index;
+    }
+
+    void eraseAt(size_type index) {
+        SlotTraits::destroy(slotAllocator, slots + index);
+        --entryCount;
+        // When the empty bytes around the slot show no probe ever found a full group
+        // here, the slot can go straight back to empty instead of becoming a tombstone.
+        const size_type before = (index - kGroupWidth) & (slotCount - 1);
+        const unsigned emptyAfter = Group(control + index).matchEmpty();
+        const unsigned emptyBefore = Group(control + before).matchEmpty();
+        const bool neverFull = emptyAfter != 0 && emptyBefore != 0 &&
+                               std::countr_zero(emptyAfter) + std::countl_zero(static_cast<std::uint16_t>(emptyBefore)) <
+                                   static_cast<int>(kGroupWidth);
+        setControl(index, neverFull ? kEmpty : kDeleted);
+        if (neverFull) {
+            ++growthLeft;
+        }
+    }
+
+    void resize(size_type newCapacity) {
+        std::int8_t* oldControl = control;
+        value_type* oldSlots = slots;
+        const size_type oldCapacity = slotCount;
+
+        ControlAllocator controlAllocator(slotAllocator);
+        control = ControlTraits::allocate(controlAllocator, newCapacity + kGroupWidth);
+        slots = SlotTraits::allocate(slotAllocator, newCapacity);
+        std::memset(control, kEmpty, newCapacity + kGroupWidth);
+        slotCount = newCapacity;
+        growthLeft = maxLoad(newCapacity) - entryCount;
+
+        for (size_type i = 0; i < oldCapacity; ++i) {
+            if (!isFull(oldControl[i])) {
+                continue;
+            }
+            const std::uint64_t hash = hashOf(oldSlots[i].first);
+            const size_type index = findFreeSlot(hash);
+            SlotTraits::construct(slotAllocator, slots + index, std::move(oldSlots[i]));
+            SlotTraits::destroy(slotAllocator, oldSlots + i);
+            setControl(index, tagOf(hash));
+        }
+        if (oldCapacity != 0) {
+            ControlTraits::deallocate(controlAllocator, oldControl, oldCapacity + kGroupWidth);
+            SlotTraits::deallocate(slotAllocator, oldSlots, oldCapacity);
+        }
+    }
+
+    // Rehashes in place so every tombstone becomes empty again, with no second allocation.
+    // Full slots are first marked deleted and tombstones empty; each marked entry then moves
+    // to the first free slot on its probe path, swapping with a marked entry still waiting
+    // there, or stays put when that slot is in the group it already occupies.
+    void dropTombstones() {
+        for (size_type i = 0; i < slotCount; ++i) {
+            control[i] = isFull(control[i]) ? kDeleted : kEmpty;
+        }
+        std::memcpy(control + slotCount, control, kGroupWidth - 1);
+
+        const size_type mask = slotCount - 1;
+        for (size_type i = 0; i < slotCount; ++i) {
+            if (control[i] != kDeleted) {
+                continue;
+            }
+            const std::uint64_t hash = hashOf(slots[i].first);
+            const size_type start = Probe(hash, mask).offset;
+            const size_type target = findFreeSlot(hash);
+            // Slots the same number of groups into the probe path are equally good.
+            const auto probeGroup = [start, mask](size_type index) { return ((index - start) & mask) / kGroupWidth; };
+            if (probeGroup(target) == probeGroup(i)) {
+                setControl(i, tagOf(hash));
+                continue;
+            }
+            if (control[target] == kEmpty) {
+                SlotTraits::construct(slotAllocator, slots + target, std::move(slots[i]));
+                SlotTraits::destroy(slotAllocator, slots + i);
+                setControl(target, tagOf(hash));
+                setControl(i, kEmpty);
+                continue;
+            }
+            // The target holds an entry not placed yet: swap, then place the one now at i.
+            using std::swap;
+            swap(slots[i], slots[target]);
+            setControl(target, tagOf(hash));
+            --i;
+        }
+        growthLeft = maxLoad(slotCount) - entryCount;
+    }
+
+    void copyFrom(const FlatHashMap& other) {
+        reserve(other.size());
+        for (const auto& entry : other) {
+            insertUnique(hashOf(entry.first), entry);
+        }
+    }
+
+    void stealFrom(FlatHashMap& other) {
+        control = std::exchange(other.control, nullptr);
+        slots = std::exchange(other.slots, nullptr);
+        slotCount = std::exchange(other.slotCount, 0);
+        entryCount = std::exchange(other.entryCount, 0);
+        growthLeft = std::exchange(other.growthLeft, 0);
+    }
+
+    void destroyEntries() {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_type i = 0; i < slotCount && entryCount != 0; ++i) {
+                if (isFull(control[i])) {
+                    SlotTraits::destroy(slotAllocator, slots + i);
+                }
+            }
+        }
+    }
+
+    void release() {
+        if (slotCount == 0) {
+            return;
+        }
+        destroyEntries();
+        ControlAllocator controlAllocator(slotAllocator);
+        ControlTraits::deallocate(controlAllocator, control, slotCount + kGroupWidth);
+        SlotTraits::deallocate(slotAllocator, slots, slotCount);
+        control = nullptr;
+        slots = nullptr;
+        slotCount = 0;
+        entryCount = 0;
+        growthLeft = 0;
+    }
+
+    std::int8_t* control = nullptr;  // slotCount + kGroupWidth bytes.
+    value_type* slots = nullptr;
+    size_type slotCount = 0;         // 0 or a power of two, at least kMinCapacity.
+    size_type entryCount = 0;
+    size_type growthLeft = 0;        // Empty slots that may still be filled before growing.
+    [[no_unique_address]] Hash hashFunction;
+    [[no_unique_address]] KeyEqual keysEqual;
+    [[no_unique_address]] Allocator slotAllocator;
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Course ID schemes, described declaratively as a sequence of segments and compiled into
+// one specialized normalizer per scheme. The loader picks a scheme once per catalog
+// (LoadOptions::idScheme) and then calls its normalizer directly for every ID, so there
+// is no pattern interpretation in the hot loop.
+//
+//   using DashedIds = CourseIdSpec<IdLetters<1>, IdSeparator<'-'>, IdDigits<1>>;  // "CS-101"
+//
+// Segments match greedily from left to right and must consume the whole (trimmed) ID.
+// Letters are uppercased; separators are written out as their canonical character.
+
+constexpr std::size_t kUnboundedIdSegment = static_cast<std::size_t>(-1);
+
+// Output sink that only counts, so a spec can be checked in constant expressions.
+struct IdMatchOnly {
+    constexpr void push_back(char) {}
+};
+
+constexpr bool isIdLetter(char ch) {
+    return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z');
+}
+
+constexpr bool isIdDigit(char ch) {
+    return ch >= '0' && ch <= '9';
+}
+
+// Between Min and Max ASCII letters, uppercased.
+template <std::size_t Min, std::size_t Max = kUnboundedIdSegment>
+struct IdLetters {
+    template <typename Out>
+    static constexpr bool match(std::string_view raw, std::size_t& pos, Out& out) {
+        std::size_t count = 0;
+        while (pos < raw.size() && count < Max && isIdLetter(raw[pos])) {
+            const char ch = raw[pos++];
+            out.push_back(ch >= 'a' ? static_cast<char>(ch - 'a' + 'A') : ch);
+            ++count;
+        }
+        return count >= Min;
+    }
+};
+
+// Between Min and Max ASCII digits.
+template <std::size_t Min, std::size_t Max = kUnboundedIdSegment>
+struct IdDigits {
+    template <typename Out>
+    static constexpr bool match(std::string_view raw, std::size_t& pos, Out& out) {
+        std::size_t count = 0;
+        while (pos < raw.size() && count < Max && isIdDigit(raw[pos])) {
+            out.push_back(raw[pos++]);
+            ++count;
+        }
+        return count >= Min;
+    }
+};
+
+/**
+ * One separator character: Canonical or any of Also. It is written out as Canonical, so
+ * "CS 101" and "CS-101" normalize alike. When Optional, a missing separator is accepted
+ * and the canonical one is still inserted.
+ */
+template <char Canonical, bool Optional = false, char... Also>
+struct IdSeparator {
+    template <typename Out>
+    static constexpr bool match(std::string_view raw, std::size_t& pos, Out& out) {
+        if (pos < raw.size() && (raw[pos] == Canonical || ((raw[pos] == Also) || ...))) {
+            ++pos;
+            out.push_back(Canonical);
+            return true;
+        }
+        if (Optional) {
+            out.push_back(Canonical);
+        }
+        return Optional;
+    }
+};
+
+template <typename... Segments>
+struct CourseIdSpec {
+    // Normalizes raw into out; false when raw does not follow the scheme.
+    static bool normalize(std::string_view raw, std::string& out) {
+        out.clear();
+        out.reserve(raw.size() + sizeof...(Segments));  // An optional separator may add a character.
+        std::size_t pos = 0;
+        return (Segments::match(raw, pos, out) && ...) && pos == raw.size();
+    }
+
+    static constexpr bool matches(std::string_view raw) {
+        IdMatchOnly sink;
+        std::size_t pos = 0;
+        return (Segments::match(raw, pos, sink) && ...) && pos == raw.size();
+    }
+};
+
+// A compiled scheme as the loader sees it: just the specialized normalizer and a label.
+struct CourseIdScheme {
+    const char* name;
+    const char* example;
+    bool (*normalize)(std::string_view raw, std::string& out);
+};
+
+template <typename Spec>
+constexpr CourseIdScheme makeCourseIdScheme(const char* name, const char* example) {
+    return CourseIdScheme{name, example, &Spec::normalize};
+}
+
+// Built-in schemes.
+using LettersDigitsIdSpec = CourseIdSpec<IdLetters<1>, IdDigits<1>>;                               // CSCI200
+using DashedIdSpec = CourseIdSpec<IdLetters<1>, IdSeparator<'-', false, ' '>, IdDigits<1>>;         // CS-101
+using SpacedSuffixIdSpec = CourseIdSpec<IdLetters<1>, IdSeparator<' ', true, '-'>, IdDigits<1>,
+                                        IdLetters<0, 2>>;                                            // CSCI 3300L
+using NumericFirstIdSpec = CourseIdSpec<IdDigits<1>, IdSeparator<'-', false, ' ', '.'>, IdDigits<1>>; // 15-213
+
+inline constexpr CourseIdScheme kLettersDigitsIds = makeCourseIdScheme<LettersDigitsIdSpec>("letters-digits", "CSCI200");
+inline constexpr CourseIdScheme kDashedIds = makeCourseIdScheme<DashedIdSpec>("dashed", "CS-101");
+inline constexpr CourseIdScheme kSpacedSuffixIds = makeCourseIdScheme<SpacedSuffixIdSpec>("spaced-suffix", "CSCI 3300L");
+inline constexpr CourseIdScheme kNumericFirstIds = makeCourseIdScheme<NumericFirstIdSpec>("numeric-first", "15-213");
+
+// Looks a built-in scheme up by name (case-sensitive); nullptr when there is none.
+const CourseIdScheme* findCourseIdScheme(std::string_view name);
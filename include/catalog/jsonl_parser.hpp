@@ -0,0 +1,61 @@
+#pragma once
+
+#include "catalog/catalog.hpp"
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * On-demand parser for one JSON Lines record. Keys are matched against the same
+ * ColumnMapping header names the CSV loader uses ("id", "title", "prerequisites", ...);
+ * values of other keys are skipped structurally without being decoded. Every key with
+ * the prerequisite prefix contributes, in key order, so a record yields the same list as
+ * the equivalent CSV columns.
+ * Keeps its scratch buffers between lines, so reuse one instance per thread.
+ */
+class JsonLineParser {
+public:
+    JsonLineParser(const ColumnMapping& mapping, const CourseIdScheme& idScheme);
+
+    // Returns false (after recording a warning) when the line cannot produce a course.
+    bool parse(std::string_view line, std::size_t lineNumber, Course& course,
+               std::vector<std::string>& warnings);
+
+private:
+    enum class Field : unsigned char { Skip, Id, Name, Prerequisites };
+
+    Field classifyKey(std::string_view key, std::size_t position);
+
+    const ColumnMapping& mapping;
+    CourseIdScheme idScheme;
+    std::vector<std::pair<std::string, Field>> keyCache;  // Key seen at each position last time.
+    std::string idScratch;
+    std::string nameScratch;
+    std::deque<std::string> prerequisiteScratch;  // Deque keeps views stable while it grows.
+    std::vector<std::string_view> prerequisites;
+};
+
+/**
+ * Parses a whole JSON Lines buffer. Large buffers are split into line-aligned chunks
+ * parsed on the shared worker pool at the given priority; row warnings keep their line
+ * numbers and courses reach sink in file order, so duplicate IDs resolve exactly as they
+ * would in a serial parse. Returns the number of lines read; `cancelled` is set when the
+ * token stopped the parse.
+ *
+ * parsed, when set, sees every course as soon as it is read, before it waits for its turn
+ * at sink. It runs on the parsing threads, several at once for large buffers, so it must
+ * be thread-safe; the loader uses it to track staged memory and stop through the token.
+ */
+std::size_t readJsonLines(std::string_view contents,
+                          const ColumnMapping& mapping,
+                          const CourseIdScheme& idScheme,
+                          const CancellationToken& cancellation,
+                          TaskPriority priority,
+                          std::vector<std::string>& warnings,
+                          const std::function<void(Course&)>& sink,
+                          bool& cancelled,
+                          const std::function<void(const Course&)>& parsed = {});
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "catalog/catalog.hpp"
+#include "catalog/course_graph.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Compact binary query protocol for high-volume clients (batch audits and exports).
+//
+// Every message is a frame: a u32 little-endian payload length, then the payload.
+//   request payload:  u8 opcode, u32 request ID, body
+//   response payload: u8 status, u32 request ID (echoed), body
+// Responses are written in request order, so clients may pipeline any number of requests.
+// Counts and lengths inside bodies are LEB128 varints; strings are varint-length prefixed.
+//
+// Course handles are positions in Catalog::sortedIds() and are valid only for the
+// generation that issued them; Get rejects handles from an older generation.
+//
+//   Info     body: (none)
+//            reply: u64 generation, varint course count
+//   Resolve  body: varint n, n normalized course IDs
+//            reply: u64 generation, varint n, n x varint (handle + 1, or 0 when unknown)
+//   Get      body: u64 generation, varint n, n x varint handle
+//            reply: u64 generation, then per handle: u8 found, and when found the ID, the
+//                   title, varint prerequisite count, and per prerequisite varint
+//                   (handle + 1) or 0 followed by the ID when it is missing from the catalog
+//   StaleGeneration replies carry the current u64 generation instead.
+
+enum class QueryOpcode : std::uint8_t {
+    Info = 1,
+    Resolve = 2,
+    Get = 3
+};
+
+enum class QueryStatus : std::uint8_t {
+    Ok = 0,
+    BadRequest = 1,       // Malformed or oversized frame.
+    StaleGeneration = 2,  // Handles were issued for a different catalog generation.
+    UnknownOpcode = 3
+};
+
+// Frames larger than this are rejected and end the session.
+constexpr std::uint32_t kMaxQueryFrameBytes = 16u << 20;
+
+// Request builders for clients; each returns one complete frame.
+std::string encodeInfoRequest(std::uint32_t requestId);
+std::string encodeResolveRequest(std::uint32_t requestId, const std::vector<std::string>& courseIds);
+std::string encodeGetRequest(std::uint32_t requestId, std::uint64_t generation,
+                             const std::vector<std::uint32_t>& handles);
+
+// Response payload split into its fixed header and the opcode-specific body.
+struct QueryResponse {
+    QueryStatus status = QueryStatus::BadRequest;
+    std::uint32_t requestId = 0;
+    std::string_view body;
+};
+
+/**
+ * Takes the next complete frame off the front of buffer and parses its response header.
+ * Returns false (leaving buffer alone) when the frame has not fully arrived yet.
+ */
+bool takeQueryResponse(std::string_view& buffer, QueryResponse& response);
+
+/**
+ * Answers request payloads against one catalog. Handles are resolved through a CourseGraph
+ * built once per catalog generation, so a Get costs a few array reads and a Resolve one
+ * hash probe per ID.
+ */
+class QueryProcessor {
+public:
+    // The graph is allocated from scratch, so a tenant's queries count against its quota.
+    explicit QueryProcessor(const Catalog& catalog,
+                            std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+    // Appends the complete response frame for one request payload to out.
+    void handle(std::string_view payload, std::string& out);
+
+private:
+    // Body of handle(); the public entry point wraps it in the query probes.
+    void answer(std::string_view payload, std::string& out);
+    // Rebuilds the graph when the catalog has moved to a new generation.
+    void refreshIndex();
+    // Handle of id plus one, or 0 when the catalog does not have it. Needs a current graph.
+    std::uint64_t handleTag(std::string_view id) const;
+
+    const Catalog& catalog;
+    CourseGraph graph;
+};
+
+/**
+ * Reads request frames from input until end of stream and writes the responses to output.
+ * Responses are batched and flushed whenever the input has no more buffered requests, so
+ * pipelined clients get one write per burst rather than one per lookup. Returns the
+ * number of requests answered.
+ */
+std::size_t serveBinaryQueries(std::istream& input, std::ostream& output, const Catalog& catalog,
+                               std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
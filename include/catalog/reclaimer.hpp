@@ -0,0 +1,52 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Frees retired catalog data on a background thread so a reload (or a GUI refresh)
+ * never waits on tearing down millions of strings. One shared worker is started lazily
+ * the first time something is retired and is joined when the process exits.
+ */
+class CatalogReclaimer {
+public:
+    // Process-wide instance shared by every Catalog.
+    static CatalogReclaimer& instance();
+
+    CatalogReclaimer(const CatalogReclaimer&) = delete;
+    CatalogReclaimer& operator=(const CatalogReclaimer&) = delete;
+    ~CatalogReclaimer();
+
+    /**
+     * Takes ownership of value and destroys it on the reclamation thread.
+     * The caller's object is left moved-from and cheap to destroy.
+     */
+    template <typename T>
+    void retire(T&& value) {
+        static_assert(!std::is_lvalue_reference_v<T>, "retire() takes ownership; pass an rvalue");
+        enqueue(std::make_shared<std::decay_t<T>>(std::move(value)));
+    }
+
+    // Blocks until everything retired so far has been freed (useful before measuring memory).
+    void drain();
+
+private:
+    CatalogReclaimer() = default;
+
+    void enqueue(std::shared_ptr<void> garbage);
+    void run();
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::deque<std::shared_ptr<void>> pending;
+    bool busy = false;
+    bool stopping = false;
+    std::thread worker;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "catalog/snapshot.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Outcome of publishing one catalog generation.
+struct PublishResult {
+    bool ok = false;
+    bool unchanged = false;          // The catalog matched the last generation; nothing was written.
+    std::uint64_t generation = 0;    // Generation now current in the directory.
+    std::size_t deltaBytes = 0;      // Size of the delta written for this generation (0 for the first).
+    std::size_t snapshotBytes = 0;   // Size of the full snapshot written alongside it.
+    std::vector<std::string> warnings;
+};
+
+/**
+ * Primary side of directory-based replication. Each publish() writes
+ * delta-<from>-<to>.bin for replicas that are already current plus
+ * snapshot-<to>.bin for ones that are new or fell behind, and removes the older
+ * snapshot. Files are written under a temporary name and renamed into place, so readers
+ * never see partial data. A publisher pointed at an existing directory resumes from the
+ * newest snapshot there.
+ */
+class CatalogPublisher {
+public:
+    explicit CatalogPublisher(std::string directory);
+
+    PublishResult publish(const Catalog& catalog);
+
+private:
+    std::string directory;
+    std::optional<CatalogImage> lastPublished;
+};
+
+/**
+ * Replica side: follows a publisher's directory. sync() applies every delta that
+ * continues the replica's current generation, verifying checksums as it goes, and falls
+ * back to the newest snapshot when it has no generation yet, a delta is missing, or a
+ * checksum does not match. The target catalog is rebuilt once per sync.
+ */
+class CatalogReplica {
+public:
+    explicit CatalogReplica(std::string directory);
+
+    LoadResult sync(Catalog& target);
+
+    // Generation currently held; 0 before the first successful sync.
+    std::uint64_t generation() const;
+
+private:
+    std::string directory;
+    CatalogImage image;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+// Vectorized byte scans shared by the loaders. Each uses SSE2 where the target has it
+// (every x86-64 build) and falls back to a portable byte loop elsewhere. All of them
+// return `size` when nothing matches.
+
+// First '"' or '\\' at or after pos; used to step over JSON strings.
+std::size_t findQuoteOrBackslash(const char* data, std::size_t size, std::size_t pos);
+
+// First JSON structural byte that matters when skipping a nested value: " { } [ ]
+std::size_t findJsonStructural(const char* data, std::size_t size, std::size_t pos);
+
+// First occurrence of `target` at or after pos.
+std::size_t findByte(const char* data, std::size_t size, std::size_t pos, char target);
+
+// Number of '\n' bytes in the range, used to number lines before parallel parsing.
+std::size_t countNewlines(const char* data, std::size_t size);
+
+/**
+ * Offset of the first byte that starts an invalid UTF-8 sequence (bad lead byte, missing
+ * continuation, overlong form, surrogate, or code point past U+10FFFF), or size when the
+ * range is valid. ASCII runs are cleared 16 bytes per step; only multi-byte sequences are
+ * decoded one at a time.
+ */
+std::size_t findInvalidUtf8(const char* data, std::size_t size, std::size_t pos);
+
+// Length of the valid UTF-8 sequence starting at pos, or 0 when it is invalid.
+std::size_t validUtf8SequenceLength(const char* data, std::size_t size, std::size_t pos);
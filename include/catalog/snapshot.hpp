@@ -0,0 +1,120 @@
+#pragma once
+
+#include "catalog/catalog.hpp"
+#include "catalog/worker_pool.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// One catalog generation as plain sorted records, the unit that snapshots and deltas describe.
+struct CatalogImage {
+    std::uint64_t generation = 0;  // 0 means "no generation yet".
+    std::uint64_t checksum = 0;    // imageChecksum(courses), kept current by every function below.
+    std::vector<Course> courses;   // Sorted by courseNumber, no duplicate IDs.
+};
+
+/**
+ * 64-bit content checksum over the sorted records (IDs, titles, and prerequisite lists in
+ * order). Two images with the same checksum hold the same catalog for replication purposes.
+ */
+std::uint64_t imageChecksum(const std::vector<Course>& sortedCourses);
+
+// Copies a catalog into an image tagged with the given generation.
+CatalogImage imageOf(const Catalog& catalog, std::uint64_t generation);
+
+/**
+ * Serializes a full image as a header plus sections of about 64 KiB of records. The header
+ * lists each section's course count, size, CRC-32C, and first ID, and carries a CRC-32C of
+ * its own, so readers can check (and decode) any section without touching the others.
+ */
+std::string encodeSnapshot(const CatalogImage& image);
+
+/**
+ * Parses a snapshot produced by encodeSnapshot. Returns false with a reason in error when
+ * the bytes are truncated, not a snapshot, or fail a checksum; image is untouched then.
+ * Sections are checked and decoded in parallel on the shared pool. Snapshots written
+ * before sections existed are still accepted and verified against their image checksum.
+ */
+bool decodeSnapshot(std::string_view bytes, CatalogImage& image, std::string& error);
+
+/**
+ * Random access to a sectioned snapshot. open() checks only the header, so it costs the
+ * same for any catalog size; each section's CRC-32C is checked the first time the section
+ * is read, and verifyAll() checks whatever is left (for example from a background task
+ * while the first lookups are already being answered). Results are remembered, so every
+ * section is hashed at most once. The snapshot bytes must outlive the reader. Const
+ * members may be called from several threads at once.
+ */
+class SnapshotReader {
+public:
+    // Parses and checks the header. Returns false with a reason in error when it is bad.
+    bool open(std::string_view bytes, std::string& error);
+
+    std::uint64_t generation() const { return imageGeneration; }
+    std::uint64_t checksum() const { return imageChecksumValue; }
+    std::size_t courseCount() const { return totalCourses; }
+    std::size_t sectionCount() const { return sections.size(); }
+
+    // Position of the section's first course in the whole image, and how many it holds.
+    std::size_t sectionFirstCourse(std::size_t section) const { return sections[section].firstCourse; }
+    std::size_t sectionCourseCount(std::size_t section) const { return sections[section].courses; }
+
+    // Checks one section's CRC-32C unless that already happened; true when it is intact.
+    bool verifySection(std::size_t section) const;
+
+    // Checks every section not checked yet, spread over the shared pool; true when all are intact.
+    bool verifyAll(TaskPriority priority = TaskPriority::Batch) const;
+
+    // Sections that failed their check so far, in order.
+    std::vector<std::size_t> corruptSections() const;
+
+    /**
+     * Decodes a section into out, which must hold exactly sectionCourseCount(section)
+     * records. Returns false with a reason in error when the section fails its check or
+     * does not parse.
+     */
+    bool readSection(std::size_t section, std::span<Course> out, std::string& error) const;
+
+    /**
+     * Looks one course up by ID, decoding only the section that can hold it. Returns
+     * nothing when the ID is absent, and also sets error when that section is damaged.
+     */
+    std::optional<Course> find(std::string_view courseId, std::string& error) const;
+
+private:
+    struct Section {
+        std::size_t offset = 0;  // Into payload.
+        std::size_t bytes = 0;
+        std::size_t firstCourse = 0;
+        std::size_t courses = 0;
+        std::uint32_t crc = 0;
+        std::string_view firstId;  // Points into the header.
+    };
+
+    std::string_view payload;  // Concatenated section records after the header.
+    std::vector<Section> sections;
+    std::unique_ptr<std::atomic<std::uint8_t>[]> sectionState;  // 0 unchecked, 1 intact, 2 corrupt.
+    std::uint64_t imageGeneration = 0;
+    std::uint64_t imageChecksumValue = 0;
+    std::size_t totalCourses = 0;
+};
+
+/**
+ * Encodes the changes that turn before into after: removed IDs plus full records for every
+ * added or changed course, so the size tracks the change rather than the catalog. Both
+ * checksums are embedded so a replica can verify its base and the result.
+ */
+std::string encodeDelta(const CatalogImage& before, const CatalogImage& after);
+
+/**
+ * Applies a delta to image in one merge pass. Fails (leaving image untouched) when the
+ * delta was cut against a different generation or checksum, or the result does not match.
+ */
+bool applyDelta(std::string_view bytes, CatalogImage& image, std::string& error);
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "catalog/catalog.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Memory resource that counts every byte it hands out and refuses allocations that would
+ * take the owner past its quota. Refusals throw std::bad_alloc, as memory resources do,
+ * and are counted so they show up in usage reports. Memory the owner holds outside the
+ * resource (see setExternalBytes) is charged against the same quota.
+ */
+class QuotaMemoryResource : public std::pmr::memory_resource {
+public:
+    // quotaBytes of 0 means unlimited.
+    QuotaMemoryResource(std::size_t quotaBytes, std::pmr::memory_resource* upstream);
+
+    std::size_t quota() const;
+    std::size_t bytesInUse() const;
+    std::size_t peakBytes() const;
+    std::size_t rejectedAllocations() const;
+
+    // Bytes held elsewhere (a tenant's catalog) that also count against the quota.
+    void setExternalBytes(std::size_t bytes);
+    std::size_t externalBytes() const;
+
+    // Room left under the quota, or SIZE_MAX when unlimited.
+    std::size_t headroom() const;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    const std::size_t quotaBytes;
+    std::pmr::memory_resource* upstream;
+    std::atomic<std::size_t> inUse{0};
+    std::atomic<std::size_t> peak{0};
+    std::atomic<std::size_t> external{0};
+    std::atomic<std::size_t> rejected{0};
+};
+
+// Point-in-time memory report for one tenant.
+struct TenantUsage {
+    std::string name;
+    std::size_t quotaBytes = 0;       // 0 when unlimited.
+    std::size_t catalogBytes = 0;     // Estimated footprint of the loaded catalog.
+    std::size_t scratchBytes = 0;     // Caches and query scratch drawn from the tenant resource.
+    std::size_t peakScratchBytes = 0;
+    std::size_t rejectedAllocations = 0;
+    std::size_t courses = 0;
+    std::uint64_t generation = 0;
+};
+
+/**
+ * One tenant's catalog plus the memory resource its caches and query scratch allocate
+ * from. Each tenant gets private pools, so one tenant's churn never fragments or locks
+ * another's free lists, and its quota covers both the catalog and the scratch memory.
+ */
+class Tenant {
+public:
+    Tenant(std::string name, std::size_t quotaBytes);
+    Tenant(const Tenant&) = delete;
+    Tenant& operator=(const Tenant&) = delete;
+
+    const std::string& name() const;
+    const Catalog& catalog() const;
+
+    // Resource for anything allocated on the tenant's behalf (query processors, caches).
+    std::pmr::memory_resource* memory();
+
+    /**
+     * Loads fileName as the tenant's catalog. Always rebuilds, and rejects with a warning
+     * (keeping the current catalog) when the new one would not fit in the quota next to
+     * the scratch memory already in use.
+     */
+    LoadResult load(const std::string& fileName, LoadOptions options = {});
+
+    TenantUsage usage() const;
+
+private:
+    std::string tenantName;
+    std::pmr::synchronized_pool_resource pools;
+    QuotaMemoryResource quotaResource;
+    Catalog tenantCatalog;
+};
+
+/**
+ * Thread-safe set of tenants keyed by name. Tenants are never removed, so references
+ * returned by add() and find() stay valid for the registry's lifetime.
+ */
+class TenantRegistry {
+public:
+    // Creates the tenant, or returns the existing one (whose quota is left unchanged).
+    Tenant& add(const std::string& name, std::size_t quotaBytes);
+    Tenant* find(const std::string& name);
+
+    // Usage for every tenant, ordered by name.
+    std::vector<TenantUsage> usage() const;
+
+private:
+    mutable std::mutex mutex;
+    std::map<std::string, std::unique_ptr<Tenant>> tenants;
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "catalog/catalog.hpp"
+#include "catalog/flat_hash_map.hpp"
+#include "catalog/id_scheme.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Weekday bits for Section::days, Monday first.
+enum WeekdayBits : std::uint8_t {
+    kMonday = 1,
+    kTuesday = 2,
+    kWednesday = 4,
+    kThursday = 8,
+    kFriday = 16,
+    kSaturday = 32,
+    kSunday = 64,
+};
+
+inline constexpr std::size_t kDaysPerWeek = 7;
+
+// One scheduled offering of a course, meeting at the same time on each of its days.
+struct Section {
+    std::string courseNumber;
+    std::string sectionId;          // Unique within the course, e.g. "01" or "L2".
+    std::uint8_t days = 0;          // WeekdayBits.
+    std::uint16_t startMinute = 0;  // Minutes after midnight.
+    std::uint16_t endMinute = 0;    // Exclusive, so back-to-back sections do not conflict.
+    std::uint32_t capacity = 0;
+};
+
+// Meeting days and hours in the form the sections file uses, e.g. "MWF 09:00-09:50".
+std::string formatSectionTime(const Section& section);
+
+struct TimetableLoadResult {
+    bool ok = false;
+    std::size_t sections = 0;
+    std::vector<std::string> warnings;
+    std::string path;
+};
+
+/**
+ * Course sections with their meeting times, indexed for schedule conflict checks. Each
+ * weekday has its own interval tree over the sections that meet that day: the meetings
+ * sorted by start time in one array, read as an implicit balanced tree in which every
+ * node also keeps the latest end time below it. A time range is checked against a day in
+ * O(log n + matches) without touching the sections that end before it or start after it.
+ *
+ * The sections file is CSV with one section per line:
+ *   Course,Section,Days,Start,End,Capacity
+ *   CSCI200,01,MWF,09:00,09:50,30
+ * Days use M T W R F S U (R is Thursday, U Sunday) and times are 24-hour. A first line
+ * whose course column is not a course ID is taken as a header. Rows are checked against
+ * the catalog they are loaded alongside, and bad rows are skipped with a warning.
+ *
+ * Offered courses and their prerequisites are numbered at load time, so an eligibility
+ * check is a few array reads rather than a catalog lookup and a hash per prerequisite.
+ * Like CourseGraph, the timetable then reflects the catalog generation it was loaded
+ * against; reload it when isCurrent() turns false.
+ */
+class Timetable {
+public:
+    /**
+     * Replaces the timetable with the sections in fileName. Sections of courses the
+     * catalog does not have are skipped, as are repeated course and section pairs. The
+     * timetable is left unchanged when the file cannot be read.
+     */
+    TimetableLoadResult load(const std::string& fileName, const Catalog& catalog,
+                             const CourseIdScheme& idScheme = kLettersDigitsIds);
+
+    // True while the catalog is still at the generation the sections were loaded against.
+    bool isCurrent(const Catalog& catalog) const;
+
+    std::size_t size() const { return sectionList.size(); }
+
+    // All sections, ordered by course ID and then section ID; indices are section handles.
+    const std::vector<Section>& sections() const { return sectionList; }
+
+    // Handle of one section, if it is offered.
+    std::optional<std::uint32_t> find(std::string_view courseId, std::string_view sectionId) const;
+
+    // Handles of the sections of one course, in section ID order.
+    std::vector<std::uint32_t> sectionsOf(std::string_view courseId) const;
+
+    /**
+     * Appends the handles of every section that meets during [startMinute, endMinute) on
+     * any of days. A section meeting on several of those days is appended once per day.
+     */
+    void overlapping(std::uint8_t days, std::uint16_t startMinute, std::uint16_t endMinute,
+                     std::vector<std::uint32_t>& handles) const;
+
+    /**
+     * Sections a student could add to schedule: every section that clashes with none of
+     * schedule's sections, of every course they are eligible for. A course is eligible when
+     * it is not in taken, has no section in schedule, and each prerequisite the catalog
+     * listed for it at load time is in taken. taken holds normalized course IDs. Handles
+     * come back in course and section order.
+     */
+    std::vector<std::uint32_t> openSections(const std::vector<std::string>& taken,
+                                            const std::vector<std::uint32_t>& schedule) const;
+
+    // Heap bytes held by the timetable and its trees.
+    std::size_t memoryFootprint() const;
+
+private:
+    // One meeting in a day's tree. maxEnd covers the node and everything below it.
+    struct MeetingNode {
+        std::uint16_t startMinute = 0;
+        std::uint16_t endMinute = 0;
+        std::uint16_t maxEnd = 0;
+        std::uint32_t section = 0;
+    };
+
+    // A course with sections; its handles are [firstSection, firstSection + sectionCount).
+    struct OfferedCourse {
+        std::uint32_t firstSection = 0;
+        std::uint32_t sectionCount = 0;
+        std::uint32_t firstPrerequisite = 0;  // Into prerequisiteSlots.
+        std::uint32_t prerequisiteCount = 0;
+    };
+
+    void buildIndex(const Catalog& catalog);
+    // Appends matches in the subtree of tree[first, last) to handles.
+    static void collectOverlaps(const std::vector<MeetingNode>& tree, std::size_t first, std::size_t last,
+                                std::uint16_t startMinute, std::uint16_t endMinute,
+                                std::vector<std::uint32_t>& handles);
+
+    std::vector<Section> sectionList;
+    std::vector<OfferedCourse> offeredCourses;  // In course ID order.
+    // Slot of every offered course and prerequisite. Offered courses come first, so an
+    // offered course's slot is also its index in offeredCourses.
+    FlatHashMap<std::string, std::uint32_t, StringHash, std::equal_to<>> courseSlots;
+    std::vector<std::uint32_t> prerequisiteSlots;
+    std::array<std::vector<MeetingNode>, kDaysPerWeek> dayTrees;
+    const Catalog* loadedAgainst = nullptr;
+    std::uint64_t loadedGeneration = 0;
+};
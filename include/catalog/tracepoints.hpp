@@ -0,0 +1,30 @@
+#pragma once
+
+// Linux USDT probes for bpftrace, perf, and SystemTap, all under the "catalog" provider.
+// Each probe compiles to a single nop plus an ELF note; the arguments are only read when
+// a tracer is attached. Without <sys/sdt.h>, or with CATALOG_NO_USDT defined, they vanish.
+//
+//   load__start   (const char* file, int reloadMode)
+//   parse__done   (const char* file, size_t acceptedCourses, int cancelled)
+//   index__done   (size_t courses)
+//   swap__done    (uint64 generation)
+//   load__done    (const char* file, int ok, size_t courses, size_t warnings)
+//   lookup        (const char* id, int found)
+//   query__start  (int opcode, uint32 requestId, size_t payloadBytes)
+//   query__done   (int opcode, uint32 requestId, int status, size_t responseBytes)
+//
+// Double underscores show up as dashes in most tools, e.g. usdt:advisor_cli:catalog:load-done.
+
+#if !defined(CATALOG_NO_USDT) && defined(__linux__) && __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define CATALOG_TRACE1(name, a) DTRACE_PROBE1(catalog, name, a)
+#define CATALOG_TRACE2(name, a, b) DTRACE_PROBE2(catalog, name, a, b)
+#define CATALOG_TRACE3(name, a, b, c) DTRACE_PROBE3(catalog, name, a, b, c)
+#define CATALOG_TRACE4(name, a, b, c, d) DTRACE_PROBE4(catalog, name, a, b, c, d)
+#else
+// Arguments stay inside sizeof so they are never evaluated but still count as used.
+#define CATALOG_TRACE1(name, a) ((void)sizeof((a), 0))
+#define CATALOG_TRACE2(name, a, b) ((void)sizeof((a), (b), 0))
+#define CATALOG_TRACE3(name, a, b, c) ((void)sizeof((a), (b), (c), 0))
+#define CATALOG_TRACE4(name, a, b, c, d) ((void)sizeof((a), (b), (c), (d), 0))
+#endif
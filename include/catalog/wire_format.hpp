@@ -0,0 +1,142 @@
+#pragma once
+
+#include "catalog/course.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Little-endian integers, LEB128 varints, and length-prefixed strings shared by the
+// snapshot files, the disk catalog, and the binary query protocol.
+
+inline void putU32(std::string& out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>(value >> (i * 8)));
+    }
+}
+
+inline void putU64(std::string& out, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<char>(value >> (i * 8)));
+    }
+}
+
+inline void putVarint(std::string& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+inline void putString(std::string& out, std::string_view text) {
+    putVarint(out, text.size());
+    out.append(text);
+}
+
+// Bounds-checked reader; the first failure sticks so callers check `ok` once at the end.
+struct ByteReader {
+    std::string_view bytes;
+    std::size_t pos = 0;
+    bool ok = true;
+
+    std::size_t remaining() const { return bytes.size() - pos; }
+
+    bool expect(std::string_view magic) {
+        if (!ok || remaining() < magic.size() || bytes.substr(pos, magic.size()) != magic) {
+            return ok = false;
+        }
+        pos += magic.size();
+        return true;
+    }
+
+    std::uint8_t u8() {
+        if (!ok || remaining() < 1) {
+            ok = false;
+            return 0;
+        }
+        return static_cast<std::uint8_t>(bytes[pos++]);
+    }
+
+    std::uint32_t u32() { return static_cast<std::uint32_t>(fixed(4)); }
+    std::uint64_t u64() { return fixed(8); }
+
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; ok && shift < 64; shift += 7) {
+            if (remaining() == 0) {
+                break;
+            }
+            const auto byte = static_cast<unsigned char>(bytes[pos++]);
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    // Counts are capped by the bytes left so a corrupt length cannot trigger a huge reserve.
+    std::size_t count() {
+        const std::uint64_t value = varint();
+        if (value > remaining()) {
+            ok = false;
+            return 0;
+        }
+        return static_cast<std::size_t>(value);
+    }
+
+    // View into the buffer; valid as long as the bytes are.
+    std::string_view view() {
+        const std::size_t length = count();
+        if (!ok) {
+            return {};
+        }
+        const std::string_view value = bytes.substr(pos, length);
+        pos += length;
+        return value;
+    }
+
+    void text(std::string& out) {
+        const std::string_view value = view();
+        if (ok) {
+            out.assign(value);
+        }
+    }
+
+private:
+    std::uint64_t fixed(int width) {
+        if (!ok || remaining() < static_cast<std::size_t>(width)) {
+            ok = false;
+            return 0;
+        }
+        std::uint64_t value = 0;
+        for (int i = 0; i < width; ++i) {
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(bytes[pos + i])) << (i * 8);
+        }
+        pos += static_cast<std::size_t>(width);
+        return value;
+    }
+};
+
+// One course record: ID, title, then the prerequisite count and IDs.
+inline void putCourse(std::string& out, const Course& course) {
+    putString(out, course.courseNumber);
+    putString(out, course.courseName);
+    putVarint(out, course.prerequisites.size());
+    for (const auto& prereq : course.prerequisites) {
+        putString(out, prereq);
+    }
+}
+
+// Reads one record written by putCourse.
+inline void readCourse(ByteReader& reader, Course& out) {
+    reader.text(out.courseNumber);
+    reader.text(out.courseName);
+    out.prerequisites.resize(reader.count());
+    for (auto& prereq : out.prerequisites) {
+        reader.text(prereq);
+    }
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Scheduling class for pool work. Interactive tasks always run before queued batch tasks.
+enum class TaskPriority {
+    Interactive,  // Advisor lookups, GUI loads: anything a person is waiting on.
+    Batch         // Audits, exports, bulk reloads: throughput matters, latency does not.
+};
+
+// Counters a pool has collected since it started; see WorkerPool::stats().
+struct WorkerPoolStats {
+    struct Worker {
+        std::uint64_t tasksRun = 0;  // Its own tasks and stolen ones.
+        std::uint64_t steals = 0;    // Tasks taken from another worker's deque.
+        std::uint64_t sleeps = 0;    // Times it found every deque empty and went idle.
+    };
+    std::vector<Worker> workers;
+    std::uint64_t tasksSubmitted = 0;
+    std::uint64_t sliceJobs = 0;     // forEachSlice() and reduceSlices() calls.
+    std::uint64_t batchYields = 0;   // Times a batch job handed its worker to interactive work.
+    std::size_t queuedTasks = 0;     // Waiting right now.
+    std::size_t peakQueuedTasks = 0;
+};
+
+/**
+ * Shared worker pool for catalog work. Every worker owns one deque per priority class;
+ * it pops its own newest task first and, when idle, steals the oldest task from another
+ * worker in the same class, always trying every interactive queue before any batch queue.
+ * Batch work submitted through forEachSlice() hands its worker back after any slice that
+ * ends while interactive tasks are waiting, on the helpers and on a calling worker alike,
+ * so an interactive request waits at most one slice rather than a whole batch job.
+ */
+class WorkerPool {
+public:
+    /**
+     * Process-wide pool, started on first use. It has as many workers as configureShared()
+     * asked for, else as the CATALOG_WORKERS environment variable names, else one per
+     * hardware thread.
+     */
+    static WorkerPool& shared();
+
+    /**
+     * Sets the size of the shared pool. Only takes effect before the pool's first use, so
+     * front ends call it while parsing their options; returns false once it is too late.
+     */
+    static bool configureShared(std::size_t workerCount);
+
+    explicit WorkerPool(std::size_t workerCount);
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    ~WorkerPool();
+
+    std::size_t size() const;
+
+    // Queues a task, which must not throw. Tasks submitted from a worker go to its own deque.
+    void submit(TaskPriority priority, std::function<void()> task);
+
+    /**
+     * Runs body(begin, end) over [0, count) in slices of at most `grain` items and returns
+     * once all of them are done. The calling thread works through slices as well. The first
+     * exception thrown by body is rethrown here after the remaining slices finish.
+     */
+    void forEachSlice(TaskPriority priority, std::size_t count, std::size_t grain,
+                      const std::function<void(std::size_t, std::size_t)>& body);
+
+    /**
+     * Parallel reduction over [0, count): map(begin, end) folds one slice into a T, and the
+     * slice results are combined in slice order, starting from init, so the answer does not
+     * depend on which worker ran what. Slices and exceptions behave as in forEachSlice().
+     */
+    template <typename T, typename Map, typename Combine>
+    T reduceSlices(TaskPriority priority, std::size_t count, std::size_t grain, T init, Map map, Combine combine) {
+        grain = std::max<std::size_t>(1, grain);
+        std::vector<std::optional<T>> partials((count + grain - 1) / grain);
+        forEachSlice(priority, count, grain, [&](std::size_t first, std::size_t last) {
+            partials[first / grain].emplace(map(first, last));
+        });
+        for (auto& partial : partials) {
+            init = combine(std::move(init), std::move(*partial));
+        }
+        return init;
+    }
+
+    WorkerPoolStats stats() const;
+
+private:
+    friend class TaskGroup;
+    struct SliceJob;
+
+    struct WorkerQueues {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks[2];  // Indexed by TaskPriority.
+        // Only ever incremented by the owning worker; read by stats().
+        std::atomic<std::uint64_t> tasksRun{0};
+        std::atomic<std::uint64_t> steals{0};
+        std::atomic<std::uint64_t> sleeps{0};
+    };
+
+    // Pops or steals one task for worker `self` and runs it, trying classes from Interactive
+    // up to `lowest`; false when nothing of those classes was queued.
+    bool runOneTask(std::size_t self, TaskPriority lowest = TaskPriority::Batch);
+    /**
+     * Wait loop for a pool worker: runs tasks of `priority` (plus interactive ones for a batch
+     * waiter, which is what a batch job yields for) until finished() holds. With nothing to
+     * run it yields a few times, then sleeps on done, waking every millisecond to look for
+     * tasks again. done must be notified under mutex whenever finished() becomes true.
+     */
+    void helpUntil(TaskPriority priority, std::mutex& mutex, std::condition_variable& done,
+                   const std::function<bool()>& finished);
+    void workerLoop(std::size_t index);
+    // Pool-side loop of forEachSlice; batch jobs re-queue themselves when interactive work waits.
+    void runSlices(TaskPriority priority, const std::shared_ptr<SliceJob>& job);
+
+    std::vector<std::unique_ptr<WorkerQueues>> queues;
+    std::vector<std::thread> threads;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<std::size_t> queuedTasks{0};
+    std::atomic<std::size_t> queuedInteractive{0};
+    std::atomic<std::size_t> nextQueue{0};
+    std::atomic<std::size_t> peakQueuedTasks{0};
+    std::atomic<std::uint64_t> tasksSubmitted{0};
+    std::atomic<std::uint64_t> sliceJobs{0};
+    std::atomic<std::uint64_t> batchYields{0};
+    bool stopping = false;
+};
+
+// One line per worker plus totals, for --pool-stats and the GUI's statistics dialog.
+std::string formatWorkerPoolStats(const WorkerPoolStats& stats);
+
+/**
+ * Tasks that are waited for together. run() queues a task on the pool, and wait() returns
+ * once every task run so far has finished, rethrowing the first exception any of them
+ * threw. A worker that waits keeps running pool tasks of the group's class (and, for a
+ * batch group, interactive ones), so groups nest inside pool work without deadlocking;
+ * when none are queued it sleeps until the group finishes. The destructor waits too, so
+ * tasks never outlive what they capture by reference.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskPriority priority = TaskPriority::Interactive, WorkerPool& pool = WorkerPool::shared());
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    ~TaskGroup();
+
+    void run(std::function<void()> task);
+    void wait();
+
+private:
+    struct State;
+
+    WorkerPool& pool;
+    TaskPriority priority;
+    std::shared_ptr<State> state;
+};
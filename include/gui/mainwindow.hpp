@@ -1,20 +1,32 @@
 #pragma once
 
 #include "catalog/catalog.hpp"
+#include "catalog/catalog_diff.hpp"
 #include "gui/models.hpp"
 
+#include <QFutureWatcher>
 #include <QMainWindow>
 #include <QModelIndex>
 #include <QString>
 
+class QAction;
 class QLabel;
 class QLineEdit;
 class QListView;
 class QListWidget;
 class QListWidgetItem;
+class QPushButton;
+class QStackedWidget;
 class QStatusBar;
 class QTimer;
 
+// Everything the background comparison hands back to the UI thread.
+struct CatalogComparison {
+    LoadResult before;
+    LoadResult after;
+    CatalogDiff diff;
+};
+
 // Qt dashboard window that mirrors the CLI features with a point-and-click UI.
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -38,6 +50,18 @@ private slots:
     void handlePrerequisiteActivated(QListWidgetItem* item);
     // Displays any prerequisites that were missing in the source CSV.
    void showMissingPrerequisites();
+    // Reports the shared worker pool's counters.
+    void showWorkerPoolStats();
+    // Picks a baseline and an updated catalog and diffs them off the UI thread.
+    void compareCatalogs();
+    // Receives the finished comparison and switches the window into diff mode.
+    void handleComparisonFinished();
+    // Shows the prerequisite-level changes for the selected diff row.
+    void handleDiffSelection(const QModelIndex& index);
+    // Returns to the regular course browser and releases the diff.
+    void exitDiffMode();
+    // Asks the running comparison to stop at its next checkpoint.
+    void cancelComparison();
 
 private:
     // Builds the menu bar actions for file handling and warnings.
@@ -50,13 +74,18 @@ private:
     void populateCourseDetails(const Course* course);
     // Replaces the list model contents with the current sorted IDs.
     void refreshCourseList();
+    // Catalog subscriber: updates only the rows and detail pane the new generation touched.
+    void applyCatalogChanges(const CatalogChangeSet& changes);
     // Updates the status bar with the last load result.
     void updateStatusFromLoad(const LoadResult& result);
     void updateWarningsPane(const LoadResult& result);
+    // Builds the diff page shown while comparing catalogs.
+    QWidget* createDiffPage(QWidget* parent);
 
     Catalog catalog;                 // Shared core used by both CLI and GUI paths.
     LoadResult lastLoadResult;       // Remember the latest load outcome for warnings.
     QString currentCatalogPath;      // Stores the last opened file so reload works.
+    QString displayedCourseId;       // Course shown in the detail pane, if any.
 
     CourseListModel* courseListModel = nullptr;  // Left-hand course ID list model.
     QListView* courseListView = nullptr;         // List view showing the IDs.
@@ -66,4 +95,16 @@ private:
     QListWidget* warningsList = nullptr;         // Non-blocking warning display.
     QLabel* warningsTitleLabel = nullptr;        // Header for the warning list.
     QTimer* searchDelayTimer = nullptr;          // Debounce timer for the search box.
+
+    QStackedWidget* viewStack = nullptr;         // Switches between browse and diff pages.
+    CourseDiffModel* courseDiffModel = nullptr;  // Virtualized added/removed/changed rows.
+    QListView* diffListView = nullptr;           // List view showing the diff rows.
+    QLabel* diffSummaryLabel = nullptr;          // Counts for the active comparison.
+    QLabel* diffCourseLabel = nullptr;           // Before/after title for the selected row.
+    QListWidget* diffPrerequisiteList = nullptr; // Highlights added/removed prerequisites.
+    QAction* compareAction = nullptr;            // Disabled while a comparison is running.
+    QAction* exitDiffAction = nullptr;           // Enabled only while in diff mode.
+    QFutureWatcher<CatalogComparison>* comparisonWatcher = nullptr;  // Tracks the background diff.
+    QPushButton* cancelComparisonButton = nullptr;  // Status bar button shown while comparing.
+    CancellationSource comparisonCancellation;      // Replaced for every new comparison.
 };
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "catalog/catalog_diff.hpp"
+
 #include <QAbstractListModel>
 #include <QString>
 #include <vector>
@@ -16,8 +18,29 @@ public:
     QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;  // Display text for each row.
 
     void setCourseIds(std::vector<std::string> courseIds);  // Replace the list backing the view.
+    // Inserts/removes only the affected rows so selection and scroll position survive a reload.
+    void applyChanges(const CatalogChangeSet& changes, const std::vector<std::string>& sortedIds);
     QString courseIdForRow(int row) const;                  // Fetch the ID for selection helpers.
 
 private:
     std::vector<std::string> courseIds;  // Keeps the sorted IDs returned from the catalog.
 };
+
+// Virtualized list model over a catalog diff; rows are formatted on demand so
+// million-row comparisons stay interactive.
+class CourseDiffModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    explicit CourseDiffModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;  // One row per changed course.
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;  // Text plus change colouring.
+
+    void setDiff(CatalogDiff diff);                      // Replace the diff backing the view.
+    const CourseDiffEntry* entryForRow(int row) const;   // Fetch the entry for the detail pane.
+    const CatalogDiff& diff() const;                     // Summary counts for the status bar.
+
+private:
+    CatalogDiff catalogDiff;  // Owns the entries produced off the UI thread.
+};
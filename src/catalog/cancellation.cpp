@@ -0,0 +1,52 @@
+#include "catalog/cancellation.hpp"
+
+#include <algorithm>
+
+CancellationToken CancellationToken::withDeadline(Clock::time_point deadline) {
+    CancellationToken token;
+    token.deadline = deadline;
+    return token;
+}
+
+CancellationToken CancellationToken::withTimeout(Clock::duration timeout) {
+    return withDeadline(Clock::now() + timeout);
+}
+
+CancellationToken CancellationToken::withEarlierDeadline(Clock::time_point newDeadline) const {
+    CancellationToken token = *this;
+    token.deadline = std::min(deadline, newDeadline);
+    return token;
+}
+
+bool CancellationToken::stopRequested() const {
+    if (flag && flag->load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if (parent && parent->stopRequested()) {
+        return true;
+    }
+    // Skip the clock read entirely for tokens without a deadline.
+    return deadline != Clock::time_point::max() && Clock::now() >= deadline;
+}
+
+CancellationSource::CancellationSource()
+    : flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+CancellationSource::CancellationSource(const CancellationToken& parentToken)
+    : flag(std::make_shared<std::atomic<bool>>(false)),
+      parent(std::make_shared<const CancellationToken>(parentToken)) {}
+
+CancellationToken CancellationSource::token() const {
+    CancellationToken token;
+    token.flag = flag;
+    token.parent = parent;
+    return token;
+}
+
+void CancellationSource::cancel() {
+    flag->store(true, std::memory_order_relaxed);
+}
+
+bool CancellationSource::cancelled() const {
+    return flag->load(std::memory_order_relaxed);
+}
@@ -1,13 +1,21 @@
 #include "catalog/catalog.hpp"
 
+#include "catalog/content_hash.hpp"
+#include "catalog/course_parser.hpp"
+#include "catalog/jsonl_parser.hpp"
+#include "catalog/reclaimer.hpp"
+#include "catalog/tracepoints.hpp"
+
 #include <algorithm>
-#include <cctype>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <iterator>
 #include <optional>
-#include <set>
-#include <sstream>
-#include <unordered_map>
+#include <streambuf>
+#include <string_view>
 
 namespace {
 
@@ -16,55 +24,15 @@ using std::string;
 // Matches the search depth used by the CLI to locate CSV files.
 constexpr int kMaxParentSearchDepth = 10;
 
-// Mirrors the trim helper in the CLI so both paths treat whitespace the same way.
-string trim(const string& text) {
-    const auto first = text.find_first_not_of(" \t\r\n");
-    if (first == string::npos) {
-        return "";
-    }
-    const auto last = text.find_last_not_of(" \t\r\n");
-    return text.substr(first, last - first + 1);
-}
+// Catalogs smaller than this are cheap enough to free inline on reload.
+constexpr std::size_t kDeferredReclaimThreshold = 4096;
 
-// Converts the provided string to uppercase to keep IDs normalized.
-string toUpper(string value) {
-    for (char& ch : value) {
-        ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
-    }
-    return value;
-}
+// Files modified more recently than this when read may change again within the same
+// timestamp tick (coarse on some file systems), so their size and time alone prove nothing.
+constexpr auto kSettledModificationAge = std::chrono::seconds(2);
 
-/**
- * Makes sure a course ID starts with letters and ends with digits (think "CSCI200").
- * Anything that breaks that pattern is rejected.
- */
-bool isCourseIdValid(const string& courseId) {
-    if (courseId.empty()) {
-        return false;
-    }
-
-    bool hasLetter = false;
-    bool hasDigit = false;
-
-    for (char ch : courseId) {
-        if (std::isalpha(static_cast<unsigned char>(ch))) {
-            if (hasDigit) {
-                return false;
-            }
-            hasLetter = true;
-            continue;
-        }
-
-        if (std::isdigit(static_cast<unsigned char>(ch))) {
-            hasDigit = true;
-            continue;
-        }
-
-        return false;
-    }
-
-    return hasLetter && hasDigit;
-}
+// Read size of HashingFileBuffer.
+constexpr std::size_t kHashingBufferBytes = 64 << 10;
 
 /**
  * Looks for the course data file by name, starting in the current directory and
@@ -109,9 +77,344 @@ std::optional<std::filesystem::path> resolveCourseFilePath(const std::string& fi
     return std::nullopt;
 }
 
+/**
+ * Read-only file buffer that hashes every byte as the parsers pull it through, so a
+ * load learns its content hash without a second pass over the file. Seeking is limited
+ * to what the loaders do: asking the position, jumping to the end to learn the size, and
+ * rewinding to the start, which restarts the hash. A read that comes up short of the size
+ * the file had when it was opened is an I/O error, and the stream reports it as bad().
+ */
+class HashingFileBuffer : public std::streambuf {
+public:
+    HashingFileBuffer() : buffer(kHashingBufferBytes) {}
+
+    bool open(const std::filesystem::path& path) {
+        if (file.open(path, std::ios::in | std::ios::binary) == nullptr) {
+            return false;
+        }
+        fileSize = file.pubseekoff(0, std::ios::end, std::ios::in);
+        file.pubseekpos(0, std::ios::in);
+        return true;
+    }
+
+    // Hash of the bytes read so far, provided they run unbroken from the start of the file.
+    std::optional<std::uint64_t> contentHash(std::uintmax_t fileSize) const {
+        if (skippedAhead || hasher.size() != fileSize) {
+            return std::nullopt;
+        }
+        return hasher.digest();
+    }
+
+protected:
+    int_type underflow() override {
+        const std::streamsize count = file.sgetn(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (count <= 0) {
+            failIfShort();
+            return traits_type::eof();
+        }
+        hasher.update(buffer.data(), static_cast<std::size_t>(count));
+        filePosition += count;
+        setg(buffer.data(), buffer.data(), buffer.data() + count);
+        return traits_type::to_int_type(buffer[0]);
+    }
+
+    // Large reads (the JSON Lines loader takes the whole file) bypass the buffer.
+    std::streamsize xsgetn(char* out, std::streamsize count) override {
+        const std::streamsize buffered = std::min<std::streamsize>(count, egptr() - gptr());
+        std::copy(gptr(), gptr() + buffered, out);
+        gbump(static_cast<int>(buffered));
+        if (buffered == count) {
+            return count;
+        }
+        const std::streamsize direct = std::max<std::streamsize>(file.sgetn(out + buffered, count - buffered), 0);
+        hasher.update(out + buffered, static_cast<std::size_t>(direct));
+        filePosition += direct;
+        if (buffered + direct < count) {
+            failIfShort();
+        }
+        return buffered + direct;
+    }
+
+    pos_type seekoff(off_type offset, std::ios::seekdir direction, std::ios::openmode which) override {
+        if (offset != 0 || (which & std::ios::out) != 0) {
+            return pos_type(off_type(-1));
+        }
+        if (direction == std::ios::cur) {
+            return pos_type(filePosition - (egptr() - gptr()));
+        }
+        if (direction == std::ios::beg) {
+            file.pubseekpos(0, std::ios::in);
+            hasher = ContentHasher();
+            filePosition = 0;
+            skippedAhead = false;
+        } else {
+            const pos_type end = file.pubseekoff(0, std::ios::end, std::ios::in);
+            if (end == pos_type(off_type(-1))) {
+                return end;
+            }
+            filePosition = end;
+            skippedAhead = true;
+        }
+        setg(nullptr, nullptr, nullptr);
+        return pos_type(filePosition);
+    }
+
+    pos_type seekpos(pos_type position, std::ios::openmode which) override {
+        return seekoff(off_type(position), std::ios::beg, which);
+    }
+
+private:
+    // The input functions catch what a buffer throws and set badbit, which is how a
+    // streambuf tells the parsers' stream that the end it hit was not the end of the file.
+    void failIfShort() const {
+        if (fileSize != pos_type(off_type(-1)) && filePosition < off_type(fileSize)) {
+            throw std::ios_base::failure("Read error before the end of the file");
+        }
+    }
+
+    std::filebuf file;
+    std::vector<char> buffer;
+    ContentHasher hasher;
+    pos_type fileSize = pos_type(off_type(-1));  // At open; -1 when it could not be found.
+    std::streamoff filePosition = 0;  // Bytes taken from the file, including those still buffered.
+    bool skippedAhead = false;        // Bytes were skipped, so the hash no longer covers a prefix.
+};
+
+// Size and modification time of path, or nothing when either cannot be read.
+std::optional<std::pair<std::uintmax_t, std::filesystem::file_time_type>> fileStamp(
+    const std::filesystem::path& path) {
+    std::error_code sizeError;
+    std::error_code timeError;
+    const std::uintmax_t size = std::filesystem::file_size(path, sizeError);
+    const auto modified = std::filesystem::last_write_time(path, timeError);
+    if (sizeError || timeError) {
+        return std::nullopt;
+    }
+    return std::make_pair(size, modified);
+}
+
+bool isSettled(std::filesystem::file_time_type modified) {
+    return std::filesystem::file_time_type::clock::now() - modified >= kSettledModificationAge;
+}
+
+// Options that change what a file parses to; the others only affect how the work is done.
+bool sameParseOptions(const SourceFingerprint& source, const LoadOptions& options) {
+    return source.format == options.format && source.header == options.header &&
+           source.columns == options.columns && source.idScheme.normalize == options.idScheme.normalize;
+}
+
+/**
+ * Streams CSV rows, resolving the column layout from the first non-empty line, and hands
+ * every valid course to parsed, if set, and then to onCourse (which may move from it).
+ * Returns false when a header row could not be mapped; the reason is already in warnings.
+ */
+bool readCsvCourses(std::istream& input,
+                    const LoadOptions& options,
+                    bool& cancelled,
+                    std::vector<string>& warnings,
+                    const std::function<void(Course&)>& onCourse,
+                    const std::function<void(const Course&)>& parsed) {
+    CancellationCheckpoint checkpoint(options.cancellation);
+    std::optional<CsvRowParser> parser;
+    string line;
+    string repaired;
+    std::size_t lineNumber = 0;
+    Course course;
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        if (checkpoint.shouldStop()) {
+            cancelled = true;
+            break;
+        }
+        // CR from CRLF endings is trimmed with the other whitespace; the BOM only on line one.
+        std::string_view row = trimView(lineNumber == 1 ? stripUtf8Bom(line) : std::string_view(line));
+        if (row.empty()) {
+            continue;
+        }
+        row = repairUtf8Line(row, lineNumber, repaired, warnings);
+
+        if (!parser) {
+            const bool isHeader = options.header == HeaderMode::Present ||
+                                  (options.header == HeaderMode::Auto && looksLikeHeader(row, options.columns, options.idScheme));
+            if (isHeader) {
+                auto layout = headerLayout(row, options.columns, warnings);
+                if (!layout) {
+                    return false;
+                }
+                parser.emplace(std::move(*layout), options.idScheme);
+                continue;
+            }
+            parser.emplace(positionalLayout(options.columns), options.idScheme);
+        }
+
+        if (parser->parse(row, lineNumber, course, warnings)) {
+            if (parsed) {
+                parsed(course);
+            }
+            onCourse(course);
+        }
+    }
+    return true;
+}
+
+// Picks the parser: explicit options win, otherwise .jsonl/.ndjson files are JSON Lines.
+InputFormat resolveFormat(const LoadOptions& options, const std::filesystem::path& path) {
+    if (options.format != InputFormat::Auto) {
+        return options.format;
+    }
+    const string extension = path.extension().string();
+    if (extension == ".jsonl" || extension == ".ndjson" || extension == ".JSONL" || extension == ".NDJSON") {
+        return InputFormat::JsonLines;
+    }
+    return InputFormat::Csv;
+}
+
+/**
+ * Feeds every course in the file to onCourse in file order, whatever the format. parsed,
+ * when set, sees each course as soon as it is read, possibly on a worker thread (see
+ * readJsonLines). Returns false when the file could not be mapped; the reason is already
+ * in warnings.
+ */
+bool readCourses(std::istream& input,
+                 InputFormat format,
+                 const LoadOptions& options,
+                 bool& cancelled,
+                 std::vector<string>& warnings,
+                 const std::function<void(Course&)>& onCourse,
+                 const std::function<void(const Course&)>& parsed = {}) {
+    if (format != InputFormat::JsonLines) {
+        return readCsvCourses(input, options, cancelled, warnings, onCourse, parsed);
+    }
+
+    // JSON Lines is parsed from one buffer so large files can be split across threads.
+    input.seekg(0, std::ios::end);
+    const std::streamoff size = input.tellg();
+    input.seekg(0, std::ios::beg);
+    string contents(size > 0 ? static_cast<std::size_t>(size) : 0, '\0');
+    input.read(contents.data(), static_cast<std::streamsize>(contents.size()));
+    contents.resize(static_cast<std::size_t>(input.gcount()));
+
+    readJsonLines(stripUtf8Bom(contents), options.columns, options.idScheme, options.cancellation, options.priority,
+                  warnings, onCourse, cancelled, parsed);
+    return true;
+}
+
+// Lists prerequisites that point at courses missing from the directory, sorted and unique.
+// Courses are checked in parallel slices of the sorted ID list.
+template <typename Index>
+std::vector<string> collectMissingPrerequisites(const Index& directory, const std::vector<string>& sortedIds,
+                                                TaskPriority priority) {
+    std::vector<string> missing = WorkerPool::shared().reduceSlices(
+        priority, sortedIds.size(), 4096, std::vector<string>(),
+        [&](std::size_t first, std::size_t last) {
+            std::vector<string> found;
+            for (std::size_t i = first; i < last; ++i) {
+                const Course& course = *directory.find(sortedIds[i]);
+                for (const auto& prereq : course.prerequisites) {
+                    if (!directory.find(prereq)) {
+                        found.push_back(prereq + " (referenced by " + course.courseNumber + ")");
+                    }
+                }
+            }
+            return found;
+        },
+        [](std::vector<string> all, std::vector<string> slice) {
+            all.insert(all.end(), std::make_move_iterator(slice.begin()), std::make_move_iterator(slice.end()));
+            return all;
+        });
+    std::sort(missing.begin(), missing.end());
+    missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+    return missing;
+}
+
+// Heap bytes behind one course's strings and prerequisite list.
+std::size_t courseHeapBytes(const Course& course) {
+    std::size_t bytes = heapBytes(course.courseNumber) + heapBytes(course.courseName);
+    bytes += course.prerequisites.capacity() * sizeof(string);
+    for (const auto& prereq : course.prerequisites) {
+        bytes += heapBytes(prereq);
+    }
+    return bytes;
+}
+
+// What one course adds to a catalog under any index policy: its record, its strings, and
+// its sorted ID. A lower bound on its share of estimateFootprint(), which adds the
+// policy's own overhead on top.
+std::size_t stagedCourseBytes(const Course& course) {
+    return sizeof(Course) + courseHeapBytes(course) + sizeof(string) + heapBytes(course.courseNumber);
+}
+
+template <typename Index>
+std::size_t estimateFootprint(const Index& directory, const std::vector<string>& sortedIds) {
+    std::size_t bytes = directory.overheadBytes();
+    directory.forEach([&bytes](const Course& course) { bytes += courseHeapBytes(course); });
+    bytes += sortedIds.capacity() * sizeof(string);
+    for (const auto& id : sortedIds) {
+        bytes += heapBytes(id);
+    }
+    return bytes;
+}
+
+bool sameContent(const Course& left, const Course& right) {
+    return left.courseName == right.courseName && left.prerequisites == right.prerequisites;
+}
+
+// Sorted merge of the old and new ID lists; records present in both are compared field by field.
+template <typename Index>
+CatalogChangeSet describeChanges(const Index& before,
+                                 const std::vector<string>& beforeIds,
+                                 const Index& after,
+                                 const std::vector<string>& afterIds) {
+    CatalogChangeSet changes;
+    std::size_t b = 0;
+    std::size_t a = 0;
+    while (b < beforeIds.size() || a < afterIds.size()) {
+        if (a == afterIds.size() || (b < beforeIds.size() && beforeIds[b] < afterIds[a])) {
+            changes.removed.push_back(beforeIds[b++]);
+        } else if (b == beforeIds.size() || afterIds[a] < beforeIds[b]) {
+            changes.added.push_back(a++);
+        } else {
+            if (!sameContent(*before.find(beforeIds[b]), *after.find(afterIds[a]))) {
+                changes.changed.push_back(a);
+            }
+            ++b;
+            ++a;
+        }
+    }
+    return changes;
+}
+
+// Converts IDs that are known to be in sortedIds into ascending, unique indices.
+std::vector<std::size_t> indicesOf(std::vector<string> ids, const std::vector<string>& sortedIds) {
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    std::vector<std::size_t> indices;
+    indices.reserve(ids.size());
+    for (const auto& id : ids) {
+        indices.push_back(static_cast<std::size_t>(
+            std::lower_bound(sortedIds.begin(), sortedIds.end(), id) - sortedIds.begin()));
+    }
+    return indices;
+}
+
 }  // namespace
 
-LoadResult Catalog::load(const std::string& fileName) {
+template <typename Index>
+LoadResult BasicCatalog<Index>::load(const std::string& fileName) {
+    return load(fileName, LoadOptions());
+}
+
+template <typename Index>
+LoadResult BasicCatalog<Index>::load(const std::string& fileName, const LoadOptions& options) {
+    CATALOG_TRACE2(load__start, fileName.c_str(), static_cast<int>(options.reloadMode));
+    LoadResult result = loadFile(fileName, options);
+    CATALOG_TRACE4(load__done, fileName.c_str(), static_cast<int>(result.ok), result.courses,
+                   result.warnings.size());
+    return result;
+}
+
+template <typename Index>
+LoadResult BasicCatalog<Index>::loadFile(const std::string& fileName, const LoadOptions& options) {
     LoadResult result;
     if (fileName.empty()) {
         result.warnings.emplace_back("File name is empty.");
@@ -127,88 +430,313 @@ LoadResult Catalog::load(const std::string& fileName) {
 
     result.path = resolvedPath->string();
 
-    std::ifstream input(*resolvedPath);
-    if (!input.is_open()) {
+    const auto stampBefore = fileStamp(*resolvedPath);
+    if (stampBefore && options.skipUnchanged) {
+        if (auto reused = reuseUnchangedSource(*resolvedPath, stampBefore->first, stampBefore->second, options)) {
+            return std::move(*reused);
+        }
+    }
+
+    HashingFileBuffer fileBuffer;
+    if (!fileBuffer.open(*resolvedPath)) {
         result.warnings.emplace_back("Unable to open file: " + result.path);
         return result;
     }
+    std::istream input(&fileBuffer);
+
+    // Remembers what this load read once it is in place, unless the file moved under us.
+    const auto rememberSource = [&](const LoadResult& loaded) {
+        loadedSource.reset();
+        const auto stampAfter = fileStamp(*resolvedPath);
+        if (!loaded.ok || loaded.cancelled || !stampBefore || stampAfter != stampBefore) {
+            return;
+        }
+        const std::optional<std::uint64_t> hash = fileBuffer.contentHash(stampBefore->first);
+        if (!hash) {
+            return;
+        }
+        loadedSource = SourceFingerprint{loaded.path, stampBefore->first, stampBefore->second,
+                                         isSettled(stampBefore->second), *hash, options.format, options.header,
+                                         options.columns, options.idScheme, currentGeneration, loaded};
+    };
+
+    const InputFormat format = resolveFormat(options, *resolvedPath);
+    if (options.reloadMode == ReloadMode::InPlace && !courseDirectory.empty()) {
+        LoadResult reloaded = reloadInPlace(input, format, options, std::move(result));
+        rememberSource(reloaded);
+        return reloaded;
+    }
 
     // Build up a fresh directory so we only swap the member data once the file succeeds.
-    std::unordered_map<std::string, Course> loadedCourseDirectory;
+    CourseMap loadedCourseDirectory;
     std::vector<std::string> warnings;
 
-    std::string line;
-    std::size_t lineNumber = 0;
-    while (std::getline(input, line)) {
-        ++lineNumber;
-        line = trim(line);
-        if (line.empty()) {
-            continue;
-        }
+    // With a memory budget, staged courses are counted as they are parsed (on the pool's
+    // threads for large JSON Lines files) and the parse stops through its token as soon as
+    // they pass the budget. Replaced duplicates stop counting once they are dropped.
+    CancellationSource budgetStop(options.cancellation);
+    LoadOptions parseOptions = options;
+    std::atomic<std::size_t> stagedBytes{0};
+    std::atomic<bool> overBudget{false};
+    std::function<void(const Course&)> countStaged;
+    if (options.memoryBudget != 0) {
+        parseOptions.cancellation = budgetStop.token();
+        countStaged = [&](const Course& course) {
+            const std::size_t bytes = stagedCourseBytes(course);
+            if (stagedBytes.fetch_add(bytes) + bytes > options.memoryBudget && !overBudget.exchange(true)) {
+                budgetStop.cancel();
+            }
+        };
+    }
 
-        std::stringstream ss(line);
-        std::vector<std::string> columns;
-        std::string cell;
-        while (std::getline(ss, cell, ',')) {
-            columns.push_back(trim(cell));
-        }
+    bool cancelled = false;
+    const bool mapped = readCourses(
+        input, format, parseOptions, cancelled, warnings,
+        [&](Course& course) {
+            auto [slot, inserted] = loadedCourseDirectory.try_emplace(course.courseNumber);
+            if (!inserted) {
+                warnings.emplace_back("Replacing existing course entry for " + course.courseNumber + ".");
+                if (countStaged) {
+                    stagedBytes.fetch_sub(stagedCourseBytes(slot->second));
+                }
+            }
+            slot->second = std::move(course);
+        },
+        countStaged);
+    CATALOG_TRACE3(parse__done, fileName.c_str(), loadedCourseDirectory.size(), static_cast<int>(cancelled));
 
-        if (columns.size() < 2) {
-            warnings.emplace_back("Skipping line " + std::to_string(lineNumber) +
-                                  ": expected course ID and name.");
-            continue;
-        }
+    result.warnings.insert(result.warnings.end(), warnings.begin(), warnings.end());
+    if (!mapped) {
+        return result;
+    }
+    if (overBudget) {
+        // Like a cancellation, the partial directory is dropped and the live catalog kept.
+        result.warnings.emplace_back("Catalog passed its memory budget of " + std::to_string(options.memoryBudget) +
+                                     " bytes after about " + std::to_string(stagedBytes.load()) +
+                                     " bytes of courses; stopped reading and kept the current catalog.");
+        return result;
+    }
+    if (input.bad()) {
+        result.warnings.emplace_back("Read error in " + result.path + "; keeping the current catalog.");
+        return result;
+    }
+    if (cancelled) {
+        // The partial directory is dropped here; the live catalog was never touched.
+        result.cancelled = true;
+        result.warnings.emplace_back("Load cancelled before the end of the file.");
+        return result;
+    }
+    const std::uint64_t previousGeneration = currentGeneration;
+    LoadResult committed = commit(std::move(loadedCourseDirectory), std::move(result), options.memoryBudget,
+                                   options.priority);
+    if (currentGeneration != previousGeneration) {
+        rememberSource(committed);
+    }
+    return committed;
+}
 
-        std::string courseId = toUpper(columns[0]);
-        if (!isCourseIdValid(courseId)) {
-            warnings.emplace_back("Skipping line " + std::to_string(lineNumber) +
-                                  ": invalid course ID '" + columns[0] + "'.");
-            continue;
+template <typename Index>
+std::optional<LoadResult> BasicCatalog<Index>::reuseUnchangedSource(const std::filesystem::path& path,
+                                                                    std::uintmax_t size,
+                                                                    std::filesystem::file_time_type modified,
+                                                                    const LoadOptions& options) {
+    if (!loadedSource || loadedSource->generation != currentGeneration || loadedSource->path != path.string() ||
+        loadedSource->size != size || !sameParseOptions(*loadedSource, options)) {
+        return std::nullopt;
+    }
+    if (modified != loadedSource->modified || !loadedSource->modifiedSettled) {
+        // The stamp cannot vouch for the bytes, but hashing them is far cheaper than parsing.
+        std::uint64_t hash = 0;
+        if (!hashFileContents(path, hash) || hash != loadedSource->contentHash) {
+            return std::nullopt;
         }
+        loadedSource->modified = modified;
+        loadedSource->modifiedSettled = isSettled(modified);
+    }
 
-        Course course;
-        course.courseNumber = courseId;
-        course.courseName = columns[1];
+    LoadResult reused = loadedSource->result;
+    reused.unchanged = true;
+    return reused;
+}
 
-        std::set<std::string> seenPrereqs;
-        for (std::size_t i = 2; i < columns.size(); ++i) {
-            if (columns[i].empty()) {
-                continue;
-            }
-            std::string prereqId = toUpper(columns[i]);
-            if (!isCourseIdValid(prereqId)) {
-                warnings.emplace_back("Skipping invalid prerequisite '" + columns[i] +
-                                      "' for course " + course.courseNumber + ".");
-                continue;
+template <typename Index>
+LoadResult BasicCatalog<Index>::reloadInPlace(std::istream& input, InputFormat format,
+                                             const LoadOptions& options, LoadResult result) {
+    // First pass: only find out which live courses the file still lists. Live IDs are
+    // matched by binary search on the sorted list, so "seen" costs one bit per course, and
+    // nothing is staged. The catalog is untouched until the whole file has been read.
+    const std::size_t liveCount = sortedCourseIds.size();
+    std::vector<bool> seen(liveCount, false);
+    std::size_t acceptedRows = 0;
+    std::size_t keptCount = 0;
+    std::size_t newRows = 0;
+    std::vector<string> scanWarnings;
+    bool scanCancelled = false;
+    const bool mapped = readCourses(input, format, options, scanCancelled, scanWarnings, [&](Course& course) {
+        ++acceptedRows;
+        const auto live = std::lower_bound(sortedCourseIds.begin(), sortedCourseIds.end(), course.courseNumber);
+        if (live != sortedCourseIds.end() && *live == course.courseNumber) {
+            auto bit = seen[static_cast<std::size_t>(live - sortedCourseIds.begin())];
+            keptCount += bit ? 0 : 1;
+            bit = true;
+        } else {
+            ++newRows;
+        }
+    });
+    if (!mapped || acceptedRows == 0 || scanCancelled || input.bad()) {
+        // Nothing was changed, so the live catalog is exactly as it was.
+        result.warnings.insert(result.warnings.end(), scanWarnings.begin(), scanWarnings.end());
+        result.cancelled = scanCancelled;
+        if (scanCancelled) {
+            result.warnings.emplace_back("Load cancelled before the end of the file.");
+        } else if (input.bad()) {
+            result.warnings.emplace_back("Read error in " + result.path + "; keeping the current catalog.");
+        }
+        return result;
+    }
+    scanWarnings.clear();  // The second pass reports the same rows again.
+
+    // Change tracking is skipped entirely when nobody is listening.
+    const bool trackChanges = !subscribers.entries.empty();
+    std::vector<string> changedIds;
+    std::vector<string> addedIds;
+    CatalogChangeSet changes;
+
+    // Drop the courses the new file no longer lists before anything is added, compacting the
+    // sorted list in the same pass, so their space is free for the courses that replace them.
+    std::size_t kept = 0;
+    std::vector<string> removedIds;
+    removedIds.reserve(liveCount - keptCount);
+    for (std::size_t i = 0; i < liveCount; ++i) {
+        if (!seen[i]) {
+            removedIds.push_back(std::move(sortedCourseIds[i]));
+            continue;
+        }
+        if (kept != i) {
+            sortedCourseIds[kept] = std::move(sortedCourseIds[i]);
+        }
+        ++kept;
+    }
+    sortedCourseIds.resize(kept);
+    courseDirectory.erase(removedIds);
+    if (trackChanges) {
+        changes.removed = std::move(removedIds);
+    } else {
+        std::vector<string>().swap(removedIds);
+    }
+    // One reservation for the largest catalog the file can produce, so the index grows at
+    // most once instead of per batch.
+    courseDirectory.reserve(kept + newRows);
+    sortedCourseIds.reserve(kept + newRows);
+    seen.assign(kept, false);
+
+    // Second pass: rewrite kept courses in place; new ones wait here until the stage reaches
+    // its share of the live catalog.
+    const double stagedFraction = std::max(options.maxStagedFraction, 0.0);
+    const std::size_t stageLimit = std::max<std::size_t>(
+        1, static_cast<std::size_t>(static_cast<double>(liveCount) * stagedFraction));
+    std::vector<Course> stagedCourses;
+    stagedCourses.reserve(std::min(stageLimit, newRows));
+    const auto flushStaged = [this, &stagedCourses, &result]() {
+        courseDirectory.upsert(stagedCourses, [&result](const std::string& id) {
+            result.warnings.emplace_back("Replacing existing course entry for " + id + ".");
+        });
+        stagedCourses.clear();
+    };
+
+    input.clear();
+    input.seekg(0, std::ios::beg);
+    acceptedRows = 0;
+    readCourses(input, format, options, result.cancelled, result.warnings, [&](Course& course) {
+        ++acceptedRows;
+
+        const auto live = std::lower_bound(sortedCourseIds.begin(), sortedCourseIds.end(), course.courseNumber);
+        if (live != sortedCourseIds.end() && *live == course.courseNumber) {
+            const std::size_t index = static_cast<std::size_t>(live - sortedCourseIds.begin());
+            if (seen[index]) {
+                result.warnings.emplace_back("Replacing existing course entry for " + course.courseNumber + ".");
             }
-            if (!seenPrereqs.insert(prereqId).second) {
-                warnings.emplace_back("Duplicate prerequisite '" + prereqId +
-                                      "' ignored for course " + course.courseNumber + ".");
-                continue;
+            seen[index] = true;
+
+            // Copy into the existing record so its string and vector buffers are reused.
+            Course& existing = *courseDirectory.find(course.courseNumber);
+            if (trackChanges && !sameContent(existing, course)) {
+                changedIds.push_back(course.courseNumber);
             }
-            course.prerequisites.push_back(std::move(prereqId));
+            existing.courseName.assign(course.courseName);
+            existing.prerequisites.assign(course.prerequisites.begin(), course.prerequisites.end());
+            return;
         }
 
-        if (auto existing = loadedCourseDirectory.find(course.courseNumber); existing != loadedCourseDirectory.end()) {
-            warnings.emplace_back("Replacing existing course entry for " + course.courseNumber + ".");
+        stagedCourses.push_back(std::move(course));
+        if (stagedCourses.size() >= stageLimit) {
+            flushStaged();
         }
+    });
+    CATALOG_TRACE3(parse__done, result.path.c_str(), acceptedRows, static_cast<int>(result.cancelled));
+    flushStaged();
+
+    // The removals above followed the complete first pass; only the rows after the point
+    // where the second pass stopped are missing.
+    if (result.cancelled) {
+        result.warnings.emplace_back("Reload cancelled before the end of the file; "
+                                     "the catalog is only partially updated.");
+    } else if (input.bad()) {
+        result.warnings.emplace_back("Read error part-way through " + result.path +
+                                     "; the catalog is only partially updated.");
+    }
 
-        loadedCourseDirectory[course.courseNumber] = std::move(course);
+    // Courses added by this reload are the only IDs missing from the compacted list.
+    if (courseDirectory.size() > kept) {
+        const std::size_t previousEnd = sortedCourseIds.size();
+        courseDirectory.forEach([&](const Course& course) {
+            const string& id = course.courseNumber;
+            if (!std::binary_search(sortedCourseIds.begin(), sortedCourseIds.begin() + previousEnd, id)) {
+                sortedCourseIds.push_back(id);
+                if (trackChanges) {
+                    addedIds.push_back(id);
+                }
+            }
+        });
+        std::sort(sortedCourseIds.begin() + previousEnd, sortedCourseIds.end());
+        std::inplace_merge(sortedCourseIds.begin(), sortedCourseIds.begin() + previousEnd, sortedCourseIds.end());
     }
 
-    if (loadedCourseDirectory.empty()) {
-        result.warnings.insert(result.warnings.end(), warnings.begin(), warnings.end());
-        return result;
+    result.ok = true;
+    result.courses = courseDirectory.size();
+    result.missingPrerequisites = collectMissingPrerequisites(courseDirectory, sortedCourseIds, options.priority);
+
+    if (trackChanges) {
+        changes.added = indicesOf(std::move(addedIds), sortedCourseIds);
+        changes.changed = indicesOf(std::move(changedIds), sortedCourseIds);
     }
+    publishChanges(std::move(changes));
+    return result;
+}
 
-    // Capture prerequisites that refer to courses missing from the loaded catalog.
-    std::set<std::string> missingSet;
-    for (const auto& [courseId, course] : loadedCourseDirectory) {
-        for (const auto& prereq : course.prerequisites) {
-            if (loadedCourseDirectory.find(prereq) == loadedCourseDirectory.end()) {
-                missingSet.insert(prereq + " (referenced by " + courseId + ")");
-            }
+template <typename Index>
+LoadResult BasicCatalog<Index>::build(std::vector<Course> courses, const std::string& sourceLabel) {
+    LoadResult result;
+    result.path = sourceLabel;
+
+    CourseMap builtCourseDirectory;
+    builtCourseDirectory.reserve(courses.size());
+    for (auto& course : courses) {
+        auto [slot, inserted] = builtCourseDirectory.try_emplace(course.courseNumber);
+        if (!inserted) {
+            result.warnings.emplace_back("Replacing existing course entry for " + course.courseNumber + ".");
         }
+        slot->second = std::move(course);
+    }
+
+    return commit(std::move(builtCourseDirectory), std::move(result));
+}
+
+template <typename Index>
+LoadResult BasicCatalog<Index>::commit(CourseMap loadedCourseDirectory, LoadResult result,
+                                      std::size_t memoryBudget, TaskPriority priority) {
+    if (loadedCourseDirectory.empty()) {
+        return result;
     }
 
     // Build the sorted course list once so lookups and listings stay fast.
@@ -218,26 +746,100 @@ LoadResult Catalog::load(const std::string& fileName) {
         sortedIds.push_back(entry.first);
     }
     std::sort(sortedIds.begin(), sortedIds.end());
+    Index loadedIndex = Index::adopt(std::move(loadedCourseDirectory), sortedIds);
+    CATALOG_TRACE1(index__done, sortedIds.size());
+
+    if (memoryBudget != 0) {
+        const std::size_t footprint = estimateFootprint(loadedIndex, sortedIds);
+        if (footprint > memoryBudget) {
+            result.warnings.emplace_back("Catalog needs about " + std::to_string(footprint) +
+                                         " bytes, over its memory budget of " + std::to_string(memoryBudget) +
+                                         " bytes; keeping the current catalog.");
+            return result;
+        }
+    }
 
     result.ok = true;
-    result.courses = loadedCourseDirectory.size();
-    result.missingPrerequisites.assign(missingSet.begin(), missingSet.end());
-    result.warnings.insert(result.warnings.end(), warnings.begin(), warnings.end());
+    result.courses = loadedIndex.size();
+    // Capture prerequisites that refer to courses missing from the loaded catalog.
+    result.missingPrerequisites = collectMissingPrerequisites(loadedIndex, sortedIds, priority);
+
+    CatalogChangeSet changes;
+    if (!subscribers.entries.empty()) {
+        changes = describeChanges(courseDirectory, sortedCourseIds, loadedIndex, sortedIds);
+    }
 
-    courseDirectory = std::move(loadedCourseDirectory);
-    sortedCourseIds = std::move(sortedIds);
+    // Swap the new data in, then hand the previous generation to the reclaimer so
+    // freeing a large catalog does not add to reload latency.
+    std::swap(courseDirectory, loadedIndex);
+    sortedCourseIds.swap(sortedIds);
+    if (loadedIndex.size() >= kDeferredReclaimThreshold) {
+        CatalogReclaimer::instance().retire(std::move(loadedIndex));
+        CatalogReclaimer::instance().retire(std::move(sortedIds));
+    }
 
+    publishChanges(std::move(changes));
     return result;
 }
 
-const Course* Catalog::get(const std::string& id) const {
-    const auto it = courseDirectory.find(id);
-    if (it == courseDirectory.end()) {
-        return nullptr;
+template <typename Index>
+void BasicCatalog<Index>::publishChanges(CatalogChangeSet changes) {
+    changes.generation = ++currentGeneration;
+    CATALOG_TRACE1(swap__done, currentGeneration);
+    // Iterate over a copy so a callback may subscribe or unsubscribe without invalidating the loop.
+    const auto listeners = subscribers.entries;
+    for (const auto& [id, subscriber] : listeners) {
+        subscriber(changes);
     }
-    return &it->second;
 }
 
-std::vector<std::string> Catalog::ids() const {
+template <typename Index>
+const Course* BasicCatalog<Index>::get(const std::string& id) const {
+    const Course* course = courseDirectory.find(id);
+    CATALOG_TRACE2(lookup, id.c_str(), static_cast<int>(course != nullptr));
+    return course;
+}
+
+template <typename Index>
+std::vector<std::string> BasicCatalog<Index>::ids() const {
+    return sortedCourseIds;
+}
+
+template <typename Index>
+const std::vector<std::string>& BasicCatalog<Index>::sortedIds() const {
     return sortedCourseIds;
 }
+
+template <typename Index>
+std::size_t BasicCatalog<Index>::size() const {
+    return courseDirectory.size();
+}
+
+template <typename Index>
+std::size_t BasicCatalog<Index>::memoryFootprint() const {
+    return estimateFootprint(courseDirectory, sortedCourseIds);
+}
+
+template <typename Index>
+std::uint64_t BasicCatalog<Index>::generation() const {
+    return currentGeneration;
+}
+
+template <typename Index>
+typename BasicCatalog<Index>::SubscriptionId BasicCatalog<Index>::subscribe(CatalogSubscriber subscriber) {
+    const SubscriptionId id = subscribers.nextId++;
+    subscribers.entries.emplace_back(id, std::move(subscriber));
+    return id;
+}
+
+template <typename Index>
+void BasicCatalog<Index>::unsubscribe(SubscriptionId id) {
+    auto& entries = subscribers.entries;
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [id](const auto& entry) { return entry.first == id; }),
+                  entries.end());
+}
+
+template class BasicCatalog<FlatHashIndex>;
+template class BasicCatalog<HashIndex>;
+template class BasicCatalog<SortedIndex>;
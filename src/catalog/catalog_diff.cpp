@@ -0,0 +1,104 @@
+#include "catalog/catalog_diff.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+// Returns a sorted copy so prerequisite lists can be merged without caring about CSV order.
+std::vector<std::string> sortedCopy(const std::vector<std::string>& values) {
+    std::vector<std::string> copy = values;
+    std::sort(copy.begin(), copy.end());
+    return copy;
+}
+
+/**
+ * Builds the entry for a course present in both catalogs. Returns false when the
+ * course is identical so the caller can skip storing it.
+ */
+bool compareCourse(const Course& before, const Course& after, CourseDiffEntry& entry) {
+    const std::vector<std::string> beforePrereqs = sortedCopy(before.prerequisites);
+    const std::vector<std::string> afterPrereqs = sortedCopy(after.prerequisites);
+
+    std::set_difference(afterPrereqs.begin(), afterPrereqs.end(),
+                        beforePrereqs.begin(), beforePrereqs.end(),
+                        std::back_inserter(entry.addedPrerequisites));
+    std::set_difference(beforePrereqs.begin(), beforePrereqs.end(),
+                        afterPrereqs.begin(), afterPrereqs.end(),
+                        std::back_inserter(entry.removedPrerequisites));
+
+    if (before.courseName == after.courseName && entry.addedPrerequisites.empty() &&
+        entry.removedPrerequisites.empty()) {
+        return false;
+    }
+
+    std::set_intersection(beforePrereqs.begin(), beforePrereqs.end(),
+                          afterPrereqs.begin(), afterPrereqs.end(),
+                          std::back_inserter(entry.keptPrerequisites));
+    entry.kind = CourseChangeKind::Changed;
+    entry.courseNumber = after.courseNumber;
+    entry.beforeName = before.courseName;
+    entry.afterName = after.courseName;
+    return true;
+}
+
+}  // namespace
+
+CatalogDiff diffCatalogs(const Catalog& before, const Catalog& after,
+                         const CancellationToken& cancellation) {
+    CatalogDiff diff;
+    const std::vector<std::string>& beforeIds = before.sortedIds();
+    const std::vector<std::string>& afterIds = after.sortedIds();
+
+    // Both ID lists are already sorted, so one merge walk classifies every course.
+    CancellationCheckpoint checkpoint(cancellation);
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < beforeIds.size() || j < afterIds.size()) {
+        if (checkpoint.shouldStop()) {
+            diff.cancelled = true;
+            break;
+        }
+
+        const bool takeBefore = j == afterIds.size() ||
+                                (i < beforeIds.size() && beforeIds[i] < afterIds[j]);
+        const bool takeAfter = i == beforeIds.size() ||
+                               (j < afterIds.size() && afterIds[j] < beforeIds[i]);
+
+        if (takeBefore) {
+            const Course* course = before.get(beforeIds[i++]);
+            CourseDiffEntry entry;
+            entry.kind = CourseChangeKind::Removed;
+            entry.courseNumber = course->courseNumber;
+            entry.beforeName = course->courseName;
+            entry.removedPrerequisites = course->prerequisites;
+            diff.entries.push_back(std::move(entry));
+            ++diff.removed;
+            continue;
+        }
+
+        if (takeAfter) {
+            const Course* course = after.get(afterIds[j++]);
+            CourseDiffEntry entry;
+            entry.kind = CourseChangeKind::Added;
+            entry.courseNumber = course->courseNumber;
+            entry.afterName = course->courseName;
+            entry.addedPrerequisites = course->prerequisites;
+            diff.entries.push_back(std::move(entry));
+            ++diff.added;
+            continue;
+        }
+
+        CourseDiffEntry entry;
+        if (compareCourse(*before.get(beforeIds[i]), *after.get(afterIds[j]), entry)) {
+            diff.entries.push_back(std::move(entry));
+            ++diff.changed;
+        } else {
+            ++diff.unchanged;
+        }
+        ++i;
+        ++j;
+    }
+
+    return diff;
+}
@@ -0,0 +1,185 @@
+#include "catalog/catalog_index.hpp"
+
+#include <algorithm>
+#include <string_view>
+#include <unordered_set>
+
+namespace {
+
+using std::string;
+
+bool idLess(const Course& course, const string& id) {
+    return course.courseNumber < id;
+}
+
+}  // namespace
+
+FlatHashIndex FlatHashIndex::adopt(CourseMap&& staged, const std::vector<string>&) {
+    FlatHashIndex index;
+    index.courses = std::move(staged);
+    return index;
+}
+
+const Course* FlatHashIndex::find(const string& id) const {
+    const auto it = courses.find(id);
+    return it == courses.end() ? nullptr : &it->second;
+}
+
+Course* FlatHashIndex::find(const string& id) {
+    const auto it = courses.find(id);
+    return it == courses.end() ? nullptr : &it->second;
+}
+
+void FlatHashIndex::upsert(std::vector<Course>& batch, const ReplaceCallback& onReplace) {
+    courses.reserve(courses.size() + batch.size());
+    for (auto& course : batch) {
+        auto [slot, inserted] = courses.try_emplace(course.courseNumber);
+        if (!inserted) {
+            onReplace(course.courseNumber);
+        }
+        slot->second = std::move(course);
+    }
+}
+
+void FlatHashIndex::erase(const std::vector<string>& sortedIds) {
+    for (const auto& id : sortedIds) {
+        courses.erase(id);
+    }
+}
+
+std::size_t FlatHashIndex::overheadBytes() const {
+    // One control byte per slot plus the mirrored tail group; slots are paid for even when empty.
+    std::size_t bytes = courses.capacity() * (sizeof(CourseMap::value_type) + 1) + 16;
+    for (const auto& entry : courses) {
+        bytes += heapBytes(entry.first);
+    }
+    return bytes;
+}
+
+HashIndex HashIndex::adopt(CourseMap&& staged, const std::vector<string>&) {
+    HashIndex index;
+    index.courses.reserve(staged.size());
+    for (auto& entry : staged) {
+        index.courses.emplace(std::move(entry));
+    }
+    return index;
+}
+
+const Course* HashIndex::find(const string& id) const {
+    const auto it = courses.find(id);
+    return it == courses.end() ? nullptr : &it->second;
+}
+
+Course* HashIndex::find(const string& id) {
+    const auto it = courses.find(id);
+    return it == courses.end() ? nullptr : &it->second;
+}
+
+void HashIndex::upsert(std::vector<Course>& batch, const ReplaceCallback& onReplace) {
+    courses.reserve(courses.size() + batch.size());
+    for (auto& course : batch) {
+        auto [slot, inserted] = courses.try_emplace(course.courseNumber);
+        if (!inserted) {
+            onReplace(course.courseNumber);
+        }
+        slot->second = std::move(course);
+    }
+}
+
+void HashIndex::erase(const std::vector<string>& sortedIds) {
+    for (const auto& id : sortedIds) {
+        courses.erase(id);
+    }
+}
+
+std::size_t HashIndex::overheadBytes() const {
+    // Each node holds the key/value pair plus a next pointer and the cached hash.
+    constexpr std::size_t kNodeBytes = sizeof(std::pair<const string, Course>) + 2 * sizeof(void*);
+    std::size_t bytes = courses.bucket_count() * sizeof(void*) + courses.size() * kNodeBytes;
+    for (const auto& entry : courses) {
+        bytes += heapBytes(entry.first);
+    }
+    return bytes;
+}
+
+SortedIndex SortedIndex::adopt(CourseMap&& staged, const std::vector<string>& sortedIds) {
+    SortedIndex index;
+    index.courses.reserve(sortedIds.size());
+    for (const auto& id : sortedIds) {
+        index.courses.push_back(std::move(staged.find(id)->second));
+    }
+    return index;
+}
+
+const Course* SortedIndex::find(const string& id) const {
+    const auto it = std::lower_bound(courses.begin(), courses.end(), id, idLess);
+    return it == courses.end() || it->courseNumber != id ? nullptr : &*it;
+}
+
+Course* SortedIndex::find(const string& id) {
+    const auto it = std::lower_bound(courses.begin(), courses.end(), id, idLess);
+    return it == courses.end() || it->courseNumber != id ? nullptr : &*it;
+}
+
+void SortedIndex::upsert(std::vector<Course>& batch, const ReplaceCallback& onReplace) {
+    // Report replacements in batch order before anything moves.
+    std::unordered_set<std::string_view> seenInBatch;
+    seenInBatch.reserve(batch.size());
+    for (const auto& course : batch) {
+        if (!seenInBatch.insert(course.courseNumber).second || find(course.courseNumber)) {
+            onReplace(course.courseNumber);
+        }
+    }
+    seenInBatch.clear();
+
+    // Keep the last entry per ID, then overwrite the IDs that already exist.
+    std::stable_sort(batch.begin(), batch.end(),
+                     [](const Course& left, const Course& right) { return left.courseNumber < right.courseNumber; });
+    std::vector<Course> added;
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        if (i + 1 < batch.size() && batch[i + 1].courseNumber == batch[i].courseNumber) {
+            continue;
+        }
+        if (Course* existing = find(batch[i].courseNumber)) {
+            *existing = std::move(batch[i]);
+        } else {
+            added.push_back(std::move(batch[i]));
+        }
+    }
+    if (added.empty()) {
+        return;
+    }
+
+    // Merge the new IDs in from the back so the array only grows once.
+    std::size_t from = courses.size();
+    std::size_t pending = added.size();
+    courses.resize(courses.size() + added.size());
+    std::size_t to = courses.size();
+    while (pending > 0) {
+        if (from > 0 && courses[from - 1].courseNumber > added[pending - 1].courseNumber) {
+            courses[--to] = std::move(courses[--from]);
+        } else {
+            courses[--to] = std::move(added[--pending]);
+        }
+    }
+}
+
+void SortedIndex::erase(const std::vector<string>& sortedIds) {
+    std::size_t kept = 0;
+    std::size_t r = 0;
+    for (std::size_t i = 0; i < courses.size(); ++i) {
+        if (r < sortedIds.size() && courses[i].courseNumber == sortedIds[r]) {
+            ++r;
+            continue;
+        }
+        if (kept != i) {
+            courses[kept] = std::move(courses[i]);
+        }
+        ++kept;
+    }
+    courses.resize(kept);
+}
+
+std::size_t SortedIndex::overheadBytes() const {
+    return courses.capacity() * sizeof(Course);
+}
@@ -0,0 +1,165 @@
+#include "catalog/catalog_merge.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <unordered_set>
+
+namespace {
+
+// A source plus its read position in the sorted ID list.
+struct MergeCursor {
+    const MergeSource* source = nullptr;
+    const std::vector<std::string>* ids = nullptr;
+    std::size_t position = 0;
+
+    bool done() const { return position >= ids->size(); }
+    const std::string& current() const { return (*ids)[position]; }
+};
+
+// One definition of the course currently being merged, in priority order.
+struct Definition {
+    const MergeSource* source = nullptr;
+    const Course* course = nullptr;
+};
+
+// Picks the title according to the name precedence rule.
+const Definition& chooseName(const std::vector<Definition>& definitions, NamePrecedence precedence) {
+    if (precedence == NamePrecedence::FirstNonEmpty) {
+        for (const auto& definition : definitions) {
+            if (!definition.course->courseName.empty()) {
+                return definition;
+            }
+        }
+    }
+    return definitions.front();
+}
+
+// Builds the prerequisite list according to the prerequisite merge rule.
+std::vector<std::string> mergePrerequisites(const std::vector<Definition>& definitions,
+                                            PrerequisiteMerge mode) {
+    if (mode == PrerequisiteMerge::Union) {
+        std::vector<std::string> merged;
+        std::unordered_set<std::string> seen;
+        for (const auto& definition : definitions) {
+            for (const auto& prereq : definition.course->prerequisites) {
+                if (seen.insert(prereq).second) {
+                    merged.push_back(prereq);
+                }
+            }
+        }
+        return merged;
+    }
+
+    if (mode == PrerequisiteMerge::ReplaceUnlessEmpty) {
+        for (const auto& definition : definitions) {
+            if (!definition.course->prerequisites.empty()) {
+                return definition.course->prerequisites;
+            }
+        }
+    }
+    return definitions.front().course->prerequisites;
+}
+
+}  // namespace
+
+LoadResult mergeCatalogs(const std::vector<MergeSource>& sources,
+                         const MergePolicy& policy,
+                         Catalog& target,
+                         const CancellationToken& cancellation) {
+    // Rank sources once: higher priority first, later-listed first on ties.
+    std::vector<std::size_t> order(sources.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&sources](std::size_t lhs, std::size_t rhs) {
+        if (sources[lhs].priority != sources[rhs].priority) {
+            return sources[lhs].priority > sources[rhs].priority;
+        }
+        return lhs > rhs;
+    });
+
+    std::vector<MergeCursor> cursors;
+    std::string label;
+    std::size_t expectedCourses = 0;
+    for (std::size_t index : order) {
+        const MergeSource& source = sources[index];
+        if (!source.catalog) {
+            continue;
+        }
+        cursors.push_back({&source, &source.catalog->sortedIds(), 0});
+        expectedCourses = std::max(expectedCourses, source.catalog->size());
+        label += (label.empty() ? "" : " + ") + source.label;
+    }
+
+    std::vector<Course> merged;
+    merged.reserve(expectedCourses);
+    std::vector<std::string> conflicts;
+    std::vector<Definition> definitions;
+
+    // K-way merge over the already-sorted ID lists; every course is visited exactly once.
+    CancellationCheckpoint checkpoint(cancellation);
+    while (true) {
+        if (checkpoint.shouldStop()) {
+            LoadResult result;
+            result.path = label;
+            result.cancelled = true;
+            result.warnings.emplace_back("Merge cancelled; the catalog was not changed.");
+            return result;
+        }
+
+        const std::string* smallest = nullptr;
+        for (const auto& cursor : cursors) {
+            if (!cursor.done() && (!smallest || cursor.current() < *smallest)) {
+                smallest = &cursor.current();
+            }
+        }
+        if (!smallest) {
+            break;
+        }
+
+        const std::string courseId = *smallest;
+        definitions.clear();
+        for (auto& cursor : cursors) {
+            if (!cursor.done() && cursor.current() == courseId) {
+                definitions.push_back({cursor.source, cursor.source->catalog->get(courseId)});
+                ++cursor.position;
+            }
+        }
+
+        const Definition& nameSource = chooseName(definitions, policy.namePrecedence);
+        Course course;
+        course.courseNumber = courseId;
+        course.courseName = nameSource.course->courseName;
+        course.prerequisites = mergePrerequisites(definitions, policy.prerequisites);
+
+        if (policy.reportConflicts && definitions.size() > 1) {
+            for (const auto& definition : definitions) {
+                if (definition.course->courseName != course.courseName) {
+                    conflicts.push_back("Title for " + courseId + " from " + nameSource.source->label +
+                                        " overrides " + definition.source->label + ".");
+                }
+            }
+            if (policy.prerequisites != PrerequisiteMerge::Union) {
+                for (const auto& definition : definitions) {
+                    if (definition.course->prerequisites != course.prerequisites) {
+                        conflicts.push_back("Prerequisites for " + courseId + " from " +
+                                            definition.source->label + " were replaced.");
+                    }
+                }
+            }
+        }
+
+        merged.push_back(std::move(course));
+    }
+
+    if (merged.empty()) {
+        LoadResult result;
+        result.path = label;
+        result.warnings.emplace_back("No courses to merge.");
+        return result;
+    }
+
+    LoadResult result = target.build(std::move(merged), label);
+    result.warnings.insert(result.warnings.end(), conflicts.begin(), conflicts.end());
+    return result;
+}
@@ -0,0 +1,264 @@
+#include "catalog/catalog_report.hpp"
+
+#include <algorithm>
+#include <ostream>
+#include <string>
+
+namespace {
+
+using std::string;
+
+constexpr std::uint32_t kNoHandle = UINT32_MAX;
+
+/**
+ * Iterative Tarjan over edges course -> prerequisite. Components come out prerequisites
+ * first, which is exactly the order closures have to be computed in.
+ */
+std::vector<std::vector<std::uint32_t>> stronglyConnected(const CourseGraph& graph) {
+    const std::size_t count = graph.size();
+    std::vector<std::uint32_t> index(count, kNoHandle);
+    std::vector<std::uint32_t> lowLink(count, 0);
+    std::vector<bool> onStack(count, false);
+    std::vector<std::uint32_t> stack;
+    std::vector<std::pair<std::uint32_t, std::size_t>> frames;  // Node and next edge to visit.
+    std::vector<std::vector<std::uint32_t>> components;
+    std::uint32_t nextIndex = 0;
+
+    for (std::uint32_t root = 0; root < count; ++root) {
+        if (index[root] != kNoHandle) {
+            continue;
+        }
+        frames.emplace_back(root, 0);
+        index[root] = lowLink[root] = nextIndex++;
+        stack.push_back(root);
+        onStack[root] = true;
+
+        while (!frames.empty()) {
+            auto& [node, edge] = frames.back();
+            const auto edges = graph.prerequisites(node);
+            if (edge < edges.size()) {
+                const std::uint32_t next = edges[edge++];
+                if (next == CourseGraph::kMissing) {
+                    continue;
+                }
+                if (index[next] == kNoHandle) {
+                    index[next] = lowLink[next] = nextIndex++;
+                    stack.push_back(next);
+                    onStack[next] = true;
+                    frames.emplace_back(next, 0);
+                } else if (onStack[next]) {
+                    lowLink[node] = std::min(lowLink[node], index[next]);
+                }
+                continue;
+            }
+
+            const std::uint32_t finished = node;
+            frames.pop_back();
+            if (!frames.empty()) {
+                lowLink[frames.back().first] = std::min(lowLink[frames.back().first], lowLink[finished]);
+            }
+            if (lowLink[finished] == index[finished]) {
+                std::vector<std::uint32_t> component;
+                std::uint32_t member;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    onStack[member] = false;
+                    component.push_back(member);
+                } while (member != finished);
+                components.push_back(std::move(component));
+            }
+        }
+    }
+    return components;
+}
+
+void appendSection(string& out, const CourseGraph& graph, const PrerequisiteClosures& closures,
+                   std::size_t handle) {
+    const Course& course = graph.course(handle);
+    out += course.courseNumber;
+    out += ", ";
+    out += course.courseName;
+    out += '\n';
+
+    if (course.prerequisites.empty()) {
+        out += "  Prerequisites: none\n\n";
+        return;
+    }
+    out += "  Direct prerequisites:\n";
+    const auto prereqHandles = graph.prerequisites(handle);
+    for (std::size_t p = 0; p < prereqHandles.size(); ++p) {
+        out += "    ";
+        out += course.prerequisites[p];
+        if (prereqHandles[p] == CourseGraph::kMissing) {
+            out += " - (missing from catalog)";
+        } else {
+            out += " - ";
+            out += graph.course(prereqHandles[p]).courseName;
+        }
+        out += '\n';
+    }
+
+    const auto& all = closures.of(handle);
+    out += "  All prerequisites (";
+    out += std::to_string(all.size());
+    out += "):\n";
+    for (const std::uint32_t prereqHandle : all) {
+        const Course& prereq = graph.course(prereqHandle);
+        out += "    ";
+        out += prereq.courseNumber;
+        out += " - ";
+        out += prereq.courseName;
+        out += '\n';
+    }
+    if (closures.cyclic[handle]) {
+        out += "  Note: this course is part of a prerequisite cycle.\n";
+    }
+    out += '\n';
+}
+
+}  // namespace
+
+PrerequisiteClosures computePrerequisiteClosures(const Catalog& catalog, TaskPriority priority,
+                                                 const CancellationToken& cancellation) {
+    CourseGraph graph;
+    graph.build(catalog, priority);
+    return computePrerequisiteClosures(graph, priority, cancellation);
+}
+
+PrerequisiteClosures computePrerequisiteClosures(const CourseGraph& graph, TaskPriority priority,
+                                                 const CancellationToken& cancellation) {
+    PrerequisiteClosures result;
+    const std::size_t count = graph.size();
+    WorkerPool& pool = WorkerPool::shared();
+    if (cancellation.stopRequested()) {
+        result.cancelled = true;
+        return result;
+    }
+
+    const std::vector<std::vector<std::uint32_t>> components = stronglyConnected(graph);
+    result.componentOf.assign(count, 0);
+    result.cyclic.assign(count, false);
+    for (std::uint32_t c = 0; c < components.size(); ++c) {
+        const auto& members = components[c];
+        const bool selfLoop = members.size() == 1 && (graph.hot(members[0]).flags & CourseGraph::kSelfPrerequisite) != 0;
+        for (const std::uint32_t member : members) {
+            result.componentOf[member] = c;
+            result.cyclic[member] = members.size() > 1 || selfLoop;
+        }
+    }
+
+    // A component's level is one past its deepest prerequisite, so each level only reads
+    // closures finished by earlier levels.
+    std::vector<std::size_t> levelOf(components.size(), 0);
+    std::vector<std::vector<std::uint32_t>> byLevel;
+    for (std::uint32_t c = 0; c < components.size(); ++c) {
+        std::size_t level = 0;
+        for (const std::uint32_t member : components[c]) {
+            for (const std::uint32_t target : graph.prerequisites(member)) {
+                if (target == CourseGraph::kMissing) {
+                    continue;
+                }
+                const std::uint32_t targetComponent = result.componentOf[target];
+                if (targetComponent != c) {
+                    level = std::max(level, levelOf[targetComponent] + 1);
+                }
+            }
+        }
+        levelOf[c] = level;
+        if (byLevel.size() <= level) {
+            byLevel.resize(level + 1);
+        }
+        byLevel[level].push_back(c);
+    }
+    result.levels = byLevel.size();
+
+    result.closures.resize(components.size());
+    for (const auto& level : byLevel) {
+        if (cancellation.stopRequested()) {
+            result.cancelled = true;
+            return result;
+        }
+        pool.forEachSlice(priority, level.size(), 64, [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                const std::uint32_t c = level[i];
+                std::vector<std::uint32_t> closure;
+                for (const std::uint32_t member : components[c]) {
+                    if (result.cyclic[member]) {
+                        closure.push_back(member);
+                    }
+                    for (const std::uint32_t target : graph.prerequisites(member)) {
+                        if (target == CourseGraph::kMissing) {
+                            continue;
+                        }
+                        const std::uint32_t targetComponent = result.componentOf[target];
+                        if (targetComponent == c) {
+                            continue;
+                        }
+                        closure.push_back(target);
+                        const auto& inherited = result.closures[targetComponent];
+                        closure.insert(closure.end(), inherited.begin(), inherited.end());
+                    }
+                }
+                std::sort(closure.begin(), closure.end());
+                closure.erase(std::unique(closure.begin(), closure.end()), closure.end());
+                closure.shrink_to_fit();
+                result.closures[c] = std::move(closure);
+            }
+        });
+    }
+    return result;
+}
+
+CatalogReportResult writeCatalogReport(const Catalog& catalog, std::ostream& out,
+                                       const CatalogReportOptions& options) {
+    CatalogReportResult result;
+    CourseGraph graph;
+    graph.build(catalog, options.priority);
+    const PrerequisiteClosures closures = computePrerequisiteClosures(graph, options.priority, options.cancellation);
+    if (closures.cancelled) {
+        result.cancelled = true;
+        return result;
+    }
+    result.cyclicCourses = static_cast<std::size_t>(std::count(closures.cyclic.begin(), closures.cyclic.end(), true));
+
+    WorkerPool& pool = WorkerPool::shared();
+    const std::size_t count = graph.size();
+    const std::size_t perChunk = std::max<std::size_t>(options.coursesPerChunk, 1);
+    const std::size_t chunkCount = (count + perChunk - 1) / perChunk;
+    // A few chunks per worker keeps everyone busy while the previous window is written.
+    const std::size_t window = std::max<std::size_t>(pool.size(), 1) * 4;
+
+    std::vector<string> formatted(std::min(window, chunkCount));
+    for (std::size_t windowStart = 0; windowStart < chunkCount; windowStart += window) {
+        if (options.cancellation.stopRequested()) {
+            result.cancelled = true;
+            return result;
+        }
+        const std::size_t windowChunks = std::min(window, chunkCount - windowStart);
+        pool.forEachSlice(options.priority, windowChunks, 1, [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                string& text = formatted[i];
+                text.clear();
+                const std::size_t begin = (windowStart + i) * perChunk;
+                const std::size_t end = std::min(begin + perChunk, count);
+                for (std::size_t handle = begin; handle < end; ++handle) {
+                    appendSection(text, graph, closures, handle);
+                }
+            }
+        });
+
+        for (std::size_t i = 0; i < windowChunks; ++i) {
+            out.write(formatted[i].data(), static_cast<std::streamsize>(formatted[i].size()));
+            result.bytesWritten += formatted[i].size();
+        }
+        result.courses = std::min((windowStart + windowChunks) * perChunk, count);
+        if (!out) {
+            return result;
+        }
+    }
+
+    out.flush();
+    result.ok = static_cast<bool>(out);
+    return result;
+}
@@ -0,0 +1,134 @@
+#include "catalog/content_hash.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+constexpr std::uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr std::uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr std::uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr std::uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+// hashFileContents reads this much at a time.
+constexpr std::size_t kFileChunkBytes = 1 << 20;
+
+// Native byte order: hashes are compared within one process, never stored or shipped.
+std::uint64_t read64(const unsigned char* data) {
+    std::uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+std::uint32_t read32(const unsigned char* data) {
+    std::uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+std::uint64_t mixLane(std::uint64_t lane, std::uint64_t input) {
+    lane += input * kPrime2;
+    return std::rotl(lane, 31) * kPrime1;
+}
+
+std::uint64_t mergeLane(std::uint64_t hash, std::uint64_t lane) {
+    hash ^= mixLane(0, lane);
+    return hash * kPrime1 + kPrime4;
+}
+
+// Consumes whole 32-byte stripes and returns how many bytes that was.
+std::size_t consumeStripes(std::array<std::uint64_t, 4>& lanes, const unsigned char* data, std::size_t size) {
+    std::size_t offset = 0;
+    for (; offset + 32 <= size; offset += 32) {
+        lanes[0] = mixLane(lanes[0], read64(data + offset));
+        lanes[1] = mixLane(lanes[1], read64(data + offset + 8));
+        lanes[2] = mixLane(lanes[2], read64(data + offset + 16));
+        lanes[3] = mixLane(lanes[3], read64(data + offset + 24));
+    }
+    return offset;
+}
+
+}  // namespace
+
+ContentHasher::ContentHasher()
+    : lanes{kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1} {}
+
+void ContentHasher::update(const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    totalBytes += size;
+
+    if (pendingBytes != 0) {
+        const std::size_t fill = std::min(size, pending.size() - pendingBytes);
+        std::memcpy(pending.data() + pendingBytes, bytes, fill);
+        pendingBytes += fill;
+        bytes += fill;
+        size -= fill;
+        if (pendingBytes < pending.size()) {
+            return;
+        }
+        consumeStripes(lanes, pending.data(), pending.size());
+        pendingBytes = 0;
+    }
+
+    const std::size_t consumed = consumeStripes(lanes, bytes, size);
+    pendingBytes = size - consumed;
+    std::memcpy(pending.data(), bytes + consumed, pendingBytes);
+}
+
+std::uint64_t ContentHasher::digest() const {
+    std::uint64_t hash;
+    if (totalBytes >= 32) {
+        hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+        for (const std::uint64_t lane : lanes) {
+            hash = mergeLane(hash, lane);
+        }
+    } else {
+        hash = lanes[2] + kPrime5;  // The seed.
+    }
+    hash += totalBytes;
+
+    const unsigned char* tail = pending.data();
+    std::size_t left = pendingBytes;
+    for (; left >= 8; tail += 8, left -= 8) {
+        hash ^= mixLane(0, read64(tail));
+        hash = std::rotl(hash, 27) * kPrime1 + kPrime4;
+    }
+    if (left >= 4) {
+        hash ^= static_cast<std::uint64_t>(read32(tail)) * kPrime1;
+        hash = std::rotl(hash, 23) * kPrime2 + kPrime3;
+        tail += 4;
+        left -= 4;
+    }
+    for (; left > 0; ++tail, --left) {
+        hash ^= *tail * kPrime5;
+        hash = std::rotl(hash, 11) * kPrime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+bool hashFileContents(const std::filesystem::path& path, std::uint64_t& hash) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        return false;
+    }
+    ContentHasher hasher;
+    std::vector<char> chunk(kFileChunkBytes);
+    while (input.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || input.gcount() > 0) {
+        hasher.update(chunk.data(), static_cast<std::size_t>(input.gcount()));
+    }
+    if (input.bad()) {
+        return false;
+    }
+    hash = hasher.digest();
+    return true;
+}
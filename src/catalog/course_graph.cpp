@@ -0,0 +1,82 @@
+#include "catalog/course_graph.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// Largest count the 24-bit field holds. Loading dedupes every row's prerequisites with a
+// linear scan, so no catalog gets anywhere near it; longer lists would be cut short here.
+constexpr std::size_t kMaxPrerequisites = (std::size_t{1} << 24) - 1;
+
+}  // namespace
+
+CourseGraph::CourseGraph(std::pmr::memory_resource* memory)
+    : hotCourses(memory), prerequisiteHandles(memory), coldCourses(memory), handles(memory) {}
+
+void CourseGraph::build(const Catalog& catalog, TaskPriority priority) {
+    const std::vector<std::string>& ids = catalog.sortedIds();
+    const std::size_t count = ids.size();
+    WorkerPool& pool = WorkerPool::shared();
+
+    handles.clear();
+    handles.reserve(count);
+    for (std::size_t handle = 0; handle < count; ++handle) {
+        handles.try_emplace(std::string_view(ids[handle]), static_cast<std::uint32_t>(handle));
+    }
+
+    // First pass finds the cold records and sizes each prerequisite list.
+    hotCourses.assign(count, HotCourse{});
+    coldCourses.assign(count, nullptr);
+    pool.forEachSlice(priority, count, 4096, [&](std::size_t first, std::size_t last) {
+        for (std::size_t handle = first; handle < last; ++handle) {
+            const Course* course = catalog.get(ids[handle]);
+            coldCourses[handle] = course;
+            hotCourses[handle].prerequisiteCount =
+                static_cast<std::uint32_t>(std::min(course->prerequisites.size(), kMaxPrerequisites));
+        }
+    });
+
+    std::size_t edges = 0;
+    for (HotCourse& record : hotCourses) {
+        record.firstPrerequisite = static_cast<std::uint32_t>(edges);
+        edges += record.prerequisiteCount;
+    }
+
+    // Second pass resolves every prerequisite ID into its slot.
+    prerequisiteHandles.assign(edges, kMissing);
+    pool.forEachSlice(priority, count, 4096, [&](std::size_t first, std::size_t last) {
+        for (std::size_t handle = first; handle < last; ++handle) {
+            HotCourse& record = hotCourses[handle];
+            const std::vector<std::string>& prereqs = coldCourses[handle]->prerequisites;
+            std::uint8_t flags = 0;
+            for (std::uint32_t p = 0; p < record.prerequisiteCount; ++p) {
+                const std::uint32_t target = handleOf(prereqs[p]);
+                if (target == kMissing) {
+                    flags |= kHasMissingPrerequisite;
+                } else if (target == handle) {
+                    flags |= kSelfPrerequisite;
+                }
+                prerequisiteHandles[record.firstPrerequisite + p] = target;
+            }
+            record.flags = flags;
+        }
+    });
+
+    builtFrom = &catalog;
+    builtGeneration = catalog.generation();
+}
+
+bool CourseGraph::isCurrent(const Catalog& catalog) const {
+    return builtFrom == &catalog && builtGeneration == catalog.generation();
+}
+
+std::uint32_t CourseGraph::handleOf(std::string_view id) const {
+    const auto match = handles.find(id);
+    return match == handles.end() ? kMissing : match->second;
+}
+
+std::size_t CourseGraph::memoryFootprint() const {
+    return hotCourses.capacity() * sizeof(HotCourse) + prerequisiteHandles.capacity() * sizeof(std::uint32_t) +
+           coldCourses.capacity() * sizeof(const Course*) +
+           handles.capacity() * (sizeof(std::pair<std::string_view, std::uint32_t>) + 1);
+}
@@ -0,0 +1,331 @@
+#include "catalog/course_parser.hpp"
+
+#include "catalog/simd_scan.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+using std::string;
+using std::string_view;
+
+// Lowercased copy used when matching header names.
+string toLowerCopy(string_view text) {
+    string value(text);
+    for (char& ch : value) {
+        ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    }
+    return value;
+}
+
+/**
+ * Returns the index of the comma that ends the field starting at pos (or line.size()).
+ * Commas inside a quoted field do not count, and "" inside quotes is an escaped quote.
+ */
+std::size_t fieldEnd(string_view line, std::size_t pos) {
+    std::size_t start = pos;
+    while (start < line.size() && (line[start] == ' ' || line[start] == '\t')) {
+        ++start;
+    }
+
+    std::size_t searchFrom = pos;
+    if (start < line.size() && line[start] == '"') {
+        std::size_t i = start + 1;
+        while (true) {
+            const std::size_t quote = line.find('"', i);
+            if (quote == string_view::npos) {
+                return line.size();  // An unterminated quote runs to the end of the line.
+            }
+            if (quote + 1 < line.size() && line[quote + 1] == '"') {
+                i = quote + 2;
+                continue;
+            }
+            searchFrom = quote + 1;
+            break;
+        }
+    }
+
+    const std::size_t comma = line.find(',', searchFrom);
+    return comma == string_view::npos ? line.size() : comma;
+}
+
+/**
+ * Trims a raw cell and strips surrounding quotes. When scratch is provided, escaped
+ * quotes are unescaped into it; otherwise the quoted text is returned as-is.
+ */
+string_view cellValue(string_view raw, string* scratch) {
+    string_view cell = trimView(raw);
+    if (cell.size() < 2 || cell.front() != '"' || cell.back() != '"') {
+        return cell;
+    }
+
+    cell = trimView(cell.substr(1, cell.size() - 2));
+    if (!scratch || cell.find("\"\"") == string_view::npos) {
+        return cell;
+    }
+
+    scratch->clear();
+    for (std::size_t i = 0; i < cell.size(); ++i) {
+        scratch->push_back(cell[i]);
+        if (cell[i] == '"' && i + 1 < cell.size() && cell[i + 1] == '"') {
+            ++i;
+        }
+    }
+    return *scratch;
+}
+
+// Case-insensitive membership test for header names.
+bool matchesAny(const string& lowered, const std::vector<string>& names) {
+    return std::any_of(names.begin(), names.end(), [&lowered](const string& name) {
+        return lowered == toLowerCopy(name);
+    });
+}
+
+}  // namespace
+
+string_view trimView(string_view text) {
+    const auto first = text.find_first_not_of(" \t\r\n");
+    if (first == string_view::npos) {
+        return {};
+    }
+    const auto last = text.find_last_not_of(" \t\r\n");
+    return text.substr(first, last - first + 1);
+}
+
+string_view stripUtf8Bom(string_view text) {
+    constexpr string_view kBom = "\xEF\xBB\xBF";
+    if (text.substr(0, kBom.size()) == kBom) {
+        text.remove_prefix(kBom.size());
+    }
+    return text;
+}
+
+string_view repairUtf8Line(string_view line, std::size_t lineNumber, string& scratch,
+                           std::vector<string>& warnings) {
+    std::size_t bad = findInvalidUtf8(line.data(), line.size(), 0);
+    if (bad == line.size()) {
+        return line;
+    }
+
+    warnings.emplace_back("Line " + std::to_string(lineNumber) + ": invalid UTF-8 at byte " +
+                          std::to_string(bad + 1) + " replaced with U+FFFD.");
+
+    constexpr string_view kReplacement = "\xEF\xBF\xBD";
+    scratch.assign(line.substr(0, bad));
+    std::size_t pos = bad;
+    while (pos < line.size()) {
+        scratch.append(kReplacement);
+        ++pos;
+        bad = findInvalidUtf8(line.data(), line.size(), pos);
+        scratch.append(line.substr(pos, bad - pos));
+        pos = bad;
+    }
+    return scratch;
+}
+
+string toUpperCopy(string_view text) {
+    string value(text);
+    for (char& ch : value) {
+        ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+    }
+    return value;
+}
+
+bool isCourseIdValid(string_view courseId) {
+    return LettersDigitsIdSpec::matches(courseId);
+}
+
+// The built-in schemes are checked by the compiler, not at startup.
+static_assert(LettersDigitsIdSpec::matches("CSCI200") && !LettersDigitsIdSpec::matches("200CSCI") &&
+              !LettersDigitsIdSpec::matches("CSCI") && !LettersDigitsIdSpec::matches("CS-101"));
+static_assert(DashedIdSpec::matches("CS-101") && DashedIdSpec::matches("cs 101") && !DashedIdSpec::matches("CS101"));
+static_assert(SpacedSuffixIdSpec::matches("CSCI 3300L") && SpacedSuffixIdSpec::matches("CSCI3300") &&
+              SpacedSuffixIdSpec::matches("CSCI-3300LB") && !SpacedSuffixIdSpec::matches("CSCI 3300LAB"));
+static_assert(NumericFirstIdSpec::matches("15-213") && NumericFirstIdSpec::matches("15.213") &&
+              !NumericFirstIdSpec::matches("15213") && !NumericFirstIdSpec::matches("CS-101"));
+
+const CourseIdScheme* findCourseIdScheme(string_view name) {
+    static constexpr const CourseIdScheme* kBuiltIn[] = {&kLettersDigitsIds, &kDashedIds, &kSpacedSuffixIds,
+                                                         &kNumericFirstIds};
+    for (const CourseIdScheme* scheme : kBuiltIn) {
+        if (name == scheme->name) {
+            return scheme;
+        }
+    }
+    return nullptr;
+}
+
+bool buildCourseRecord(string_view rawId,
+                       string_view name,
+                       const std::vector<string_view>& rawPrerequisites,
+                       std::size_t lineNumber,
+                       const CourseIdScheme& idScheme,
+                       Course& course,
+                       std::vector<string>& warnings) {
+    string courseId;
+    if (!idScheme.normalize(rawId, courseId)) {
+        warnings.emplace_back("Skipping line " + std::to_string(lineNumber) +
+                              ": invalid course ID '" + string(rawId) + "'.");
+        return false;
+    }
+
+    course.courseNumber = std::move(courseId);
+    course.courseName.assign(name);
+    course.prerequisites.clear();
+
+    for (string_view rawPrereq : rawPrerequisites) {
+        if (rawPrereq.empty()) {
+            continue;
+        }
+        string prereqId;
+        if (!idScheme.normalize(rawPrereq, prereqId)) {
+            warnings.emplace_back("Skipping invalid prerequisite '" + string(rawPrereq) +
+                                  "' for course " + course.courseNumber + ".");
+            continue;
+        }
+        // Prerequisite lists are short, so a linear scan beats building a set per row.
+        if (std::find(course.prerequisites.begin(), course.prerequisites.end(), prereqId) !=
+            course.prerequisites.end()) {
+            warnings.emplace_back("Duplicate prerequisite '" + prereqId +
+                                  "' ignored for course " + course.courseNumber + ".");
+            continue;
+        }
+        course.prerequisites.push_back(std::move(prereqId));
+    }
+
+    return true;
+}
+
+CsvColumnLayout positionalLayout(const ColumnMapping& mapping) {
+    CsvColumnLayout layout;
+    const std::size_t width = std::max({mapping.idColumn + 1, mapping.nameColumn + 1,
+                                        mapping.firstPrerequisiteColumn});
+    layout.roles.assign(width, ColumnRole::Skip);
+    layout.roles[mapping.nameColumn] = ColumnRole::Name;
+    layout.roles[mapping.idColumn] = ColumnRole::Id;
+    for (std::size_t column = mapping.firstPrerequisiteColumn; column < width; ++column) {
+        if (layout.roles[column] == ColumnRole::Skip) {
+            layout.roles[column] = ColumnRole::Prerequisite;
+        }
+    }
+    layout.trailingPrerequisites = true;
+    layout.lastNeededColumn = width - 1;
+    return layout;
+}
+
+std::optional<CsvColumnLayout> headerLayout(string_view headerLine,
+                                            const ColumnMapping& mapping,
+                                            std::vector<string>& warnings) {
+    CsvColumnLayout layout;
+    const string prefix = toLowerCopy(mapping.prerequisiteHeaderPrefix);
+    bool hasId = false;
+    bool hasName = false;
+
+    std::size_t pos = 0;
+    while (true) {
+        const std::size_t end = fieldEnd(headerLine, pos);
+        const string header = toLowerCopy(cellValue(headerLine.substr(pos, end - pos), nullptr));
+
+        ColumnRole role = ColumnRole::Skip;
+        if (!hasId && matchesAny(header, mapping.idHeaders)) {
+            role = ColumnRole::Id;
+            hasId = true;
+        } else if (!hasName && matchesAny(header, mapping.nameHeaders)) {
+            role = ColumnRole::Name;
+            hasName = true;
+        } else if (!prefix.empty() && header.compare(0, prefix.size(), prefix) == 0) {
+            role = ColumnRole::Prerequisite;
+        }
+        layout.roles.push_back(role);
+        if (role != ColumnRole::Skip) {
+            layout.lastNeededColumn = layout.roles.size() - 1;
+        }
+
+        if (end >= headerLine.size()) {
+            break;
+        }
+        pos = end + 1;
+    }
+
+    if (!hasId || !hasName) {
+        warnings.emplace_back(string("Header row does not name a course ") +
+                              (hasId ? "title" : "ID") + " column.");
+        return std::nullopt;
+    }
+    return layout;
+}
+
+bool looksLikeHeader(string_view firstLine, const ColumnMapping& mapping, const CourseIdScheme& idScheme) {
+    bool namesIdColumn = false;
+    string normalized;
+    std::size_t column = 0;
+    std::size_t pos = 0;
+    while (true) {
+        const std::size_t end = fieldEnd(firstLine, pos);
+        const string_view cell = cellValue(firstLine.substr(pos, end - pos), nullptr);
+        if (column == mapping.idColumn && idScheme.normalize(cell, normalized)) {
+            return false;  // A real course ID where IDs live means this is already data.
+        }
+        namesIdColumn = namesIdColumn || matchesAny(toLowerCopy(cell), mapping.idHeaders);
+
+        if (end >= firstLine.size()) {
+            break;
+        }
+        pos = end + 1;
+        ++column;
+    }
+    return namesIdColumn;
+}
+
+CsvRowParser::CsvRowParser(CsvColumnLayout columnLayout, const CourseIdScheme& scheme)
+    : layout(std::move(columnLayout)), idScheme(scheme) {}
+
+bool CsvRowParser::parse(string_view line, std::size_t lineNumber, Course& course,
+                         std::vector<string>& warnings) {
+    prerequisiteCells.clear();
+    string_view id;
+    string_view name;
+    bool hasId = false;
+    bool hasName = false;
+
+    std::size_t column = 0;
+    std::size_t pos = 0;
+    while (true) {
+        const std::size_t end = fieldEnd(line, pos);
+        const string_view raw = line.substr(pos, end - pos);
+        switch (layout.roleFor(column)) {
+            case ColumnRole::Id:
+                id = cellValue(raw, nullptr);
+                hasId = true;
+                break;
+            case ColumnRole::Name:
+                name = cellValue(raw, &nameScratch);
+                hasName = true;
+                break;
+            case ColumnRole::Prerequisite:
+                prerequisiteCells.push_back(cellValue(raw, nullptr));
+                break;
+            case ColumnRole::Skip:
+                break;
+        }
+
+        if (end >= line.size()) {
+            break;
+        }
+        pos = end + 1;
+        ++column;
+        if (column > layout.lastNeededColumn && !layout.trailingPrerequisites) {
+            break;  // Everything to the right is unmapped, so never scan it.
+        }
+    }
+
+    // A trailing comma ("CSCI400,") gives an empty name cell, which is no name at all.
+    if (!hasId || !hasName || trimView(name).empty()) {
+        warnings.emplace_back("Skipping line " + std::to_string(lineNumber) +
+                              ": expected course ID and name.");
+        return false;
+    }
+
+    return buildCourseRecord(id, name, prerequisiteCells, lineNumber, idScheme, course, warnings);
+}
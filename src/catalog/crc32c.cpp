@@ -0,0 +1,112 @@
+#include "catalog/crc32c.hpp"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CATALOG_HAVE_CRC32_INSTRUCTION 1
+#include <nmmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define CATALOG_TARGET_SSE42
+#else
+// Lets this one function use SSE4.2 without raising the baseline of the whole build.
+#define CATALOG_TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+#endif
+
+namespace {
+
+constexpr std::uint32_t kPolynomial = 0x82F63B78u;  // Castagnoli, bit-reflected.
+
+using SliceTables = std::array<std::array<std::uint32_t, 256>, 8>;
+
+// tables[0] is the classic byte table; tables[k] advances a byte through k more zero bytes.
+constexpr SliceTables makeSliceTables() {
+    SliceTables tables{};
+    for (std::uint32_t byte = 0; byte < 256; ++byte) {
+        std::uint32_t crc = byte;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1u) != 0 ? kPolynomial : 0u);
+        }
+        tables[0][byte] = crc;
+    }
+    for (std::size_t slice = 1; slice < tables.size(); ++slice) {
+        for (std::size_t byte = 0; byte < 256; ++byte) {
+            const std::uint32_t previous = tables[slice - 1][byte];
+            tables[slice][byte] = (previous >> 8) ^ tables[0][previous & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr SliceTables kSliceTables = makeSliceTables();
+
+std::uint32_t loadLittleEndian32(const unsigned char* data) {
+    return static_cast<std::uint32_t>(data[0]) | static_cast<std::uint32_t>(data[1]) << 8 |
+           static_cast<std::uint32_t>(data[2]) << 16 | static_cast<std::uint32_t>(data[3]) << 24;
+}
+
+// Portable path: eight table lookups per eight bytes, then a byte loop for the tail.
+std::uint32_t crc32cTable(const unsigned char* data, std::size_t size, std::uint32_t crc) {
+    const auto& t = kSliceTables;
+    for (; size >= 8; data += 8, size -= 8) {
+        const std::uint32_t low = crc ^ loadLittleEndian32(data);
+        const std::uint32_t high = loadLittleEndian32(data + 4);
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+    }
+    for (; size > 0; ++data, --size) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *data) & 0xFF];
+    }
+    return crc;
+}
+
+#ifdef CATALOG_HAVE_CRC32_INSTRUCTION
+CATALOG_TARGET_SSE42
+std::uint32_t crc32cHardware(const unsigned char* data, std::size_t size, std::uint32_t crc) {
+    std::uint64_t wide = crc;
+    for (; size >= 8; data += 8, size -= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        wide = _mm_crc32_u64(wide, word);
+    }
+    crc = static_cast<std::uint32_t>(wide);
+    for (; size > 0; ++data, --size) {
+        crc = _mm_crc32_u8(crc, *data);
+    }
+    return crc;
+}
+
+bool cpuHasSse42() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int registers[4];
+    __cpuid(registers, 1);
+    return (registers[2] & (1 << 20)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.2");
+#endif
+}
+#endif
+
+}  // namespace
+
+bool crc32cHardwareAccelerated() {
+#ifdef CATALOG_HAVE_CRC32_INSTRUCTION
+    static const bool supported = cpuHasSse42();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+std::uint32_t crc32c(const void* data, std::size_t size, std::uint32_t crc) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+#ifdef CATALOG_HAVE_CRC32_INSTRUCTION
+    if (crc32cHardwareAccelerated()) {
+        return ~crc32cHardware(bytes, size, crc);
+    }
+#endif
+    return ~crc32cTable(bytes, size, crc);
+}
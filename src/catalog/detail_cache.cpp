@@ -0,0 +1,80 @@
+#include "catalog/detail_cache.hpp"
+
+#include <mutex>
+
+CourseDetailCache::CourseDetailCache(const Catalog& catalogToRender, std::size_t maxCachedEntries,
+                                     std::pmr::memory_resource* resource)
+    : catalog(catalogToRender), maxEntries(maxCachedEntries), memory(resource), blocks(resource) {}
+
+CourseDetailCache::StyleId CourseDetailCache::addStyle(Renderer render) {
+    std::unique_lock lock(mutex);
+    styles.push_back(std::move(render));
+    return static_cast<StyleId>(styles.size() - 1);
+}
+
+CourseDetailCache::Key CourseDetailCache::keyFor(StyleId style, const std::string& courseId) const {
+    Key key(memory);
+    key.reserve(sizeof(style) + courseId.size());
+    key.append(reinterpret_cast<const char*>(&style), sizeof(style));
+    key.append(courseId);
+    return key;
+}
+
+void CourseDetailCache::revalidate() {
+    const std::uint64_t generation = catalog.generation();
+    {
+        std::shared_lock lock(mutex);
+        if (cachedGeneration == generation) {
+            return;
+        }
+    }
+    std::unique_lock lock(mutex);
+    if (cachedGeneration != generation) {
+        blocks.clear();
+        cachedGeneration = generation;
+    }
+}
+
+CourseDetailCache::Block CourseDetailCache::get(StyleId style, const std::string& courseId) {
+    revalidate();
+    const Key key = keyFor(style, courseId);
+    const Renderer* render = nullptr;
+    {
+        std::shared_lock lock(mutex);
+        if (const auto found = blocks.find(key); found != blocks.end()) {
+            hitCount.fetch_add(1, std::memory_order_relaxed);
+            return found->second;
+        }
+        render = style < styles.size() ? &styles[style] : nullptr;
+    }
+
+    const Course* course = catalog.get(courseId);
+    if (!course || !render) {
+        return nullptr;
+    }
+    missCount.fetch_add(1, std::memory_order_relaxed);
+    const std::string text = (*render)(catalog, *course);
+    // The allocator propagates to the string, so its buffer comes from memory too.
+    Block block = std::allocate_shared<std::pmr::string>(std::pmr::polymorphic_allocator<std::pmr::string>(memory),
+                                                         std::string_view(text));
+
+    std::unique_lock lock(mutex);
+    if (cachedGeneration == catalog.generation() && blocks.size() < maxEntries) {
+        // Another session may have rendered it meanwhile; either copy is fine to return.
+        blocks.try_emplace(key, block);
+    }
+    return block;
+}
+
+std::size_t CourseDetailCache::size() const {
+    std::shared_lock lock(mutex);
+    return blocks.size();
+}
+
+std::size_t CourseDetailCache::hits() const {
+    return hitCount.load(std::memory_order_relaxed);
+}
+
+std::size_t CourseDetailCache::misses() const {
+    return missCount.load(std::memory_order_relaxed);
+}
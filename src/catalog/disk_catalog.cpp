@@ -0,0 +1,448 @@
+#include "catalog/disk_catalog.hpp"
+
+#include "catalog/crc32c.hpp"
+#include "catalog/wire_format.hpp"
+
+#include <system_error>
+
+namespace {
+
+using std::string;
+using std::string_view;
+
+constexpr string_view kDiskCatalogMagic = "CATBTRE1";
+constexpr std::size_t kPageSize = kDiskCatalogPageSize;
+constexpr std::size_t kNodeHeaderBytes = 12;  // Level, reserved bytes, entry count, span.
+
+std::uint32_t readU32At(string_view bytes, std::size_t pos) {
+    ByteReader reader{bytes, pos};
+    return reader.u32();
+}
+
+// Bytes a node with count entries totalling entryBytes needs, CRC included.
+std::size_t nodeBytes(std::size_t count, std::size_t entryBytes) {
+    return kNodeHeaderBytes + 4 * count + entryBytes + 4;
+}
+
+string pageLabel(std::uint32_t page) {
+    return "disk catalog node at page " + std::to_string(page);
+}
+
+// Entries of one node that loadNode() has already checked for size, CRC, and offsets.
+struct NodeView {
+    string_view bytes;
+
+    std::uint32_t level() const { return static_cast<unsigned char>(bytes[0]); }
+    std::uint32_t count() const { return readU32At(bytes, 4); }
+
+    ByteReader entry(std::uint32_t index) const {
+        return ByteReader{bytes.substr(0, bytes.size() - 4), readU32At(bytes, kNodeHeaderBytes + 4 * index)};
+    }
+
+    std::uint32_t child(std::uint32_t index) const { return entry(index).u32(); }
+
+    string_view key(std::uint32_t index) const {
+        ByteReader reader = entry(index);
+        if (level() != 0) {
+            reader.u32();
+        }
+        return reader.view();
+    }
+
+    // First entry whose key is not below id.
+    std::uint32_t lowerBound(string_view id) const {
+        std::uint32_t low = 0;
+        std::uint32_t high = count();
+        while (low < high) {
+            const std::uint32_t middle = low + (high - low) / 2;
+            if (key(middle) < id) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+    // Child whose range holds id: the last entry whose key is not above id, else the first.
+    std::uint32_t childFor(string_view id) const {
+        std::uint32_t low = 0;
+        std::uint32_t high = count();
+        while (low < high) {
+            const std::uint32_t middle = low + (high - low) / 2;
+            if (id < key(middle)) {
+                high = middle;
+            } else {
+                low = middle + 1;
+            }
+        }
+        return low == 0 ? 0 : low - 1;
+    }
+};
+
+}  // namespace
+
+bool DiskCatalogWriter::open(const std::filesystem::path& path, std::string& error) {
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        error = "cannot create '" + path.string() + "'";
+        return false;
+    }
+    out.write(string(kPageSize, '\0').data(), kPageSize);  // The header goes here once the root is known.
+    levels.assign(1, PendingNode{});
+    lastId.clear();
+    courses = 0;
+    nextPage = 1;
+    return static_cast<bool>(out);
+}
+
+bool DiskCatalogWriter::add(const Course& course, std::string& error) {
+    if (courses != 0 && !(lastId < course.courseNumber)) {
+        error = "course " + course.courseNumber + " does not sort after " + lastId;
+        return false;
+    }
+    scratch.clear();
+    putCourse(scratch, course);
+    if (!appendEntry(0, course.courseNumber, scratch, error)) {
+        return false;
+    }
+    lastId = course.courseNumber;
+    ++courses;
+    return true;
+}
+
+bool DiskCatalogWriter::appendEntry(std::size_t level, std::string_view key, const std::string& entry,
+                                    std::string& error) {
+    if (levels.size() <= level) {
+        levels.resize(level + 1);
+    }
+    if (!levels[level].offsets.empty() &&
+        nodeBytes(levels[level].offsets.size() + 1, levels[level].entries.size() + entry.size()) > kPageSize &&
+        !flushNode(level, error)) {
+        return false;
+    }
+    PendingNode& node = levels[level];  // flushNode() may have grown levels.
+    if (node.offsets.empty()) {
+        node.firstKey.assign(key);
+    }
+    node.offsets.push_back(static_cast<std::uint32_t>(node.entries.size()));
+    node.entries += entry;
+    return true;
+}
+
+bool DiskCatalogWriter::writeNode(std::size_t level, std::uint32_t& page, std::string& error) {
+    PendingNode& node = levels[level];
+    const std::size_t count = node.offsets.size();
+    const std::size_t span = (nodeBytes(count, node.entries.size()) + kPageSize - 1) / kPageSize;
+    if (span > UINT32_MAX - nextPage) {
+        error = "disk catalog is too large";
+        return false;
+    }
+
+    string bytes;
+    bytes.reserve(span * kPageSize);
+    bytes.push_back(static_cast<char>(level));
+    bytes.append(3, '\0');
+    putU32(bytes, static_cast<std::uint32_t>(count));
+    putU32(bytes, static_cast<std::uint32_t>(span));
+    const std::size_t entriesStart = kNodeHeaderBytes + 4 * count;
+    for (const std::uint32_t offset : node.offsets) {
+        putU32(bytes, static_cast<std::uint32_t>(entriesStart + offset));
+    }
+    bytes += node.entries;
+    bytes.resize(span * kPageSize - 4, '\0');
+    putU32(bytes, crc32c(bytes.data(), bytes.size()));
+
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!out) {
+        error = "write failed";
+        return false;
+    }
+    page = nextPage;
+    nextPage += static_cast<std::uint32_t>(span);
+    ++node.nodesWritten;
+    node.entries.clear();
+    node.offsets.clear();
+    return true;
+}
+
+bool DiskCatalogWriter::flushNode(std::size_t level, std::string& error) {
+    std::uint32_t page = 0;
+    if (!writeNode(level, page, error)) {
+        return false;
+    }
+    const string key = std::move(levels[level].firstKey);
+    string parentEntry;
+    putU32(parentEntry, page);
+    putString(parentEntry, key);
+    return appendEntry(level + 1, key, parentEntry, error);
+}
+
+bool DiskCatalogWriter::finish(std::string& error) {
+    // Close each level from the bottom up; the first one whose pending node is all it has is the root.
+    std::uint32_t root = 0;
+    std::uint32_t height = 0;
+    for (std::size_t level = 0; height == 0; ++level) {
+        if (levels[level].nodesWritten == 0) {
+            if (!writeNode(level, root, error)) {
+                return false;
+            }
+            height = static_cast<std::uint32_t>(level + 1);
+        } else if (!levels[level].offsets.empty() && !flushNode(level, error)) {
+            return false;
+        }
+    }
+
+    string header;
+    header.append(kDiskCatalogMagic);
+    putU32(header, static_cast<std::uint32_t>(kPageSize));
+    putU32(header, height);
+    putU64(header, courses);
+    putU32(header, root);
+    putU32(header, nextPage);
+    putU32(header, crc32c(header.data(), header.size()));
+    out.seekp(0);
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    out.close();
+    if (!out) {
+        error = "write failed";
+        return false;
+    }
+    return true;
+}
+
+bool writeDiskCatalog(const Catalog& catalog, const std::filesystem::path& path, std::string& error) {
+    DiskCatalogWriter writer;
+    if (!writer.open(path, error)) {
+        return false;
+    }
+    for (const auto& id : catalog.sortedIds()) {
+        if (!writer.add(*catalog.get(id), error)) {
+            return false;
+        }
+    }
+    return writer.finish(error);
+}
+
+bool DiskCatalog::open(const std::filesystem::path& path, std::string& error, std::size_t cacheBytes) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    recentNodes.clear();
+    cachedNodes.clear();
+    stats = DiskCatalogCacheStats{};
+    stats.capacityBytes = cacheCapacity = cacheBytes;
+    treeHeight = 0;
+    courseCount = 0;
+
+    file.close();
+    file.clear();
+    file.open(path, std::ios::binary);
+    string header(kPageSize, '\0');
+    if (!file || !file.read(header.data(), static_cast<std::streamsize>(header.size()))) {
+        error = "cannot read a disk catalog header from '" + path.string() + "'";
+        return false;
+    }
+
+    ByteReader reader{header};
+    if (!reader.expect(kDiskCatalogMagic)) {
+        error = "not a disk catalog";
+        return false;
+    }
+    const std::uint32_t pageSize = reader.u32();
+    const std::uint32_t height = reader.u32();
+    const std::uint64_t count = reader.u64();
+    const std::uint32_t root = reader.u32();
+    const std::uint32_t pages = reader.u32();
+    const std::size_t checkedBytes = reader.pos;
+    if (reader.u32() != crc32c(header.data(), checkedBytes)) {
+        error = "disk catalog header failed its CRC-32C check";
+        return false;
+    }
+    std::error_code sizeError;
+    const std::uintmax_t fileBytes = std::filesystem::file_size(path, sizeError);
+    if (pageSize != kPageSize || height == 0 || height > 255 || root == 0 || root >= pages || sizeError ||
+        fileBytes < static_cast<std::uintmax_t>(pages) * kPageSize) {
+        error = "disk catalog header is malformed or the file is truncated";
+        return false;
+    }
+
+    rootPage = root;
+    treeHeight = height;
+    totalPages = pages;
+    courseCount = count;
+    return true;
+}
+
+DiskCatalog::NodeBytes DiskCatalog::readNode(std::uint32_t page, std::string& error) const {
+    if (page == 0 || page >= totalPages) {
+        error = pageLabel(page) + " is outside the file";
+        return nullptr;
+    }
+    auto bytes = std::make_shared<string>(kPageSize, '\0');
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(page) * static_cast<std::streamoff>(kPageSize));
+    if (!file.read(bytes->data(), static_cast<std::streamsize>(kPageSize))) {
+        error = "cannot read " + pageLabel(page);
+        return nullptr;
+    }
+    const std::uint32_t span = readU32At(*bytes, 8);
+    if (span == 0 || span > totalPages - page) {
+        error = pageLabel(page) + " is malformed";
+        return nullptr;
+    }
+    if (span > 1) {
+        bytes->resize(static_cast<std::size_t>(span) * kPageSize);
+        if (!file.read(bytes->data() + kPageSize, static_cast<std::streamsize>(bytes->size() - kPageSize))) {
+            error = "cannot read " + pageLabel(page);
+            return nullptr;
+        }
+    }
+    stats.bytesRead += bytes->size();
+
+    const std::size_t checked = bytes->size() - 4;
+    if (crc32c(bytes->data(), checked) != readU32At(*bytes, checked)) {
+        error = pageLabel(page) + " failed its CRC-32C check";
+        return nullptr;
+    }
+    const std::uint32_t count = readU32At(*bytes, 4);
+    const std::size_t entriesStart = kNodeHeaderBytes + 4 * static_cast<std::size_t>(count);
+    bool valid = entriesStart <= checked;
+    for (std::uint32_t i = 0; valid && i < count; ++i) {
+        const std::uint32_t offset = readU32At(*bytes, kNodeHeaderBytes + 4 * static_cast<std::size_t>(i));
+        valid = offset >= entriesStart && offset < checked;
+    }
+    if (!valid) {
+        error = pageLabel(page) + " is malformed";
+        return nullptr;
+    }
+    return bytes;
+}
+
+DiskCatalog::NodeBytes DiskCatalog::loadNode(std::uint32_t page, std::string& error) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (const auto cached = cachedNodes.find(page); cached != cachedNodes.end()) {
+        ++stats.hits;
+        recentNodes.splice(recentNodes.begin(), recentNodes, cached->second);
+        return cached->second->bytes;
+    }
+
+    ++stats.misses;
+    NodeBytes node = readNode(page, error);
+    if (!node) {
+        return nullptr;
+    }
+    recentNodes.push_front(CachedNode{page, node});
+    cachedNodes.try_emplace(page, recentNodes.begin());
+    stats.cachedBytes += node->size();
+    while (stats.cachedBytes > cacheCapacity && recentNodes.size() > 1) {
+        const CachedNode& oldest = recentNodes.back();
+        stats.cachedBytes -= oldest.bytes->size();
+        cachedNodes.erase(oldest.page);
+        recentNodes.pop_back();
+        ++stats.evictions;
+    }
+    return node;
+}
+
+std::optional<Course> DiskCatalog::get(std::string_view courseId, std::string& error) const {
+    std::uint32_t page = rootPage;
+    for (std::uint32_t level = treeHeight; level-- > 0;) {
+        const NodeBytes node = loadNode(page, error);
+        if (!node) {
+            return std::nullopt;
+        }
+        const NodeView view{*node};
+        if (view.level() != level) {
+            error = pageLabel(page) + " is not at the level its parent expects";
+            return std::nullopt;
+        }
+        if (level > 0) {
+            page = view.child(view.childFor(courseId));
+            continue;
+        }
+
+        const std::uint32_t index = view.lowerBound(courseId);
+        if (index == view.count() || view.key(index) != courseId) {
+            return std::nullopt;
+        }
+        Course course;
+        ByteReader reader = view.entry(index);
+        readCourse(reader, course);
+        if (!reader.ok) {
+            error = pageLabel(page) + " is malformed";
+            return std::nullopt;
+        }
+        return course;
+    }
+    return std::nullopt;
+}
+
+bool DiskCatalog::scanNode(std::uint32_t page, std::uint32_t level, std::string_view from,
+                           const std::function<bool(const Course&)>& visit, std::string& error) const {
+    const NodeBytes node = loadNode(page, error);  // Held until the subtree is done, whatever the cache does.
+    if (!node) {
+        return false;
+    }
+    const NodeView view{*node};
+    if (view.level() != level) {
+        error = pageLabel(page) + " is not at the level its parent expects";
+        return false;
+    }
+
+    const std::uint32_t count = view.count();
+    if (level > 0) {
+        for (std::uint32_t i = view.childFor(from); i < count; ++i) {
+            if (!scanNode(view.child(i), level - 1, from, visit, error)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Course course;
+    for (std::uint32_t i = view.lowerBound(from); i < count; ++i) {
+        ByteReader reader = view.entry(i);
+        readCourse(reader, course);
+        if (!reader.ok) {
+            error = pageLabel(page) + " is malformed";
+            return false;
+        }
+        if (!visit(course)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DiskCatalog::scan(std::string_view from, const std::function<bool(const Course&)>& visit,
+                       std::string& error) const {
+    if (treeHeight == 0) {
+        error = "no disk catalog is open";
+        return false;
+    }
+    string failure;
+    scanNode(rootPage, treeHeight - 1, from, visit, failure);
+    if (!failure.empty()) {
+        error = std::move(failure);
+        return false;
+    }
+    return true;
+}
+
+bool DiskCatalog::scanPrefix(std::string_view prefix, const std::function<void(const Course&)>& visit,
+                             std::string& error) const {
+    return scan(
+        prefix,
+        [&](const Course& course) {
+            if (!course.courseNumber.starts_with(prefix)) {
+                return false;
+            }
+            visit(course);
+            return true;
+        },
+        error);
+}
+
+DiskCatalogCacheStats DiskCatalog::cacheStats() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return stats;
+}
@@ -0,0 +1,489 @@
+#include "catalog/jsonl_parser.hpp"
+
+#include "catalog/course_parser.hpp"
+#include "catalog/simd_scan.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+
+namespace {
+
+using std::string;
+using std::string_view;
+
+// Buffers smaller than this are parsed on the calling thread.
+constexpr std::size_t kParallelThresholdBytes = 1 << 20;
+
+// Each chunk holds at least this much input so scheduling overhead stays negligible.
+constexpr std::size_t kMinChunkBytes = 256 << 10;
+
+// Upper bound on chunks per pool worker.
+constexpr std::size_t kChunksPerWorker = 4;
+
+// Read position inside one JSON line plus the first error encountered.
+struct JsonCursor {
+    const char* data = nullptr;
+    std::size_t size = 0;
+    std::size_t pos = 0;
+    const char* error = nullptr;
+
+    bool atEnd() const { return pos >= size; }
+    char peek() const { return pos < size ? data[pos] : '\0'; }
+
+    bool fail(const char* message) {
+        if (!error) {
+            error = message;
+        }
+        return false;
+    }
+
+    void skipWhitespace() {
+        while (pos < size && (data[pos] == ' ' || data[pos] == '\t' || data[pos] == '\r' || data[pos] == '\n')) {
+            ++pos;
+        }
+    }
+
+    bool consume(char expected, const char* message) {
+        skipWhitespace();
+        if (peek() != expected) {
+            return fail(message);
+        }
+        ++pos;
+        return true;
+    }
+};
+
+// Lowercased copy used when classifying keys.
+string toLowerCopy(string_view text) {
+    string value(text);
+    for (char& ch : value) {
+        ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    }
+    return value;
+}
+
+// Appends a Unicode code point as UTF-8.
+void appendUtf8(std::uint32_t codePoint, string& out) {
+    if (codePoint < 0x80) {
+        out.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+// Reads the four hex digits of a \u escape starting at pos.
+bool readHex4(JsonCursor& cursor, std::uint32_t& value) {
+    if (cursor.pos + 4 > cursor.size) {
+        return cursor.fail("truncated \\u escape");
+    }
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        const char ch = cursor.data[cursor.pos++];
+        value <<= 4;
+        if (ch >= '0' && ch <= '9') {
+            value |= static_cast<std::uint32_t>(ch - '0');
+        } else if (ch >= 'a' && ch <= 'f') {
+            value |= static_cast<std::uint32_t>(ch - 'a' + 10);
+        } else if (ch >= 'A' && ch <= 'F') {
+            value |= static_cast<std::uint32_t>(ch - 'A' + 10);
+        } else {
+            return cursor.fail("bad \\u escape");
+        }
+    }
+    return true;
+}
+
+/**
+ * Reads the string whose opening quote is at pos. Strings without escapes come back as a
+ * view into the line; only escaped strings are decoded (into scratch).
+ */
+bool readString(JsonCursor& cursor, string& scratch, string_view& out) {
+    const std::size_t start = ++cursor.pos;
+    std::size_t hit = findQuoteOrBackslash(cursor.data, cursor.size, start);
+    if (hit < cursor.size && cursor.data[hit] == '"') {
+        out = string_view(cursor.data + start, hit - start);
+        cursor.pos = hit + 1;
+        return true;
+    }
+
+    scratch.assign(cursor.data + start, std::min(hit, cursor.size) - start);
+    while (hit < cursor.size) {
+        if (cursor.data[hit] == '"') {
+            cursor.pos = hit + 1;
+            out = scratch;
+            return true;
+        }
+
+        // Backslash escape.
+        cursor.pos = hit + 2;
+        if (cursor.pos > cursor.size) {
+            break;
+        }
+        switch (cursor.data[hit + 1]) {
+            case '"': scratch.push_back('"'); break;
+            case '\\': scratch.push_back('\\'); break;
+            case '/': scratch.push_back('/'); break;
+            case 'b': scratch.push_back('\b'); break;
+            case 'f': scratch.push_back('\f'); break;
+            case 'n': scratch.push_back('\n'); break;
+            case 'r': scratch.push_back('\r'); break;
+            case 't': scratch.push_back('\t'); break;
+            case 'u': {
+                std::uint32_t codePoint = 0;
+                if (!readHex4(cursor, codePoint)) {
+                    return false;
+                }
+                // Combine a surrogate pair into one code point.
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF && cursor.pos + 1 < cursor.size &&
+                    cursor.data[cursor.pos] == '\\' && cursor.data[cursor.pos + 1] == 'u') {
+                    cursor.pos += 2;
+                    std::uint32_t low = 0;
+                    if (!readHex4(cursor, low)) {
+                        return false;
+                    }
+                    codePoint = low >= 0xDC00 && low <= 0xDFFF
+                                    ? 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00)
+                                    : 0xFFFD;
+                }
+                // An unpaired surrogate has no UTF-8 form, so it decodes to U+FFFD.
+                if (codePoint >= 0xD800 && codePoint <= 0xDFFF) {
+                    codePoint = 0xFFFD;
+                }
+                appendUtf8(codePoint, scratch);
+                break;
+            }
+            default:
+                return cursor.fail("unknown escape");
+        }
+
+        const std::size_t next = findQuoteOrBackslash(cursor.data, cursor.size, cursor.pos);
+        scratch.append(cursor.data + cursor.pos, std::min(next, cursor.size) - cursor.pos);
+        hit = next;
+    }
+    return cursor.fail("unterminated string");
+}
+
+// Steps over a string without decoding it.
+bool skipString(JsonCursor& cursor) {
+    std::size_t pos = cursor.pos + 1;
+    while (true) {
+        pos = findQuoteOrBackslash(cursor.data, cursor.size, pos);
+        if (pos >= cursor.size) {
+            return cursor.fail("unterminated string");
+        }
+        if (cursor.data[pos] == '"') {
+            cursor.pos = pos + 1;
+            return true;
+        }
+        pos += 2;  // Skip the escaped character, whatever it is.
+    }
+}
+
+/**
+ * Steps over any value. Nested objects and arrays are crossed by jumping between
+ * structural bytes with the vectorized scanner, so unneeded fields cost almost nothing.
+ */
+bool skipValue(JsonCursor& cursor) {
+    const char first = cursor.peek();
+    if (first == '"') {
+        return skipString(cursor);
+    }
+
+    if (first == '{' || first == '[') {
+        int depth = 0;
+        while (true) {
+            cursor.pos = findJsonStructural(cursor.data, cursor.size, cursor.pos);
+            if (cursor.atEnd()) {
+                return cursor.fail("unterminated object or array");
+            }
+            const char ch = cursor.data[cursor.pos];
+            if (ch == '"') {
+                if (!skipString(cursor)) {
+                    return false;
+                }
+                continue;
+            }
+            ++cursor.pos;
+            depth += (ch == '{' || ch == '[') ? 1 : -1;
+            if (depth == 0) {
+                return true;
+            }
+        }
+    }
+
+    // Numbers, true/false/null: run to the next delimiter.
+    const std::size_t start = cursor.pos;
+    while (!cursor.atEnd()) {
+        const char ch = cursor.data[cursor.pos];
+        if (ch == ',' || ch == '}' || ch == ']' || ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n') {
+            break;
+        }
+        ++cursor.pos;
+    }
+    return cursor.pos > start || cursor.fail("expected a value");
+}
+
+// Reads a scalar field: strings are decoded, null becomes empty, anything else is kept raw.
+bool readScalar(JsonCursor& cursor, string& scratch, string_view& out) {
+    if (cursor.peek() == '"') {
+        return readString(cursor, scratch, out);
+    }
+    const std::size_t start = cursor.pos;
+    if (!skipValue(cursor)) {
+        return false;
+    }
+    out = string_view(cursor.data + start, cursor.pos - start);
+    if (out == "null") {
+        out = {};
+    }
+    return true;
+}
+
+}  // namespace
+
+JsonLineParser::JsonLineParser(const ColumnMapping& columnMapping, const CourseIdScheme& scheme)
+    : mapping(columnMapping), idScheme(scheme) {}
+
+// Records usually repeat the same key order, so the classification is cached per position.
+JsonLineParser::Field JsonLineParser::classifyKey(string_view key, std::size_t position) {
+    if (position < keyCache.size() && keyCache[position].first == key) {
+        return keyCache[position].second;
+    }
+
+    const string lowered = toLowerCopy(key);
+    const auto matches = [&lowered](const std::vector<string>& names) {
+        return std::any_of(names.begin(), names.end(), [&lowered](const string& name) {
+            return lowered == toLowerCopy(name);
+        });
+    };
+    const string prefix = toLowerCopy(mapping.prerequisiteHeaderPrefix);
+
+    Field field = Field::Skip;
+    if (matches(mapping.idHeaders)) {
+        field = Field::Id;
+    } else if (matches(mapping.nameHeaders)) {
+        field = Field::Name;
+    } else if (!prefix.empty() && lowered.compare(0, prefix.size(), prefix) == 0) {
+        field = Field::Prerequisites;
+    }
+
+    if (position >= keyCache.size()) {
+        keyCache.resize(position + 1);
+    }
+    keyCache[position] = {string(key), field};
+    return field;
+}
+
+bool JsonLineParser::parse(string_view line, std::size_t lineNumber, Course& course,
+                           std::vector<string>& warnings) {
+    JsonCursor cursor{line.data(), line.size(), 0, nullptr};
+    prerequisites.clear();
+    prerequisiteScratch.clear();
+
+    string keyScratch;
+    string_view id;
+    string_view name;
+    bool hasId = false;
+    bool hasName = false;
+
+    const auto malformed = [&]() {
+        warnings.emplace_back("Skipping line " + std::to_string(lineNumber) + ": malformed JSON (" +
+                              (cursor.error ? cursor.error : "unexpected input") + ").");
+        return false;
+    };
+
+    if (!cursor.consume('{', "expected an object")) {
+        return malformed();
+    }
+    cursor.skipWhitespace();
+    bool closed = cursor.peek() == '}';
+
+    for (std::size_t position = 0; !closed; ++position) {
+        cursor.skipWhitespace();
+        string_view key;
+        if (cursor.peek() != '"') {
+            cursor.fail("expected a key");
+            return malformed();
+        }
+        if (!readString(cursor, keyScratch, key) || !cursor.consume(':', "expected ':'")) {
+            return malformed();
+        }
+        cursor.skipWhitespace();
+
+        Field field = classifyKey(key, position);
+        if ((field == Field::Id && hasId) || (field == Field::Name && hasName)) {
+            field = Field::Skip;  // First occurrence of a duplicate key wins.
+        }
+
+        bool ok = true;
+        switch (field) {
+            case Field::Id:
+                ok = readScalar(cursor, idScratch, id);
+                hasId = true;
+                break;
+            case Field::Name:
+                ok = readScalar(cursor, nameScratch, name);
+                hasName = true;
+                break;
+            case Field::Prerequisites:
+                if (cursor.peek() == '[') {
+                    ++cursor.pos;
+                    cursor.skipWhitespace();
+                    bool first = true;
+                    while (ok && cursor.peek() != ']') {
+                        if (!first && !cursor.consume(',', "expected ',' in array")) {
+                            ok = false;
+                            break;
+                        }
+                        first = false;
+                        cursor.skipWhitespace();
+                        string_view value;
+                        ok = readScalar(cursor, prerequisiteScratch.emplace_back(), value);
+                        prerequisites.push_back(value);
+                        cursor.skipWhitespace();
+                    }
+                    ok = ok && cursor.consume(']', "expected ']'");
+                } else {
+                    string_view value;
+                    ok = readScalar(cursor, prerequisiteScratch.emplace_back(), value);
+                    prerequisites.push_back(value);
+                }
+                break;
+            case Field::Skip:
+                ok = skipValue(cursor);
+                break;
+        }
+        if (!ok) {
+            return malformed();
+        }
+
+        // No early exit once ID, name, and a prerequisite key are in: any later key with the
+        // prerequisite prefix adds to the list, just as every Prereq column does in CSV.
+        cursor.skipWhitespace();
+        if (cursor.peek() == ',') {
+            ++cursor.pos;
+            continue;
+        }
+        if (!cursor.consume('}', "expected ',' or '}'")) {
+            return malformed();
+        }
+        closed = true;
+    }
+
+    if (!hasId || !hasName || trimView(name).empty()) {  // Same rule as a blank CSV name cell.
+        warnings.emplace_back("Skipping line " + std::to_string(lineNumber) +
+                              ": expected course ID and name.");
+        return false;
+    }
+
+    return buildCourseRecord(trimView(id), trimView(name), prerequisites, lineNumber, idScheme, course, warnings);
+}
+
+std::size_t readJsonLines(string_view contents,
+                          const ColumnMapping& mapping,
+                          const CourseIdScheme& idScheme,
+                          const CancellationToken& cancellation,
+                          TaskPriority priority,
+                          std::vector<string>& warnings,
+                          const std::function<void(Course&)>& sink,
+                          bool& cancelled,
+                          const std::function<void(const Course&)>& parsed) {
+    // Parses [begin, end) line by line; firstLine is the 1-based number of its first line.
+    const auto parseRange = [&mapping, &idScheme, &cancellation, &parsed](string_view range, std::size_t firstLine,
+                                                                          std::vector<string>& rangeWarnings,
+                                                                          const auto& onCourse) {
+        JsonLineParser parser(mapping, idScheme);
+        CancellationCheckpoint checkpoint(cancellation);
+        string repaired;
+        Course course;
+        std::size_t lineNumber = firstLine;
+        std::size_t pos = 0;
+        while (pos < range.size()) {
+            if (checkpoint.shouldStop()) {
+                return true;
+            }
+            const std::size_t end = findByte(range.data(), range.size(), pos, '\n');
+            string_view line = trimView(range.substr(pos, end - pos));
+            if (!line.empty()) {
+                line = repairUtf8Line(line, lineNumber, repaired, rangeWarnings);
+            }
+            if (!line.empty() && parser.parse(line, lineNumber, course, rangeWarnings)) {
+                if (parsed) {
+                    parsed(course);
+                }
+                onCourse(course);
+            }
+            pos = end + 1;
+            ++lineNumber;
+        }
+        return false;
+    };
+
+    const std::size_t totalLines = countNewlines(contents.data(), contents.size()) +
+                                   ((!contents.empty() && contents.back() != '\n') ? 1 : 0);
+
+    // A few chunks per worker keep the pool balanced and give batch loads frequent yield points.
+    WorkerPool& pool = WorkerPool::shared();
+    const std::size_t chunkCount = std::min(pool.size() * kChunksPerWorker, contents.size() / kMinChunkBytes);
+    if (contents.size() < kParallelThresholdBytes || pool.size() < 2 || chunkCount < 2) {
+        cancelled = parseRange(contents, 1, warnings, sink);
+        return totalLines;
+    }
+
+    // Split at newline boundaries so every chunk holds whole records.
+    struct Chunk {
+        string_view text;
+        std::size_t firstLine = 1;
+        std::vector<Course> courses;
+        std::vector<string> warnings;
+        bool stopped = false;
+    };
+    std::vector<Chunk> chunks;
+    std::size_t begin = 0;
+    std::size_t nextLine = 1;
+    for (std::size_t i = 0; i < chunkCount && begin < contents.size(); ++i) {
+        std::size_t end = (i + 1 == chunkCount) ? contents.size()
+                                                : std::max(begin, contents.size() * (i + 1) / chunkCount);
+        end = std::min(contents.size(), findByte(contents.data(), contents.size(), end, '\n') + 1);
+        Chunk chunk;
+        chunk.text = contents.substr(begin, end - begin);
+        chunk.firstLine = nextLine;
+        nextLine += countNewlines(chunk.text.data(), chunk.text.size());
+        chunks.push_back(std::move(chunk));
+        begin = end;
+    }
+
+    pool.forEachSlice(priority, chunks.size(), 1, [&chunks, &parseRange](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            Chunk& chunk = chunks[i];
+            chunk.stopped = parseRange(chunk.text, chunk.firstLine, chunk.warnings,
+                                       [&chunk](Course& course) { chunk.courses.push_back(std::move(course)); });
+        }
+    });
+
+    // Replay in file order so duplicate handling and warnings match a serial parse.
+    for (auto& chunk : chunks) {
+        warnings.insert(warnings.end(), chunk.warnings.begin(), chunk.warnings.end());
+        cancelled = cancelled || chunk.stopped;
+    }
+    if (!cancelled) {
+        for (auto& chunk : chunks) {
+            for (auto& course : chunk.courses) {
+                sink(course);
+            }
+            std::vector<Course>().swap(chunk.courses);  // Release each chunk as soon as it is consumed.
+        }
+    }
+    return totalLines;
+}
@@ -0,0 +1,242 @@
+#include "catalog/query_protocol.hpp"
+
+#include "catalog/tracepoints.hpp"
+#include "catalog/wire_format.hpp"
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+
+namespace {
+
+using std::string;
+using std::string_view;
+
+// Pending responses are written out once they reach this size even mid-burst.
+constexpr std::size_t kFlushBytes = 64 << 10;
+
+// Reserves the length prefix for a frame and returns where it starts.
+std::size_t beginFrame(string& out) {
+    const std::size_t start = out.size();
+    putU32(out, 0);
+    return start;
+}
+
+// Patches the length prefix once the payload is complete.
+void endFrame(string& out, std::size_t start) {
+    const auto length = static_cast<std::uint32_t>(out.size() - start - 4);
+    for (int i = 0; i < 4; ++i) {
+        out[start + static_cast<std::size_t>(i)] = static_cast<char>(length >> (i * 8));
+    }
+}
+
+void putResponseHeader(string& out, QueryStatus status, std::uint32_t requestId) {
+    out.push_back(static_cast<char>(status));
+    putU32(out, requestId);
+}
+
+}  // namespace
+
+string encodeInfoRequest(std::uint32_t requestId) {
+    string frame;
+    const std::size_t start = beginFrame(frame);
+    frame.push_back(static_cast<char>(QueryOpcode::Info));
+    putU32(frame, requestId);
+    endFrame(frame, start);
+    return frame;
+}
+
+string encodeResolveRequest(std::uint32_t requestId, const std::vector<string>& courseIds) {
+    string frame;
+    const std::size_t start = beginFrame(frame);
+    frame.push_back(static_cast<char>(QueryOpcode::Resolve));
+    putU32(frame, requestId);
+    putVarint(frame, courseIds.size());
+    for (const auto& id : courseIds) {
+        putString(frame, id);
+    }
+    endFrame(frame, start);
+    return frame;
+}
+
+string encodeGetRequest(std::uint32_t requestId, std::uint64_t generation,
+                        const std::vector<std::uint32_t>& handles) {
+    string frame;
+    const std::size_t start = beginFrame(frame);
+    frame.push_back(static_cast<char>(QueryOpcode::Get));
+    putU32(frame, requestId);
+    putU64(frame, generation);
+    putVarint(frame, handles.size());
+    for (const std::uint32_t handle : handles) {
+        putVarint(frame, handle);
+    }
+    endFrame(frame, start);
+    return frame;
+}
+
+bool takeQueryResponse(string_view& buffer, QueryResponse& response) {
+    ByteReader prefix{buffer};
+    const std::uint32_t length = prefix.u32();
+    if (!prefix.ok || prefix.remaining() < length) {
+        return false;
+    }
+
+    ByteReader payload{buffer.substr(4, length)};
+    response.status = static_cast<QueryStatus>(payload.u8());
+    response.requestId = payload.u32();
+    response.body = payload.bytes.substr(std::min(payload.pos, payload.bytes.size()));
+    buffer.remove_prefix(4 + static_cast<std::size_t>(length));
+    return payload.ok;
+}
+
+QueryProcessor::QueryProcessor(const Catalog& catalogToServe, std::pmr::memory_resource* scratch)
+    : catalog(catalogToServe), graph(scratch) {}
+
+void QueryProcessor::refreshIndex() {
+    if (!graph.isCurrent(catalog)) {
+        graph.build(catalog);
+    }
+}
+
+std::uint64_t QueryProcessor::handleTag(string_view id) const {
+    const std::uint32_t handle = graph.handleOf(id);
+    return handle == CourseGraph::kMissing ? 0 : static_cast<std::uint64_t>(handle) + 1;
+}
+
+void QueryProcessor::handle(string_view payload, string& out) {
+    const int opcode = payload.empty() ? 0 : static_cast<unsigned char>(payload[0]);
+    ByteReader header{payload.substr(std::min<std::size_t>(payload.size(), 1))};
+    const std::uint32_t requestId = header.u32();
+    CATALOG_TRACE3(query__start, opcode, requestId, payload.size());
+
+    const std::size_t start = out.size();
+    answer(payload, out);
+    CATALOG_TRACE4(query__done, opcode, requestId, static_cast<int>(static_cast<unsigned char>(out[start + 4])),
+                   out.size() - start);
+}
+
+void QueryProcessor::answer(string_view payload, string& out) {
+    ByteReader request{payload};
+    const auto opcode = static_cast<QueryOpcode>(request.u8());
+    const std::uint32_t requestId = request.u32();
+
+    const std::size_t start = beginFrame(out);
+    const auto reject = [&](QueryStatus status) {
+        out.resize(start + 4);  // Drop any partial body.
+        putResponseHeader(out, status, requestId);
+        endFrame(out, start);
+    };
+    if (!request.ok) {
+        reject(QueryStatus::BadRequest);
+        return;
+    }
+
+    const std::vector<string>& ids = catalog.sortedIds();
+    const std::uint64_t generation = catalog.generation();
+    putResponseHeader(out, QueryStatus::Ok, requestId);
+
+    switch (opcode) {
+        case QueryOpcode::Info:
+            putU64(out, generation);
+            putVarint(out, ids.size());
+            break;
+
+        case QueryOpcode::Resolve: {
+            const std::size_t count = request.count();
+            putU64(out, generation);
+            putVarint(out, count);
+            refreshIndex();
+            for (std::size_t i = 0; i < count && request.ok; ++i) {
+                putVarint(out, handleTag(request.view()));
+            }
+            break;
+        }
+
+        case QueryOpcode::Get: {
+            const std::uint64_t requestedGeneration = request.u64();
+            const std::size_t count = request.count();
+            if (request.ok && requestedGeneration != generation) {
+                out.resize(start + 4);
+                putResponseHeader(out, QueryStatus::StaleGeneration, requestId);
+                putU64(out, generation);
+                endFrame(out, start);
+                return;
+            }
+            putU64(out, generation);
+            refreshIndex();
+            for (std::size_t i = 0; i < count && request.ok; ++i) {
+                const std::uint64_t handle = request.varint();
+                if (handle >= graph.size()) {
+                    out.push_back(0);
+                    continue;
+                }
+                const Course& course = graph.course(handle);
+                const auto prereqHandles = graph.prerequisites(handle);
+                out.push_back(1);
+                putString(out, course.courseNumber);
+                putString(out, course.courseName);
+                putVarint(out, prereqHandles.size());
+                for (std::size_t p = 0; p < prereqHandles.size(); ++p) {
+                    if (prereqHandles[p] == CourseGraph::kMissing) {
+                        putVarint(out, 0);
+                        putString(out, course.prerequisites[p]);
+                    } else {
+                        putVarint(out, static_cast<std::uint64_t>(prereqHandles[p]) + 1);
+                    }
+                }
+            }
+            break;
+        }
+
+        default:
+            reject(QueryStatus::UnknownOpcode);
+            return;
+    }
+
+    if (!request.ok || request.remaining() != 0) {
+        reject(QueryStatus::BadRequest);
+        return;
+    }
+    endFrame(out, start);
+}
+
+std::size_t serveBinaryQueries(std::istream& input, std::ostream& output, const Catalog& catalog,
+                               std::pmr::memory_resource* scratch) {
+    QueryProcessor processor(catalog, scratch);
+    std::size_t answered = 0;
+    string payload;
+    string pending;
+
+    const auto flush = [&output, &pending]() {
+        output.write(pending.data(), static_cast<std::streamsize>(pending.size()));
+        output.flush();
+        pending.clear();
+    };
+
+    char prefix[4];
+    while (input.read(prefix, sizeof(prefix))) {
+        ByteReader lengthReader{string_view(prefix, sizeof(prefix))};
+        const std::uint32_t length = lengthReader.u32();
+        if (length > kMaxQueryFrameBytes) {
+            // The stream cannot be resynchronized after a bogus length, so end the session.
+            const std::size_t start = beginFrame(pending);
+            putResponseHeader(pending, QueryStatus::BadRequest, 0);
+            endFrame(pending, start);
+            break;
+        }
+
+        payload.resize(length);
+        if (!input.read(payload.data(), static_cast<std::streamsize>(length))) {
+            break;
+        }
+        processor.handle(payload, pending);
+        ++answered;
+
+        if (pending.size() >= kFlushBytes || input.rdbuf()->in_avail() <= 0) {
+            flush();
+        }
+    }
+
+    flush();
+    return answered;
+}
@@ -0,0 +1,55 @@
+#include "catalog/reclaimer.hpp"
+
+CatalogReclaimer& CatalogReclaimer::instance() {
+    static CatalogReclaimer reclaimer;
+    return reclaimer;
+}
+
+CatalogReclaimer::~CatalogReclaimer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (worker.joinable()) {
+        worker.join();  // The worker frees whatever is still queued before it exits.
+    }
+}
+
+void CatalogReclaimer::drain() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return pending.empty() && !busy; });
+}
+
+void CatalogReclaimer::enqueue(std::shared_ptr<void> garbage) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(std::move(garbage));
+        if (!worker.joinable()) {
+            worker = std::thread(&CatalogReclaimer::run, this);
+        }
+    }
+    wake.notify_one();
+}
+
+// Pops retired objects one at a time and lets them go out of scope outside the lock.
+void CatalogReclaimer::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !pending.empty(); });
+        if (pending.empty()) {
+            return;  // Only reachable once stopping is set and the queue is drained.
+        }
+
+        std::shared_ptr<void> garbage = std::move(pending.front());
+        pending.pop_front();
+        busy = true;
+        lock.unlock();
+        garbage.reset();  // The expensive destructor runs here, off the caller's thread.
+        lock.lock();
+        busy = false;
+        if (pending.empty()) {
+            idle.notify_all();
+        }
+    }
+}
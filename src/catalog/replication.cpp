@@ -0,0 +1,204 @@
+#include "catalog/replication.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+
+namespace {
+
+namespace fs = std::filesystem;
+using std::string;
+
+string snapshotName(std::uint64_t generation) {
+    return "snapshot-" + std::to_string(generation) + ".bin";
+}
+
+string deltaName(std::uint64_t fromGeneration, std::uint64_t toGeneration) {
+    return "delta-" + std::to_string(fromGeneration) + "-" + std::to_string(toGeneration) + ".bin";
+}
+
+bool readWholeFile(const fs::path& path, string& contents) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        return false;
+    }
+    contents.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    return !input.bad();
+}
+
+// Writes under a temporary name first so a reader never opens a half-written file.
+bool writeFileAtomically(const fs::path& path, const string& contents, string& error) {
+    fs::path temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream output(temporary, std::ios::binary | std::ios::trunc);
+        output.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        if (!output) {
+            error = "could not write " + temporary.string();
+            return false;
+        }
+    }
+    std::error_code renameError;
+    fs::rename(temporary, path, renameError);
+    if (renameError) {
+        error = "could not rename " + temporary.string() + ": " + renameError.message();
+        return false;
+    }
+    return true;
+}
+
+// Highest generation with a snapshot in the directory, or 0 when there is none.
+std::uint64_t newestSnapshotGeneration(const fs::path& directory) {
+    std::uint64_t newest = 0;
+    std::error_code listError;
+    for (const auto& entry : fs::directory_iterator(directory, listError)) {
+        const string name = entry.path().filename().string();
+        constexpr std::string_view kPrefix = "snapshot-";
+        constexpr std::string_view kSuffix = ".bin";
+        if (name.size() <= kPrefix.size() + kSuffix.size() || name.compare(0, kPrefix.size(), kPrefix) != 0 ||
+            name.compare(name.size() - kSuffix.size(), kSuffix.size(), kSuffix) != 0) {
+            continue;
+        }
+        const string digits = name.substr(kPrefix.size(), name.size() - kPrefix.size() - kSuffix.size());
+        if (digits.size() > 19 || digits.find_first_not_of("0123456789") != string::npos) {
+            continue;
+        }
+        newest = std::max<std::uint64_t>(newest, std::stoull(digits));
+    }
+    return newest;
+}
+
+// Loads snapshot-<generation>.bin into image, reporting problems through warnings.
+bool loadSnapshot(const fs::path& directory, std::uint64_t generation, CatalogImage& image,
+                  std::vector<string>& warnings) {
+    const fs::path path = directory / snapshotName(generation);
+    string bytes;
+    string error;
+    if (!readWholeFile(path, bytes)) {
+        warnings.emplace_back("Could not read " + path.string() + ".");
+        return false;
+    }
+    if (!decodeSnapshot(bytes, image, error)) {
+        warnings.emplace_back("Ignoring " + path.string() + ": " + error + ".");
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+CatalogPublisher::CatalogPublisher(string publishDirectory)
+    : directory(std::move(publishDirectory)) {}
+
+PublishResult CatalogPublisher::publish(const Catalog& catalog) {
+    PublishResult result;
+    std::error_code createError;
+    fs::create_directories(directory, createError);
+    if (createError) {
+        result.warnings.emplace_back("Could not create " + directory + ": " + createError.message() + ".");
+        return result;
+    }
+
+    if (!lastPublished) {
+        // Resume numbering (and delta shipping) from whatever an earlier run published.
+        if (const std::uint64_t newest = newestSnapshotGeneration(directory); newest != 0) {
+            CatalogImage previous;
+            if (loadSnapshot(directory, newest, previous, result.warnings)) {
+                lastPublished = std::move(previous);
+            }
+        }
+    }
+
+    const std::uint64_t nextGeneration = lastPublished ? lastPublished->generation + 1 : 1;
+    CatalogImage current = imageOf(catalog, nextGeneration);
+    if (lastPublished && current.checksum == lastPublished->checksum) {
+        result.ok = true;
+        result.unchanged = true;
+        result.generation = lastPublished->generation;
+        return result;
+    }
+
+    string error;
+    if (lastPublished) {
+        const string delta = encodeDelta(*lastPublished, current);
+        if (!writeFileAtomically(fs::path(directory) / deltaName(lastPublished->generation, nextGeneration),
+                                 delta, error)) {
+            result.warnings.emplace_back("Publishing failed: " + error + ".");
+            return result;
+        }
+        result.deltaBytes = delta.size();
+    }
+
+    const string snapshot = encodeSnapshot(current);
+    if (!writeFileAtomically(fs::path(directory) / snapshotName(nextGeneration), snapshot, error)) {
+        result.warnings.emplace_back("Publishing failed: " + error + ".");
+        return result;
+    }
+    result.snapshotBytes = snapshot.size();
+
+    if (lastPublished) {
+        // Only the newest snapshot is kept; replicas that are current only need deltas.
+        std::error_code removeError;
+        fs::remove(fs::path(directory) / snapshotName(lastPublished->generation), removeError);
+    }
+
+    lastPublished = std::move(current);
+    result.ok = true;
+    result.generation = nextGeneration;
+    return result;
+}
+
+CatalogReplica::CatalogReplica(string replicaDirectory)
+    : directory(std::move(replicaDirectory)) {}
+
+LoadResult CatalogReplica::sync(Catalog& target) {
+    LoadResult result;
+    result.path = directory;
+    bool changed = false;
+    bool needSnapshot = image.generation == 0;
+
+    while (!needSnapshot) {
+        const fs::path path = fs::path(directory) / deltaName(image.generation, image.generation + 1);
+        string bytes;
+        if (!readWholeFile(path, bytes)) {
+            break;  // Caught up (or the next delta has not been published yet).
+        }
+        string error;
+        if (!applyDelta(bytes, image, error)) {
+            result.warnings.emplace_back("Ignoring " + path.string() + ": " + error + ".");
+            needSnapshot = true;
+            break;
+        }
+        changed = true;
+    }
+
+    // A newer snapshot with no delta chain leading to it means this replica fell behind.
+    const std::uint64_t newest = newestSnapshotGeneration(directory);
+    if (needSnapshot || newest > image.generation) {
+        if (newest == 0) {
+            result.warnings.emplace_back("No catalog snapshot found in " + directory + ".");
+        } else if (loadSnapshot(directory, newest, image, result.warnings)) {
+            changed = true;
+        }
+    }
+
+    if (image.generation == 0) {
+        return result;
+    }
+    if (!changed) {
+        result.ok = true;
+        result.courses = image.courses.size();
+        return result;
+    }
+
+    LoadResult built = target.build(image.courses, directory + " (generation " +
+                                                       std::to_string(image.generation) + ")");
+    built.warnings.insert(built.warnings.begin(), result.warnings.begin(), result.warnings.end());
+    return built;
+}
+
+std::uint64_t CatalogReplica::generation() const {
+    return image.generation;
+}
@@ -0,0 +1,147 @@
+#include "catalog/simd_scan.hpp"
+
+#include <bit>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CATALOG_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+#ifdef CATALOG_HAVE_SSE2
+// Loads 16 bytes without alignment requirements.
+inline __m128i load16(const char* data) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+// Bit i is set when byte i of the block equals `target`.
+inline unsigned matchMask(__m128i block, char target) {
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(target))));
+}
+#endif
+
+// Scalar tail shared by every scan: returns the first byte for which match() holds.
+template <typename Match>
+std::size_t scalarFind(const char* data, std::size_t size, std::size_t pos, Match match) {
+    for (; pos < size; ++pos) {
+        if (match(data[pos])) {
+            return pos;
+        }
+    }
+    return size;
+}
+
+}  // namespace
+
+std::size_t findQuoteOrBackslash(const char* data, std::size_t size, std::size_t pos) {
+#ifdef CATALOG_HAVE_SSE2
+    for (; pos + 16 <= size; pos += 16) {
+        const __m128i block = load16(data + pos);
+        const unsigned mask = matchMask(block, '"') | matchMask(block, '\\');
+        if (mask != 0) {
+            return pos + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+#endif
+    return scalarFind(data, size, pos, [](char ch) { return ch == '"' || ch == '\\'; });
+}
+
+std::size_t findJsonStructural(const char* data, std::size_t size, std::size_t pos) {
+#ifdef CATALOG_HAVE_SSE2
+    for (; pos + 16 <= size; pos += 16) {
+        const __m128i block = load16(data + pos);
+        const unsigned mask = matchMask(block, '"') | matchMask(block, '{') | matchMask(block, '}') |
+                              matchMask(block, '[') | matchMask(block, ']');
+        if (mask != 0) {
+            return pos + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+#endif
+    return scalarFind(data, size, pos, [](char ch) {
+        return ch == '"' || ch == '{' || ch == '}' || ch == '[' || ch == ']';
+    });
+}
+
+std::size_t findByte(const char* data, std::size_t size, std::size_t pos, char target) {
+    if (pos >= size) {
+        return size;
+    }
+    // memchr is already vectorized by every mainstream C library.
+    const void* hit = std::memchr(data + pos, target, size - pos);
+    return hit ? static_cast<std::size_t>(static_cast<const char*>(hit) - data) : size;
+}
+
+std::size_t countNewlines(const char* data, std::size_t size) {
+    std::size_t count = 0;
+    std::size_t pos = 0;
+#ifdef CATALOG_HAVE_SSE2
+    for (; pos + 16 <= size; pos += 16) {
+        count += static_cast<std::size_t>(std::popcount(matchMask(load16(data + pos), '\n')));
+    }
+#endif
+    for (; pos < size; ++pos) {
+        count += data[pos] == '\n' ? 1 : 0;
+    }
+    return count;
+}
+
+std::size_t validUtf8SequenceLength(const char* data, std::size_t size, std::size_t pos) {
+    const auto byte = [data](std::size_t i) { return static_cast<unsigned char>(data[i]); };
+    const unsigned char lead = byte(pos);
+    if (lead < 0x80) {
+        return 1;
+    }
+
+    std::size_t length = 0;
+    unsigned char minSecond = 0x80;
+    unsigned char maxSecond = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        minSecond = lead == 0xE0 ? 0xA0 : 0x80;  // Reject overlong three-byte forms.
+        maxSecond = lead == 0xED ? 0x9F : 0xBF;  // Reject UTF-16 surrogates.
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        minSecond = lead == 0xF0 ? 0x90 : 0x80;  // Reject overlong four-byte forms.
+        maxSecond = lead == 0xF4 ? 0x8F : 0xBF;  // Reject code points past U+10FFFF.
+    } else {
+        return 0;  // Stray continuation byte, C0/C1 overlong lead, or F5..FF.
+    }
+
+    if (pos + length > size || byte(pos + 1) < minSecond || byte(pos + 1) > maxSecond) {
+        return 0;
+    }
+    for (std::size_t i = 2; i < length; ++i) {
+        if ((byte(pos + i) & 0xC0) != 0x80) {
+            return 0;
+        }
+    }
+    return length;
+}
+
+std::size_t findInvalidUtf8(const char* data, std::size_t size, std::size_t pos) {
+    while (pos < size) {
+#ifdef CATALOG_HAVE_SSE2
+        // Skip whole blocks whose bytes all have the high bit clear (pure ASCII).
+        while (pos + 16 <= size && _mm_movemask_epi8(load16(data + pos)) == 0) {
+            pos += 16;
+        }
+        if (pos >= size) {
+            break;
+        }
+#endif
+        if (static_cast<unsigned char>(data[pos]) < 0x80) {
+            ++pos;
+            continue;
+        }
+        const std::size_t length = validUtf8SequenceLength(data, size, pos);
+        if (length == 0) {
+            return pos;
+        }
+        pos += length;
+    }
+    return size;
+}
@@ -0,0 +1,453 @@
+#include "catalog/snapshot.hpp"
+
+#include "catalog/crc32c.hpp"
+#include "catalog/wire_format.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+namespace {
+
+using std::string;
+using std::string_view;
+
+// File signatures; the trailing digit is the format version.
+constexpr string_view kSnapshotMagic = "CATSNAP2";
+constexpr string_view kUnsectionedSnapshotMagic = "CATSNAP1";
+constexpr string_view kDeltaMagic = "CATDLTA1";
+
+// A new section starts once the current one holds this many record bytes, which keeps a
+// lazy lookup's decode small while leaving the header a tiny fraction of the file.
+constexpr std::size_t kSectionBytes = 64 << 10;
+
+// SnapshotReader::sectionState values.
+constexpr std::uint8_t kSectionUnchecked = 0;
+constexpr std::uint8_t kSectionIntact = 1;
+constexpr std::uint8_t kSectionCorrupt = 2;
+
+// FNV-1a over a length-prefixed stream of every field, fed one course at a time.
+class ChecksumBuilder {
+public:
+    void add(const Course& course) {
+        addString(course.courseNumber);
+        addString(course.courseName);
+        addNumber(course.prerequisites.size());
+        for (const auto& prereq : course.prerequisites) {
+            addString(prereq);
+        }
+    }
+
+    std::uint64_t value() const { return hash; }
+
+private:
+    void addNumber(std::uint64_t number) {
+        for (int i = 0; i < 8; ++i) {
+            addByte(static_cast<unsigned char>(number >> (i * 8)));
+        }
+    }
+
+    void addString(string_view text) {
+        addNumber(text.size());
+        for (char ch : text) {
+            addByte(static_cast<unsigned char>(ch));
+        }
+    }
+
+    void addByte(unsigned char byte) {
+        hash ^= byte;
+        hash *= 0x100000001b3ULL;
+    }
+
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+};
+
+string sectionLabel(std::size_t section, std::size_t sectionCount) {
+    return "snapshot section " + std::to_string(section + 1) + " of " + std::to_string(sectionCount);
+}
+
+// Format 1: one FNV checksum over the whole image, so nothing can be checked piecemeal.
+bool decodeUnsectionedSnapshot(string_view bytes, CatalogImage& image, string& error) {
+    ByteReader reader{bytes};
+    reader.expect(kUnsectionedSnapshotMagic);
+    CatalogImage decoded;
+    decoded.generation = reader.u64();
+    decoded.checksum = reader.u64();
+    decoded.courses.resize(reader.count());
+    for (auto& course : decoded.courses) {
+        readCourse(reader, course);
+    }
+    if (!reader.ok || reader.remaining() != 0) {
+        error = "snapshot is truncated or malformed";
+        return false;
+    }
+    if (imageChecksum(decoded.courses) != decoded.checksum) {
+        error = "snapshot checksum mismatch";
+        return false;
+    }
+
+    image = std::move(decoded);
+    return true;
+}
+
+bool sameContent(const Course& left, const Course& right) {
+    return left.courseName == right.courseName && left.prerequisites == right.prerequisites;
+}
+
+/**
+ * Walks the result of applying removals and upserts to courses in ID order, calling
+ * visit(course) for every surviving record. Returns false when the delta is inconsistent
+ * with courses (unsorted entries or removing an ID that is not there).
+ */
+template <typename Visit>
+bool mergeDelta(std::vector<Course>& courses,
+                const std::vector<string>& removals,
+                std::vector<Course>& upserts,
+                Visit visit) {
+    std::size_t c = 0;
+    std::size_t u = 0;
+    std::size_t r = 0;
+    while (c < courses.size() || u < upserts.size()) {
+        const bool takeUpsert = c == courses.size() ||
+                                (u < upserts.size() && upserts[u].courseNumber <= courses[c].courseNumber);
+        if (takeUpsert) {
+            if (c < courses.size() && upserts[u].courseNumber == courses[c].courseNumber) {
+                ++c;  // Changed course: the upsert replaces it.
+            }
+            visit(upserts[u++]);
+            continue;
+        }
+
+        const string& id = courses[c].courseNumber;
+        if (r < removals.size() && removals[r] < id) {
+            return false;  // Removal of a course this image does not hold.
+        }
+        if (r < removals.size() && removals[r] == id) {
+            ++r;
+            ++c;
+            continue;
+        }
+        visit(courses[c++]);
+    }
+    return r == removals.size();
+}
+
+}  // namespace
+
+std::uint64_t imageChecksum(const std::vector<Course>& sortedCourses) {
+    ChecksumBuilder checksum;
+    for (const auto& course : sortedCourses) {
+        checksum.add(course);
+    }
+    return checksum.value();
+}
+
+CatalogImage imageOf(const Catalog& catalog, std::uint64_t generation) {
+    CatalogImage image;
+    image.generation = generation;
+    image.courses.reserve(catalog.size());
+    for (const auto& id : catalog.sortedIds()) {
+        if (const Course* course = catalog.get(id)) {
+            image.courses.push_back(*course);
+        }
+    }
+    image.checksum = imageChecksum(image.courses);
+    return image;
+}
+
+string encodeSnapshot(const CatalogImage& image) {
+    struct PendingSection {
+        std::size_t offset = 0;
+        std::size_t courses = 0;
+        const string* firstId = nullptr;
+    };
+
+    // Records go first so the header can list every section's size and CRC up front.
+    string records;
+    std::vector<PendingSection> sections;
+    for (const auto& course : image.courses) {
+        if (sections.empty() || records.size() - sections.back().offset >= kSectionBytes) {
+            sections.push_back({records.size(), 0, &course.courseNumber});
+        }
+        putCourse(records, course);
+        ++sections.back().courses;
+    }
+
+    string out(kSnapshotMagic);
+    putU64(out, image.generation);
+    putU64(out, image.checksum);
+    putVarint(out, image.courses.size());
+    putVarint(out, sections.size());
+    for (std::size_t i = 0; i < sections.size(); ++i) {
+        const std::size_t end = i + 1 < sections.size() ? sections[i + 1].offset : records.size();
+        const std::size_t length = end - sections[i].offset;
+        putVarint(out, sections[i].courses);
+        putVarint(out, length);
+        putU32(out, crc32c(records.data() + sections[i].offset, length));
+        putString(out, *sections[i].firstId);
+    }
+    putU32(out, crc32c(out.data(), out.size()));
+    out += records;
+    return out;
+}
+
+bool decodeSnapshot(string_view bytes, CatalogImage& image, string& error) {
+    if (bytes.starts_with(kUnsectionedSnapshotMagic)) {
+        return decodeUnsectionedSnapshot(bytes, image, error);
+    }
+
+    SnapshotReader reader;
+    if (!reader.open(bytes, error)) {
+        return false;
+    }
+
+    // Every section is checked and parsed by whichever worker decodes it, so the CRC pass
+    // costs no extra sweep over the file. The header checksum vouches for image.checksum,
+    // which spares the serial whole-image hash the unsectioned format needs.
+    CatalogImage decoded;
+    decoded.generation = reader.generation();
+    decoded.checksum = reader.checksum();
+    decoded.courses.resize(reader.courseCount());
+    const std::span<Course> courses(decoded.courses);
+    std::mutex failureMutex;
+    std::size_t firstFailure = reader.sectionCount();
+    string failure;
+    WorkerPool::shared().forEachSlice(TaskPriority::Interactive, reader.sectionCount(), 1,
+                                      [&](std::size_t first, std::size_t last) {
+        for (std::size_t section = first; section < last; ++section) {
+            string sectionError;
+            if (reader.readSection(section,
+                                   courses.subspan(reader.sectionFirstCourse(section),
+                                                   reader.sectionCourseCount(section)),
+                                   sectionError)) {
+                continue;
+            }
+            const std::lock_guard lock(failureMutex);
+            if (section < firstFailure) {
+                firstFailure = section;
+                failure = std::move(sectionError);
+            }
+        }
+    });
+    if (firstFailure != reader.sectionCount()) {
+        error = std::move(failure);
+        return false;
+    }
+
+    image = std::move(decoded);
+    return true;
+}
+
+bool SnapshotReader::open(string_view bytes, string& error) {
+    ByteReader reader{bytes};
+    if (!reader.expect(kSnapshotMagic)) {
+        error = bytes.starts_with(kUnsectionedSnapshotMagic)
+                    ? "snapshot predates per-section checksums; decode it whole instead"
+                    : "not a catalog snapshot";
+        return false;
+    }
+
+    const std::uint64_t generation = reader.u64();
+    const std::uint64_t checksum = reader.u64();
+    const std::size_t courseCount = reader.count();
+    std::vector<Section> table(reader.count());
+    std::size_t offset = 0;
+    std::size_t firstCourse = 0;
+    for (auto& section : table) {
+        section.courses = reader.count();
+        section.bytes = reader.count();
+        section.crc = reader.u32();
+        section.firstId = reader.view();
+        section.offset = offset;
+        section.firstCourse = firstCourse;
+        offset += section.bytes;
+        firstCourse += section.courses;
+    }
+    const std::size_t headerBytes = reader.pos;
+    const std::uint32_t headerCrc = reader.u32();
+    if (!reader.ok) {
+        error = "snapshot is truncated or malformed";
+        return false;
+    }
+    if (crc32c(bytes.data(), headerBytes) != headerCrc) {
+        error = "snapshot header failed its CRC-32C check";
+        return false;
+    }
+    if (firstCourse != courseCount || offset != reader.remaining()) {
+        error = "snapshot is truncated or malformed";
+        return false;
+    }
+
+    payload = bytes.substr(reader.pos);
+    sections = std::move(table);
+    sectionState = std::make_unique<std::atomic<std::uint8_t>[]>(sections.size());
+    imageGeneration = generation;
+    imageChecksumValue = checksum;
+    totalCourses = courseCount;
+    return true;
+}
+
+bool SnapshotReader::verifySection(std::size_t section) const {
+    std::atomic<std::uint8_t>& state = sectionState[section];
+    const std::uint8_t known = state.load(std::memory_order_acquire);
+    if (known != kSectionUnchecked) {
+        return known == kSectionIntact;
+    }
+    // Two threads may race to check the same section; both reach the same verdict.
+    const Section& entry = sections[section];
+    const bool intact = crc32c(payload.data() + entry.offset, entry.bytes) == entry.crc;
+    state.store(intact ? kSectionIntact : kSectionCorrupt, std::memory_order_release);
+    return intact;
+}
+
+bool SnapshotReader::verifyAll(TaskPriority priority) const {
+    std::atomic<bool> intact{true};
+    WorkerPool::shared().forEachSlice(priority, sections.size(), 4, [&](std::size_t first, std::size_t last) {
+        for (std::size_t section = first; section < last; ++section) {
+            if (!verifySection(section)) {
+                intact.store(false, std::memory_order_relaxed);
+            }
+        }
+    });
+    return intact.load();
+}
+
+std::vector<std::size_t> SnapshotReader::corruptSections() const {
+    std::vector<std::size_t> corrupt;
+    for (std::size_t section = 0; section < sections.size(); ++section) {
+        if (sectionState[section].load(std::memory_order_acquire) == kSectionCorrupt) {
+            corrupt.push_back(section);
+        }
+    }
+    return corrupt;
+}
+
+bool SnapshotReader::readSection(std::size_t section, std::span<Course> out, string& error) const {
+    if (!verifySection(section)) {
+        error = sectionLabel(section, sections.size()) + " failed its CRC-32C check";
+        return false;
+    }
+    const Section& entry = sections[section];
+    ByteReader reader{payload.substr(entry.offset, entry.bytes)};
+    for (auto& course : out.first(std::min(out.size(), entry.courses))) {
+        readCourse(reader, course);
+    }
+    if (out.size() != entry.courses || !reader.ok || reader.remaining() != 0) {
+        error = sectionLabel(section, sections.size()) + " is malformed";
+        return false;
+    }
+    return true;
+}
+
+std::optional<Course> SnapshotReader::find(string_view courseId, string& error) const {
+    // Sections hold sorted, disjoint ID ranges, so the last one starting at or before the
+    // ID is the only candidate.
+    const auto after = std::upper_bound(sections.begin(), sections.end(), courseId,
+                                        [](string_view id, const Section& entry) { return id < entry.firstId; });
+    if (after == sections.begin()) {
+        return std::nullopt;
+    }
+    const auto section = static_cast<std::size_t>(after - sections.begin()) - 1;
+    std::vector<Course> records(sections[section].courses);
+    if (!readSection(section, records, error)) {
+        return std::nullopt;
+    }
+    const auto match = std::lower_bound(records.begin(), records.end(), courseId,
+                                        [](const Course& course, string_view id) { return course.courseNumber < id; });
+    if (match == records.end() || match->courseNumber != courseId) {
+        return std::nullopt;
+    }
+    return std::move(*match);
+}
+
+string encodeDelta(const CatalogImage& before, const CatalogImage& after) {
+    std::vector<const string*> removals;
+    std::vector<const Course*> upserts;
+    std::size_t b = 0;
+    std::size_t a = 0;
+    while (b < before.courses.size() || a < after.courses.size()) {
+        if (a == after.courses.size() ||
+            (b < before.courses.size() && before.courses[b].courseNumber < after.courses[a].courseNumber)) {
+            removals.push_back(&before.courses[b++].courseNumber);
+        } else if (b == before.courses.size() ||
+                   after.courses[a].courseNumber < before.courses[b].courseNumber) {
+            upserts.push_back(&after.courses[a++]);
+        } else {
+            if (!sameContent(before.courses[b], after.courses[a])) {
+                upserts.push_back(&after.courses[a]);
+            }
+            ++b;
+            ++a;
+        }
+    }
+
+    string out(kDeltaMagic);
+    putU64(out, before.generation);
+    putU64(out, after.generation);
+    putU64(out, before.checksum);
+    putU64(out, after.checksum);
+    putVarint(out, removals.size());
+    for (const string* id : removals) {
+        putString(out, *id);
+    }
+    putVarint(out, upserts.size());
+    for (const Course* course : upserts) {
+        putCourse(out, *course);
+    }
+    return out;
+}
+
+bool applyDelta(string_view bytes, CatalogImage& image, string& error) {
+    ByteReader reader{bytes};
+    if (!reader.expect(kDeltaMagic)) {
+        error = "not a catalog delta";
+        return false;
+    }
+
+    const std::uint64_t fromGeneration = reader.u64();
+    const std::uint64_t toGeneration = reader.u64();
+    const std::uint64_t baseChecksum = reader.u64();
+    const std::uint64_t resultChecksum = reader.u64();
+    std::vector<string> removals(reader.count());
+    for (auto& id : removals) {
+        reader.text(id);
+    }
+    std::vector<Course> upserts(reader.count());
+    for (auto& course : upserts) {
+        readCourse(reader, course);
+    }
+    if (!reader.ok || reader.remaining() != 0) {
+        error = "delta is truncated or malformed";
+        return false;
+    }
+    if (fromGeneration != image.generation) {
+        error = "delta was cut against generation " + std::to_string(fromGeneration) +
+                " but this catalog is at generation " + std::to_string(image.generation);
+        return false;
+    }
+    if (baseChecksum != image.checksum) {
+        error = "delta base checksum does not match this catalog";
+        return false;
+    }
+
+    // Verify the result before touching image so a bad delta leaves it intact.
+    ChecksumBuilder checksum;
+    std::size_t resultSize = 0;
+    const bool consistent = mergeDelta(image.courses, removals, upserts, [&](const Course& course) {
+        checksum.add(course);
+        ++resultSize;
+    });
+    if (!consistent || checksum.value() != resultChecksum) {
+        error = "delta result checksum mismatch";
+        return false;
+    }
+
+    std::vector<Course> merged;
+    merged.reserve(resultSize);
+    mergeDelta(image.courses, removals, upserts, [&merged](Course& course) {
+        merged.push_back(std::move(course));
+    });
+    image.courses = std::move(merged);
+    image.generation = toGeneration;
+    image.checksum = resultChecksum;
+    return true;
+}
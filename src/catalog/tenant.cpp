@@ -0,0 +1,142 @@
+#include "catalog/tenant.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <new>
+
+QuotaMemoryResource::QuotaMemoryResource(std::size_t quota, std::pmr::memory_resource* upstreamResource)
+    : quotaBytes(quota), upstream(upstreamResource) {}
+
+std::size_t QuotaMemoryResource::quota() const {
+    return quotaBytes;
+}
+
+std::size_t QuotaMemoryResource::bytesInUse() const {
+    return inUse.load(std::memory_order_relaxed);
+}
+
+std::size_t QuotaMemoryResource::peakBytes() const {
+    return peak.load(std::memory_order_relaxed);
+}
+
+std::size_t QuotaMemoryResource::rejectedAllocations() const {
+    return rejected.load(std::memory_order_relaxed);
+}
+
+void QuotaMemoryResource::setExternalBytes(std::size_t bytes) {
+    external.store(bytes, std::memory_order_relaxed);
+}
+
+std::size_t QuotaMemoryResource::externalBytes() const {
+    return external.load(std::memory_order_relaxed);
+}
+
+std::size_t QuotaMemoryResource::headroom() const {
+    if (quotaBytes == 0) {
+        return std::numeric_limits<std::size_t>::max();
+    }
+    const std::size_t used = bytesInUse() + externalBytes();
+    return used >= quotaBytes ? 0 : quotaBytes - used;
+}
+
+void* QuotaMemoryResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    // Claim the bytes first so concurrent allocations cannot both slip under the quota.
+    const std::size_t before = inUse.fetch_add(bytes, std::memory_order_relaxed);
+    const std::size_t after = before + bytes;
+    if (quotaBytes != 0 && after + externalBytes() > quotaBytes) {
+        inUse.fetch_sub(bytes, std::memory_order_relaxed);
+        rejected.fetch_add(1, std::memory_order_relaxed);
+        throw std::bad_alloc();
+    }
+
+    void* pointer = nullptr;
+    try {
+        pointer = upstream->allocate(bytes, alignment);
+    } catch (...) {
+        inUse.fetch_sub(bytes, std::memory_order_relaxed);
+        throw;
+    }
+
+    std::size_t seen = peak.load(std::memory_order_relaxed);
+    while (after > seen && !peak.compare_exchange_weak(seen, after, std::memory_order_relaxed)) {
+    }
+    return pointer;
+}
+
+void QuotaMemoryResource::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) {
+    upstream->deallocate(pointer, bytes, alignment);
+    inUse.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+bool QuotaMemoryResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+Tenant::Tenant(std::string name, std::size_t quotaBytes)
+    : tenantName(std::move(name)),
+      pools(std::pmr::new_delete_resource()),
+      quotaResource(quotaBytes, &pools) {}
+
+const std::string& Tenant::name() const {
+    return tenantName;
+}
+
+const Catalog& Tenant::catalog() const {
+    return tenantCatalog;
+}
+
+std::pmr::memory_resource* Tenant::memory() {
+    return &quotaResource;
+}
+
+LoadResult Tenant::load(const std::string& fileName, LoadOptions options) {
+    options.reloadMode = ReloadMode::Rebuild;
+    if (quotaResource.quota() != 0) {
+        // The old catalog is released on success, so the new one may use its share too.
+        const std::size_t available = quotaResource.quota() - std::min(quotaResource.quota(),
+                                                                       quotaResource.bytesInUse());
+        options.memoryBudget = options.memoryBudget == 0 ? available : std::min(options.memoryBudget, available);
+    }
+
+    LoadResult result = tenantCatalog.load(fileName, options);
+    quotaResource.setExternalBytes(tenantCatalog.memoryFootprint());
+    return result;
+}
+
+TenantUsage Tenant::usage() const {
+    TenantUsage report;
+    report.name = tenantName;
+    report.quotaBytes = quotaResource.quota();
+    report.catalogBytes = quotaResource.externalBytes();
+    report.scratchBytes = quotaResource.bytesInUse();
+    report.peakScratchBytes = quotaResource.peakBytes();
+    report.rejectedAllocations = quotaResource.rejectedAllocations();
+    report.courses = tenantCatalog.size();
+    report.generation = tenantCatalog.generation();
+    return report;
+}
+
+Tenant& TenantRegistry::add(const std::string& name, std::size_t quotaBytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& slot = tenants[name];
+    if (!slot) {
+        slot = std::make_unique<Tenant>(name, quotaBytes);
+    }
+    return *slot;
+}
+
+Tenant* TenantRegistry::find(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto found = tenants.find(name);
+    return found == tenants.end() ? nullptr : found->second.get();
+}
+
+std::vector<TenantUsage> TenantRegistry::usage() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<TenantUsage> reports;
+    reports.reserve(tenants.size());
+    for (const auto& entry : tenants) {
+        reports.push_back(entry.second->usage());
+    }
+    return reports;
+}
@@ -0,0 +1,362 @@
+#include "catalog/timetable.hpp"
+
+#include "catalog/catalog_index.hpp"
+#include "catalog/course_parser.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <tuple>
+
+namespace {
+
+using std::string;
+using std::string_view;
+
+constexpr std::size_t kSectionColumns = 6;  // Course, section, days, start, end, capacity.
+constexpr string_view kDayLetters = "MTWRFSU";
+
+// Splits a row on commas; section files have no quoted text, so no quote handling.
+void splitCells(string_view row, std::vector<string_view>& cells) {
+    cells.clear();
+    for (std::size_t start = 0;;) {
+        const std::size_t comma = row.find(',', start);
+        cells.push_back(trimView(row.substr(start, comma == string_view::npos ? string_view::npos : comma - start)));
+        if (comma == string_view::npos) {
+            return;
+        }
+        start = comma + 1;
+    }
+}
+
+bool parseDays(string_view text, std::uint8_t& days) {
+    days = 0;
+    for (const char letter : text) {
+        const std::size_t day = kDayLetters.find(letter >= 'a' && letter <= 'z' ? static_cast<char>(letter - 'a' + 'A')
+                                                                                 : letter);
+        if (day == string_view::npos) {
+            return false;
+        }
+        days |= static_cast<std::uint8_t>(1u << day);
+    }
+    return days != 0;
+}
+
+// "9:05" or "09:05", 24-hour.
+bool parseClock(string_view text, std::uint16_t& minutes) {
+    const std::size_t colon = text.find(':');
+    if (colon == string_view::npos || colon == 0 || colon > 2 || text.size() != colon + 3) {
+        return false;
+    }
+    unsigned hours = 0;
+    for (std::size_t i = 0; i < colon; ++i) {
+        if (!isIdDigit(text[i])) {
+            return false;
+        }
+        hours = hours * 10 + static_cast<unsigned>(text[i] - '0');
+    }
+    if (!isIdDigit(text[colon + 1]) || !isIdDigit(text[colon + 2])) {
+        return false;
+    }
+    const unsigned minute = static_cast<unsigned>(text[colon + 1] - '0') * 10 + static_cast<unsigned>(text[colon + 2] - '0');
+    if (hours > 23 || minute > 59) {
+        return false;
+    }
+    minutes = static_cast<std::uint16_t>(hours * 60 + minute);
+    return true;
+}
+
+bool parseCapacity(string_view text, std::uint32_t& capacity) {
+    if (text.empty() || text.size() > 9 || !std::all_of(text.begin(), text.end(), isIdDigit)) {
+        return false;
+    }
+    capacity = 0;
+    for (const char digit : text) {
+        capacity = capacity * 10 + static_cast<std::uint32_t>(digit - '0');
+    }
+    return true;
+}
+
+void appendClock(string& out, std::uint16_t minutes) {
+    out += static_cast<char>('0' + minutes / 600);
+    out += static_cast<char>('0' + minutes / 60 % 10);
+    out += ':';
+    out += static_cast<char>('0' + minutes % 60 / 10);
+    out += static_cast<char>('0' + minutes % 10);
+}
+
+}  // namespace
+
+std::string formatSectionTime(const Section& section) {
+    string text;
+    for (std::size_t day = 0; day < kDaysPerWeek; ++day) {
+        if ((section.days & (1u << day)) != 0) {
+            text += kDayLetters[day];
+        }
+    }
+    text += ' ';
+    appendClock(text, section.startMinute);
+    text += '-';
+    appendClock(text, section.endMinute);
+    return text;
+}
+
+TimetableLoadResult Timetable::load(const std::string& fileName, const Catalog& catalog,
+                                    const CourseIdScheme& idScheme) {
+    TimetableLoadResult result;
+    result.path = fileName;
+    std::ifstream input(fileName, std::ios::binary);
+    if (!input) {
+        result.warnings.emplace_back("Unable to open file: " + fileName);
+        return result;
+    }
+
+    std::vector<Section> loaded;
+    std::vector<string_view> cells;
+    string line;
+    string repaired;
+    string courseId;
+    std::size_t lineNumber = 0;
+    bool sawRow = false;
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        string_view row = trimView(lineNumber == 1 ? stripUtf8Bom(line) : string_view(line));
+        if (row.empty()) {
+            continue;
+        }
+        row = repairUtf8Line(row, lineNumber, repaired, result.warnings);
+        splitCells(row, cells);
+
+        const bool validId = idScheme.normalize(cells[0], courseId);
+        if (!sawRow && !validId) {
+            sawRow = true;  // A header row names the columns; their order is fixed.
+            continue;
+        }
+        sawRow = true;
+
+        const string where = "Skipping line " + std::to_string(lineNumber) + ": ";
+        if (!validId) {
+            result.warnings.emplace_back(where + "invalid course ID '" + string(cells[0]) + "'.");
+            continue;
+        }
+        if (cells.size() < kSectionColumns) {
+            result.warnings.emplace_back(where + "expected course, section, days, start, end, and capacity.");
+            continue;
+        }
+        if (catalog.get(courseId) == nullptr) {
+            result.warnings.emplace_back(where + "course " + courseId + " is not in the catalog.");
+            continue;
+        }
+
+        Section section;
+        section.courseNumber = courseId;
+        section.sectionId = toUpperCopy(cells[1]);
+        if (section.sectionId.empty()) {
+            result.warnings.emplace_back(where + "the section ID is empty.");
+        } else if (!parseDays(cells[2], section.days)) {
+            result.warnings.emplace_back(where + "days '" + string(cells[2]) + "' are not letters from MTWRFSU.");
+        } else if (!parseClock(cells[3], section.startMinute) || !parseClock(cells[4], section.endMinute) ||
+                   section.endMinute <= section.startMinute) {
+            result.warnings.emplace_back(where + "times must be HH:MM with the end after the start.");
+        } else if (!parseCapacity(cells[5], section.capacity)) {
+            result.warnings.emplace_back(where + "capacity '" + string(cells[5]) + "' is not a whole number.");
+        } else {
+            loaded.push_back(std::move(section));
+        }
+    }
+    if (input.bad()) {
+        result.warnings.emplace_back("Unable to read file: " + fileName);
+        return result;
+    }
+
+    std::stable_sort(loaded.begin(), loaded.end(), [](const Section& left, const Section& right) {
+        return std::tie(left.courseNumber, left.sectionId) < std::tie(right.courseNumber, right.sectionId);
+    });
+    // Stable, so the first row for a repeated section is the one kept.
+    const auto repeated = std::unique(loaded.begin(), loaded.end(), [&](const Section& kept, const Section& next) {
+        const bool same = kept.courseNumber == next.courseNumber && kept.sectionId == next.sectionId;
+        if (same) {
+            result.warnings.emplace_back("Duplicate section " + next.courseNumber + " " + next.sectionId + " ignored.");
+        }
+        return same;
+    });
+    loaded.erase(repeated, loaded.end());
+
+    sectionList = std::move(loaded);
+    buildIndex(catalog);
+    result.ok = true;
+    result.sections = sectionList.size();
+    return result;
+}
+
+void Timetable::buildIndex(const Catalog& catalog) {
+    offeredCourses.clear();
+    courseSlots.clear();
+    prerequisiteSlots.clear();
+    for (std::uint32_t handle = 0; handle < sectionList.size(); ++handle) {
+        if (handle == 0 || sectionList[handle].courseNumber != sectionList[handle - 1].courseNumber) {
+            courseSlots.try_emplace(sectionList[handle].courseNumber, static_cast<std::uint32_t>(offeredCourses.size()));
+            offeredCourses.push_back(OfferedCourse{handle, 0, 0, 0});
+        }
+        ++offeredCourses.back().sectionCount;
+    }
+    for (OfferedCourse& offered : offeredCourses) {
+        offered.firstPrerequisite = static_cast<std::uint32_t>(prerequisiteSlots.size());
+        for (const auto& prereq : catalog.get(sectionList[offered.firstSection].courseNumber)->prerequisites) {
+            const auto slot = courseSlots.try_emplace(prereq, static_cast<std::uint32_t>(courseSlots.size())).first;
+            prerequisiteSlots.push_back(slot->second);
+        }
+        offered.prerequisiteCount = static_cast<std::uint32_t>(prerequisiteSlots.size()) - offered.firstPrerequisite;
+    }
+    loadedAgainst = &catalog;
+    loadedGeneration = catalog.generation();
+
+    for (std::size_t day = 0; day < kDaysPerWeek; ++day) {
+        std::vector<MeetingNode>& tree = dayTrees[day];
+        tree.clear();
+        for (std::uint32_t handle = 0; handle < sectionList.size(); ++handle) {
+            const Section& section = sectionList[handle];
+            if ((section.days & (1u << day)) != 0) {
+                tree.push_back(MeetingNode{section.startMinute, section.endMinute, section.endMinute, handle});
+            }
+        }
+        std::sort(tree.begin(), tree.end(), [](const MeetingNode& left, const MeetingNode& right) {
+            return std::tie(left.startMinute, left.endMinute, left.section) <
+                   std::tie(right.startMinute, right.endMinute, right.section);
+        });
+
+        // Node of [first, last) is its midpoint; fill maxEnd bottom-up.
+        const auto fillMaxEnd = [&tree](auto& self, std::size_t first, std::size_t last) -> std::uint16_t {
+            if (first == last) {
+                return 0;
+            }
+            const std::size_t middle = first + (last - first) / 2;
+            MeetingNode& node = tree[middle];
+            node.maxEnd = std::max({node.endMinute, self(self, first, middle), self(self, middle + 1, last)});
+            return node.maxEnd;
+        };
+        fillMaxEnd(fillMaxEnd, 0, tree.size());
+    }
+}
+
+void Timetable::collectOverlaps(const std::vector<MeetingNode>& tree, std::size_t first, std::size_t last,
+                                std::uint16_t startMinute, std::uint16_t endMinute,
+                                std::vector<std::uint32_t>& handles) {
+    while (first < last) {
+        const std::size_t middle = first + (last - first) / 2;
+        const MeetingNode& node = tree[middle];
+        if (node.maxEnd <= startMinute) {
+            return;  // Everything in this subtree is over before the range starts.
+        }
+        collectOverlaps(tree, first, middle, startMinute, endMinute, handles);
+        if (node.startMinute >= endMinute) {
+            return;  // This node and everything after it start once the range is over.
+        }
+        if (node.endMinute > startMinute) {
+            handles.push_back(node.section);
+        }
+        first = middle + 1;
+    }
+}
+
+void Timetable::overlapping(std::uint8_t days, std::uint16_t startMinute, std::uint16_t endMinute,
+                            std::vector<std::uint32_t>& handles) const {
+    for (std::size_t day = 0; day < kDaysPerWeek; ++day) {
+        if ((days & (1u << day)) != 0) {
+            collectOverlaps(dayTrees[day], 0, dayTrees[day].size(), startMinute, endMinute, handles);
+        }
+    }
+}
+
+bool Timetable::isCurrent(const Catalog& catalog) const {
+    return loadedAgainst == &catalog && loadedGeneration == catalog.generation();
+}
+
+std::optional<std::uint32_t> Timetable::find(std::string_view courseId, std::string_view sectionId) const {
+    const auto offered = courseSlots.find(courseId);
+    if (offered == courseSlots.end() || offered->second >= offeredCourses.size()) {
+        return std::nullopt;
+    }
+    const OfferedCourse& course = offeredCourses[offered->second];
+    for (std::uint32_t handle = course.firstSection; handle < course.firstSection + course.sectionCount; ++handle) {
+        if (sectionList[handle].sectionId == sectionId) {
+            return handle;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<std::uint32_t> Timetable::sectionsOf(std::string_view courseId) const {
+    std::vector<std::uint32_t> handles;
+    if (const auto offered = courseSlots.find(courseId);
+        offered != courseSlots.end() && offered->second < offeredCourses.size()) {
+        const OfferedCourse& course = offeredCourses[offered->second];
+        for (std::uint32_t i = 0; i < course.sectionCount; ++i) {
+            handles.push_back(course.firstSection + i);
+        }
+    }
+    return handles;
+}
+
+std::vector<std::uint32_t> Timetable::openSections(const std::vector<std::string>& taken,
+                                                   const std::vector<std::uint32_t>& schedule) const {
+    // Courses that rule themselves out: completed ones (which also satisfy prerequisites) and scheduled ones.
+    std::vector<char> done(courseSlots.size(), 0);
+    std::vector<char> scheduled(offeredCourses.size(), 0);
+    for (const auto& id : taken) {
+        if (const auto slot = courseSlots.find(std::string_view(id)); slot != courseSlots.end()) {
+            done[slot->second] = 1;
+        }
+    }
+
+    // Every section that meets during a scheduled one.
+    std::vector<char> clashes(sectionList.size(), 0);
+    std::vector<std::uint32_t> overlaps;
+    for (const std::uint32_t handle : schedule) {
+        if (handle >= sectionList.size()) {
+            continue;
+        }
+        const Section& section = sectionList[handle];
+        overlaps.clear();
+        overlapping(section.days, section.startMinute, section.endMinute, overlaps);
+        for (const std::uint32_t overlap : overlaps) {
+            clashes[overlap] = 1;
+        }
+        scheduled[courseSlots.find(section.courseNumber)->second] = 1;
+    }
+
+    std::vector<std::uint32_t> open;
+    for (std::size_t slot = 0; slot < offeredCourses.size(); ++slot) {
+        const OfferedCourse& offered = offeredCourses[slot];
+        if (done[slot] != 0 || scheduled[slot] != 0) {
+            continue;
+        }
+        const auto prerequisites = prerequisiteSlots.begin() + offered.firstPrerequisite;
+        if (!std::all_of(prerequisites, prerequisites + offered.prerequisiteCount,
+                         [&done](std::uint32_t prereq) { return done[prereq] != 0; })) {
+            continue;
+        }
+        for (std::uint32_t handle = offered.firstSection; handle < offered.firstSection + offered.sectionCount;
+             ++handle) {
+            if (clashes[handle] == 0) {
+                open.push_back(handle);
+            }
+        }
+    }
+    return open;
+}
+
+std::size_t Timetable::memoryFootprint() const {
+    std::size_t bytes = sectionList.capacity() * sizeof(Section) + offeredCourses.capacity() * sizeof(OfferedCourse) +
+                        courseSlots.capacity() * (sizeof(std::pair<std::string, std::uint32_t>) + 1) +
+                        prerequisiteSlots.capacity() * sizeof(std::uint32_t);
+    for (const Section& section : sectionList) {
+        bytes += heapBytes(section.courseNumber) + heapBytes(section.sectionId);
+    }
+    for (const auto& [courseId, slot] : courseSlots) {
+        bytes += heapBytes(courseId);
+    }
+    for (const auto& tree : dayTrees) {
+        bytes += tree.capacity() * sizeof(MeetingNode);
+    }
+    return bytes;
+}
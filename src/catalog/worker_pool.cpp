@@ -0,0 +1,367 @@
+#include "catalog/worker_pool.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// Lets submit() and forEachSlice() recognize calls made from inside the pool.
+thread_local const WorkerPool* currentPool = nullptr;
+thread_local std::size_t currentWorker = 0;
+
+// A waiting worker with nothing to run yields this many times before it sleeps, and then
+// looks for new tasks this often while it sleeps.
+constexpr int kIdleSpins = 64;
+constexpr auto kWaitRecheck = std::chrono::milliseconds(1);
+
+// Guards the shared pool's size until its first use fixes it.
+std::mutex sharedSizeMutex;
+std::size_t configuredSharedSize = 0;
+bool sharedStarted = false;
+
+std::size_t priorityIndex(TaskPriority priority) {
+    return priority == TaskPriority::Interactive ? 0 : 1;
+}
+
+// CATALOG_WORKERS as a positive count, or 0 when it is unset or not a number.
+std::size_t workersFromEnvironment() {
+    const char* value = std::getenv("CATALOG_WORKERS");
+    if (value == nullptr) {
+        return 0;
+    }
+    std::size_t count = 0;
+    const char* end = value + std::strlen(value);
+    const auto [stop, error] = std::from_chars(value, end, count);
+    return error == std::errc() && stop == end ? count : 0;
+}
+
+// Size the shared pool starts with; later configureShared() calls are refused.
+std::size_t startSharedPool() {
+    std::lock_guard<std::mutex> lock(sharedSizeMutex);
+    sharedStarted = true;
+    if (configuredSharedSize != 0) {
+        return configuredSharedSize;
+    }
+    if (const std::size_t fromEnvironment = workersFromEnvironment(); fromEnvironment != 0) {
+        return fromEnvironment;
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void raiseToAtLeast(std::atomic<std::size_t>& peak, std::size_t value) {
+    std::size_t seen = peak.load(std::memory_order_relaxed);
+    while (seen < value && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+}  // namespace
+
+// Shared state of one forEachSlice() call; slices are claimed with a single atomic counter.
+struct WorkerPool::SliceJob {
+    const std::function<void(std::size_t, std::size_t)>* body = nullptr;
+    std::size_t count = 0;
+    std::size_t grain = 1;
+    std::size_t slices = 0;
+    std::atomic<std::size_t> nextSlice{0};
+    std::atomic<std::size_t> finishedSlices{0};
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+
+    // Claims and runs one slice; false once every slice has been claimed.
+    bool runOne() {
+        const std::size_t slice = nextSlice.fetch_add(1);
+        if (slice >= slices) {
+            return false;
+        }
+        const std::size_t begin = slice * grain;
+        try {
+            (*body)(begin, std::min(count, begin + grain));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        if (finishedSlices.fetch_add(1) + 1 == slices) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.notify_all();
+        }
+        return true;
+    }
+
+    bool finished() const { return finishedSlices.load() == slices; }
+};
+
+WorkerPool& WorkerPool::shared() {
+    static WorkerPool pool(startSharedPool());
+    return pool;
+}
+
+bool WorkerPool::configureShared(std::size_t workerCount) {
+    std::lock_guard<std::mutex> lock(sharedSizeMutex);
+    if (sharedStarted) {
+        return false;
+    }
+    configuredSharedSize = workerCount;
+    return true;
+}
+
+WorkerPool::WorkerPool(std::size_t workerCount) {
+    workerCount = std::max<std::size_t>(1, workerCount);
+    for (std::size_t i = 0; i < workerCount; ++i) {
+        queues.push_back(std::make_unique<WorkerQueues>());
+    }
+    for (std::size_t i = 0; i < workerCount; ++i) {
+        threads.emplace_back(&WorkerPool::workerLoop, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& thread : threads) {
+        thread.join();  // Workers finish whatever is still queued before they exit.
+    }
+}
+
+std::size_t WorkerPool::size() const {
+    return queues.size();
+}
+
+void WorkerPool::submit(TaskPriority priority, std::function<void()> task) {
+    const std::size_t target = currentPool == this ? currentWorker : nextQueue.fetch_add(1) % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks[priorityIndex(priority)].push_back(std::move(task));
+        raiseToAtLeast(peakQueuedTasks, ++queuedTasks);
+        if (priority == TaskPriority::Interactive) {
+            ++queuedInteractive;
+        }
+    }
+    tasksSubmitted.fetch_add(1, std::memory_order_relaxed);
+    {
+        // Pairs with the predicate check in workerLoop so a sleeping worker cannot miss this task.
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wake.notify_one();
+}
+
+bool WorkerPool::runOneTask(std::size_t self, TaskPriority lowest) {
+    const std::size_t workerCount = queues.size();
+    for (std::size_t priority = 0; priority <= priorityIndex(lowest); ++priority) {
+        for (std::size_t offset = 0; offset < workerCount; ++offset) {
+            WorkerQueues& victim = *queues[(self + offset) % workerCount];
+            std::function<void()> task;
+            {
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                auto& deque = victim.tasks[priority];
+                if (deque.empty()) {
+                    continue;
+                }
+                // Owners take their newest task (still warm in cache); thieves take the oldest.
+                if (offset == 0) {
+                    task = std::move(deque.back());
+                    deque.pop_back();
+                } else {
+                    task = std::move(deque.front());
+                    deque.pop_front();
+                }
+                --queuedTasks;
+                if (priority == 0) {
+                    --queuedInteractive;
+                }
+            }
+            WorkerQueues& own = *queues[self];
+            own.tasksRun.fetch_add(1, std::memory_order_relaxed);
+            if (offset != 0) {
+                own.steals.fetch_add(1, std::memory_order_relaxed);
+            }
+            task();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkerPool::workerLoop(std::size_t index) {
+    currentPool = this;
+    currentWorker = index;
+    while (true) {
+        if (runOneTask(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if (!stopping && queuedTasks.load() == 0) {
+            queues[index]->sleeps.fetch_add(1, std::memory_order_relaxed);
+        }
+        wake.wait(lock, [this] { return stopping || queuedTasks.load() > 0; });
+        if (stopping && queuedTasks.load() == 0) {
+            return;
+        }
+    }
+}
+
+void WorkerPool::helpUntil(TaskPriority priority, std::mutex& mutex, std::condition_variable& done,
+                           const std::function<bool()>& finished) {
+    int idleSpins = 0;
+    while (!finished()) {
+        if (runOneTask(currentWorker, priority)) {
+            idleSpins = 0;
+            continue;
+        }
+        if (++idleSpins < kIdleSpins) {
+            std::this_thread::yield();
+            continue;
+        }
+        // Whatever is left is running on other threads; sleep, but not past new work.
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait_for(lock, kWaitRecheck, finished);
+        idleSpins = kIdleSpins - 1;
+    }
+}
+
+void WorkerPool::runSlices(TaskPriority priority, const std::shared_ptr<SliceJob>& job) {
+    while (job->runOne()) {
+        if (priority == TaskPriority::Batch && queuedInteractive.load() > 0) {
+            // Hand the worker to the interactive task; the rest of this job goes back in line.
+            batchYields.fetch_add(1, std::memory_order_relaxed);
+            submit(TaskPriority::Batch, [this, priority, job]() { runSlices(priority, job); });
+            return;
+        }
+    }
+}
+
+void WorkerPool::forEachSlice(TaskPriority priority, std::size_t count, std::size_t grain,
+                              const std::function<void(std::size_t, std::size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+
+    sliceJobs.fetch_add(1, std::memory_order_relaxed);
+    auto job = std::make_shared<SliceJob>();
+    job->body = &body;
+    job->count = count;
+    job->grain = std::max<std::size_t>(1, grain);
+    job->slices = (count + job->grain - 1) / job->grain;
+
+    // The caller takes slices too, so one fewer helper than slices is enough.
+    const std::size_t helpers = std::min(queues.size(), job->slices - 1);
+    for (std::size_t i = 0; i < helpers; ++i) {
+        submit(priority, [this, priority, job]() { runSlices(priority, job); });
+    }
+    while (job->runOne()) {
+        if (priority == TaskPriority::Batch && currentPool == this && queuedInteractive.load() > 0) {
+            // A worker calling in gives way like a helper: the rest of the job goes back in
+            // line, and the wait below runs the interactive work first.
+            batchYields.fetch_add(1, std::memory_order_relaxed);
+            submit(TaskPriority::Batch, [this, priority, job]() { runSlices(priority, job); });
+            break;
+        }
+    }
+
+    if (currentPool == this) {
+        // A worker waiting on its own pool keeps running tasks so nested calls cannot deadlock.
+        helpUntil(priority, job->mutex, job->done, [&job] { return job->finished(); });
+    } else {
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->done.wait(lock, [&job] { return job->finished(); });
+    }
+
+    if (job->error) {
+        std::rethrow_exception(job->error);
+    }
+}
+
+WorkerPoolStats WorkerPool::stats() const {
+    WorkerPoolStats result;
+    for (const auto& queue : queues) {
+        WorkerPoolStats::Worker worker;
+        worker.tasksRun = queue->tasksRun.load(std::memory_order_relaxed);
+        worker.steals = queue->steals.load(std::memory_order_relaxed);
+        worker.sleeps = queue->sleeps.load(std::memory_order_relaxed);
+        result.workers.push_back(worker);
+    }
+    result.tasksSubmitted = tasksSubmitted.load(std::memory_order_relaxed);
+    result.sliceJobs = sliceJobs.load(std::memory_order_relaxed);
+    result.batchYields = batchYields.load(std::memory_order_relaxed);
+    result.queuedTasks = queuedTasks.load();
+    result.peakQueuedTasks = peakQueuedTasks.load(std::memory_order_relaxed);
+    return result;
+}
+
+std::string formatWorkerPoolStats(const WorkerPoolStats& stats) {
+    std::string text = "Worker pool: " + std::to_string(stats.workers.size()) + " workers, " +
+                       std::to_string(stats.tasksSubmitted) + " tasks submitted, " +
+                       std::to_string(stats.sliceJobs) + " slice jobs, " + std::to_string(stats.batchYields) +
+                       " batch yields, " + std::to_string(stats.queuedTasks) + " queued (peak " +
+                       std::to_string(stats.peakQueuedTasks) + ")\n";
+    for (std::size_t i = 0; i < stats.workers.size(); ++i) {
+        const WorkerPoolStats::Worker& worker = stats.workers[i];
+        text += "  worker " + std::to_string(i) + ": " + std::to_string(worker.tasksRun) + " run, " +
+                std::to_string(worker.steals) + " stolen, " + std::to_string(worker.sleeps) + " sleeps\n";
+    }
+    return text;
+}
+
+// Shared with the queued tasks, which may still be finishing when a waiter wakes up.
+struct TaskGroup::State {
+    std::atomic<std::size_t> pending{0};
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+};
+
+TaskGroup::TaskGroup(TaskPriority taskPriority, WorkerPool& workerPool)
+    : pool(workerPool), priority(taskPriority), state(std::make_shared<State>()) {}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+        // An error nobody waited for has nowhere to go; the tasks have still finished.
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    state->pending.fetch_add(1);
+    pool.submit(priority, [state = state, task = std::move(task)]() {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (!state->error) {
+                state->error = std::current_exception();
+            }
+        }
+        if (state->pending.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->done.notify_all();
+        }
+    });
+}
+
+void TaskGroup::wait() {
+    if (currentPool == &pool) {
+        // Same rule as forEachSlice(): a waiting worker keeps the pool moving.
+        pool.helpUntil(priority, state->mutex, state->done, [this] { return state->pending.load() == 0; });
+    } else {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->done.wait(lock, [this] { return state->pending.load() == 0; });
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        std::swap(error, state->error);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
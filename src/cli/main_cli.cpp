@@ -1,11 +1,25 @@
 #include "catalog/catalog.hpp"
+#include "catalog/catalog_merge.hpp"
+#include "catalog/catalog_report.hpp"
+#include "catalog/crc32c.hpp"
+#include "catalog/detail_cache.hpp"
+#include "catalog/disk_catalog.hpp"
+#include "catalog/query_protocol.hpp"
+#include "catalog/replication.hpp"
+#include "catalog/snapshot.hpp"
+#include "catalog/tenant.hpp"
+#include "catalog/timetable.hpp"
 
 #include <algorithm>
 #include <cctype>
 #include <cstdlib>
 #include <system_error>
 #include <filesystem>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <optional>
 #include <sstream>
 #include <string>
@@ -22,6 +36,8 @@ bool loadedData = false;
 Catalog courseCatalog;
 LoadResult lastLoadResult;
 std::string currentCatalogPath;
+std::optional<CatalogReplica> catalogReplica;  // Set in replica mode (--apply-deltas).
+std::size_t requestedWorkers = 0;  // From --workers; handed on to the dashboard. 0 means the default.
 std::string advisorGuiExecutable = "advisor_gui";  // Falls back to PATH lookup when we cannot resolve a build-local binary.
 
 enum class TextStyle {
@@ -304,10 +320,11 @@ struct NormalizedCourseId {
 };
 
 /**
- * Cleans up what the user typed for a course lookup. We keep the leading letters,
- * then any digits, drop the rest, and tell the caller if we had to tweak it.
+ * Cleans up what the user typed for a course lookup. With the default scheme we keep the
+ * leading letters, then any digits, drop the rest, and tell the caller if we had to tweak
+ * it; other schemes normalize the whole input (so "cs 101" finds "CS-101").
  */
-std::optional<NormalizedCourseId> normalizeCourseIdInput(std::string input) {
+std::optional<NormalizedCourseId> normalizeCourseIdInput(std::string input, const CourseIdScheme& idScheme) {
     // Trim whitespace, convert to uppercase, and handle any stray commas first.
     input = toUpper(trim(input));
     removeTrailingComma(input);
@@ -315,6 +332,15 @@ std::optional<NormalizedCourseId> normalizeCourseIdInput(std::string input) {
         return std::nullopt;
     }
 
+    if (idScheme.normalize != kLettersDigitsIds.normalize) {
+        NormalizedCourseId result;
+        if (!idScheme.normalize(input, result.id)) {
+            return std::nullopt;
+        }
+        result.wasTrimmed = (result.id != input);
+        return result;
+    }
+
     std::string parsedId;
     parsedId.reserve(input.size());  // Avoid reallocations while we build the ID.
 
@@ -407,41 +433,87 @@ void printAllCourses() {
 }
 
 /**
- * Prints one course along with the full names of its prerequisites and calls out
+ * Renders one course along with the full names of its prerequisites and calls out
  * any missing prerequisite entries so they are easy to spot.
  */
-void printCourseDetails(const Course& courseDetails) {
-    std::cout << ansi(TextStyle::MenuTitle) << courseDetails.courseNumber
-              << ansi(TextStyle::Reset) << ", " << courseDetails.courseName << '\n';
+std::string renderCourseDetails(const Catalog& catalog, const Course& courseDetails) {
+    std::string text;
+    text += ansi(TextStyle::MenuTitle);
+    text += courseDetails.courseNumber;
+    text += ansi(TextStyle::Reset);
+    text += ", ";
+    text += courseDetails.courseName;
+    text += '\n';
 
     if (courseDetails.prerequisites.empty()) {
-        std::cout << ansi(TextStyle::Info) << "Prerequisites: none\n"
-                  << ansi(TextStyle::Reset);
-        return;
+        text += ansi(TextStyle::Info);
+        text += "Prerequisites: none\n";
+        text += ansi(TextStyle::Reset);
+        return text;
     }
 
-    std::cout << ansi(TextStyle::MenuBorder) << "Prerequisites:\n"
-              << ansi(TextStyle::Reset);
+    text += ansi(TextStyle::MenuBorder);
+    text += "Prerequisites:\n";
+    text += ansi(TextStyle::Reset);
     for (const auto& prereqId : courseDetails.prerequisites) {
-        std::cout << ansi(TextStyle::MenuNumber) << "  " << prereqId
-                  << ansi(TextStyle::Reset);
-        const Course* prereq = courseCatalog.get(prereqId);
-        if (prereq) {
-            std::cout << " - " << prereq->courseName;
+        text += ansi(TextStyle::MenuNumber);
+        text += "  ";
+        text += prereqId;
+        text += ansi(TextStyle::Reset);
+        text += " - ";
+        if (const Course* prereq = catalog.get(prereqId)) {
+            text += prereq->courseName;
         } else {
-            std::cout << " - " << ansi(TextStyle::Warning)
-                      << "(missing from catalog)" << ansi(TextStyle::Reset);
+            text += ansi(TextStyle::Warning);
+            text += "(missing from catalog)";
+            text += ansi(TextStyle::Reset);
         }
-        std::cout << '\n';
+        text += '\n';
+    }
+    return text;
+}
+
+// Rendered detail blocks for the session; the palette is fixed at startup, so one style suffices.
+CourseDetailCache& courseDetailCache() {
+    static CourseDetailCache cache(courseCatalog);
+    return cache;
+}
+
+// Prints a course from the detail cache, rendering it only on the first lookup per generation.
+void printCourseDetails(const Course& courseDetails) {
+    static const CourseDetailCache::StyleId terminalStyle = courseDetailCache().addStyle(renderCourseDetails);
+    if (const auto block = courseDetailCache().get(terminalStyle, courseDetails.courseNumber)) {
+        std::cout.write(block->data(), static_cast<std::streamsize>(block->size()));
     }
 }
 
+// COURSE_ADVISOR_RELOAD=inplace trades the all-or-nothing reload for lower peak memory.
+// COURSE_ADVISOR_ID_SCHEME picks the course ID scheme (letters-digits, dashed, spaced-suffix, numeric-first).
+const LoadOptions& activeLoadOptions() {
+    static const LoadOptions options = []() {
+        LoadOptions configured;
+        if (envLower("COURSE_ADVISOR_RELOAD") == "inplace") {
+            configured.reloadMode = ReloadMode::InPlace;
+        }
+        if (const std::string scheme = envLower("COURSE_ADVISOR_ID_SCHEME"); !scheme.empty()) {
+            if (const CourseIdScheme* found = findCourseIdScheme(scheme)) {
+                configured.idScheme = *found;
+            } else {
+                std::cerr << "Unknown COURSE_ADVISOR_ID_SCHEME '" << scheme << "'; using "
+                          << configured.idScheme.name << ".\n";
+            }
+        }
+        return configured;
+    }();
+    return options;
+}
+
 /**
  * Reads the CSV file, cleans up the IDs, checks prerequisites, and loads the
  * results using the shared catalog core before caching the sorted lists.
  */
 bool loadCoursesFromFile(const std::string& fileName) {
-    lastLoadResult = courseCatalog.load(fileName);
+    lastLoadResult = courseCatalog.load(fileName, activeLoadOptions());
     loadedData = lastLoadResult.ok;
 
     if (!loadedData) {
@@ -456,9 +528,15 @@ bool loadCoursesFromFile(const std::string& fileName) {
     }
 
     currentCatalogPath = lastLoadResult.path;
-    std::cout << ansi(TextStyle::Success) << "Loaded "
-              << lastLoadResult.courses << " courses from "
-              << currentCatalogPath << '\n' << ansi(TextStyle::Reset);
+    if (lastLoadResult.unchanged) {
+        std::cout << ansi(TextStyle::Info) << currentCatalogPath
+                  << " is unchanged since the last load; keeping its "
+                  << lastLoadResult.courses << " courses.\n" << ansi(TextStyle::Reset);
+    } else {
+        std::cout << ansi(TextStyle::Success) << "Loaded "
+                  << lastLoadResult.courses << " courses from "
+                  << currentCatalogPath << '\n' << ansi(TextStyle::Reset);
+    }
     reportLoadMessages(lastLoadResult);
     std::cout << ansi(TextStyle::Success) << "Courses have been loaded!\n"
               << ansi(TextStyle::Reset);
@@ -466,6 +544,451 @@ bool loadCoursesFromFile(const std::string& fileName) {
     return true;
 }
 
+/**
+ * Loads an override file and merges it over the current catalog without re-reading
+ * the original. The override supplies titles; prerequisites follow the chosen mode.
+ */
+bool mergeCoursesFromFile(const std::string& fileName, PrerequisiteMerge prerequisiteMode) {
+    Catalog overrides;
+    const LoadResult overrideResult = overrides.load(fileName);
+    if (!overrideResult.ok) {
+        for (const auto& warning : overrideResult.warnings) {
+            std::cout << ansi(TextStyle::Error) << warning << '\n'
+                      << ansi(TextStyle::Reset);
+        }
+        std::cout << ansi(TextStyle::Warning)
+                  << "No courses were merged from " << fileName << '\n'
+                  << ansi(TextStyle::Reset);
+        return false;
+    }
+
+    MergePolicy policy;
+    policy.namePrecedence = NamePrecedence::FirstNonEmpty;
+    policy.prerequisites = prerequisiteMode;
+    const std::vector<MergeSource> sources{
+        {&courseCatalog, "current catalog", 0},
+        {&overrides, overrideResult.path, 1},
+    };
+    lastLoadResult = mergeCatalogs(sources, policy, courseCatalog);
+
+    std::cout << ansi(TextStyle::Success) << "Merged catalog now has "
+              << lastLoadResult.courses << " courses\n" << ansi(TextStyle::Reset);
+    reportLoadMessages(lastLoadResult);
+    return lastLoadResult.ok;
+}
+
+/**
+ * Publisher mode (--publish-delta DIR [FILE]): loads FILE, or the bundled catalog, and
+ * writes it to DIR as the next generation for replicas. Returns the process exit code.
+ */
+int publishCatalogGeneration(const std::string& directory, const std::string& fileName) {
+    if (!loadCoursesFromFile(fileName)) {
+        return 1;
+    }
+
+    CatalogPublisher publisher(directory);
+    const PublishResult published = publisher.publish(courseCatalog);
+    for (const auto& warning : published.warnings) {
+        std::cout << ansi(TextStyle::Warning) << warning << '\n' << ansi(TextStyle::Reset);
+    }
+    if (!published.ok) {
+        return 1;
+    }
+
+    if (published.unchanged) {
+        std::cout << ansi(TextStyle::Info) << "Catalog unchanged; generation "
+                  << published.generation << " is still current.\n" << ansi(TextStyle::Reset);
+    } else {
+        std::cout << ansi(TextStyle::Success) << "Published generation " << published.generation
+                  << " to " << directory << " (delta " << published.deltaBytes << " bytes, snapshot "
+                  << published.snapshotBytes << " bytes)\n" << ansi(TextStyle::Reset);
+    }
+    return 0;
+}
+
+/**
+ * Replica mode: brings the session catalog up to the newest generation published in the
+ * replication directory, applying deltas when possible.
+ */
+bool syncReplicaCatalog() {
+    const std::uint64_t previousGeneration = catalogReplica->generation();
+    const LoadResult synced = catalogReplica->sync(courseCatalog);
+    if (!synced.ok) {
+        for (const auto& warning : synced.warnings) {
+            std::cout << ansi(TextStyle::Error) << warning << '\n' << ansi(TextStyle::Reset);
+        }
+        return false;
+    }
+
+    loadedData = true;
+    if (catalogReplica->generation() == previousGeneration) {
+        std::cout << ansi(TextStyle::Info) << "Catalog is up to date at generation "
+                  << previousGeneration << ".\n" << ansi(TextStyle::Reset);
+        return true;
+    }
+
+    lastLoadResult = synced;
+    currentCatalogPath.clear();  // Replicated data has no source file to hand to the dashboard.
+    std::cout << ansi(TextStyle::Success) << "Synced " << synced.courses
+              << " courses at generation " << catalogReplica->generation() << '\n'
+              << ansi(TextStyle::Reset);
+    reportLoadMessages(synced);
+    return true;
+}
+
+/**
+ * Snapshot check (--verify-snapshot FILE [ID...]): looks the IDs up first, touching only
+ * their sections, then checks every remaining section's CRC-32C. Returns 1 when the file
+ * cannot be opened or any section is damaged.
+ */
+int verifySnapshotFile(const std::string& fileName, const std::vector<std::string>& courseIds) {
+    std::ifstream input(fileName, std::ios::binary);
+    const std::string bytes{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+    if (!input && !input.eof()) {
+        std::cerr << "Unable to read '" << fileName << "'.\n";
+        return 1;
+    }
+
+    SnapshotReader snapshot;
+    std::string error;
+    if (!snapshot.open(bytes, error)) {
+        std::cerr << fileName << ": " << error << ".\n";
+        return 1;
+    }
+    std::cout << "Generation " << snapshot.generation() << ": " << snapshot.courseCount() << " courses in "
+              << snapshot.sectionCount() << " sections (CRC-32C "
+              << (crc32cHardwareAccelerated() ? "SSE4.2" : "table") << ")\n";
+
+    const CourseIdScheme& idScheme = activeLoadOptions().idScheme;
+    for (const auto& courseId : courseIds) {
+        const auto id = normalizeCourseIdInput(courseId, idScheme);
+        if (!id) {
+            std::cout << "  " << courseId << ": not a course number\n";
+            continue;
+        }
+        error.clear();
+        if (const std::optional<Course> course = snapshot.find(id->id, error)) {
+            std::cout << "  " << course->courseNumber << ", " << course->courseName << '\n';
+        } else {
+            std::cout << "  " << id->id << ": " << (error.empty() ? "not in this snapshot" : error) << '\n';
+        }
+    }
+
+    if (snapshot.verifyAll()) {
+        std::cout << "All sections intact.\n";
+        return 0;
+    }
+    for (const std::size_t section : snapshot.corruptSections()) {
+        std::cout << "Section " << section + 1 << " (courses " << snapshot.sectionFirstCourse(section) + 1 << "-"
+                  << snapshot.sectionFirstCourse(section) + snapshot.sectionCourseCount(section)
+                  << ") failed its CRC-32C check.\n";
+    }
+    return 1;
+}
+
+// Loads fileName and writes it to outputPath as an on-disk B+tree (--build-disk-catalog).
+int buildDiskCatalogMode(const std::string& fileName, const std::string& outputPath) {
+    LoadOptions options = activeLoadOptions();
+    options.priority = TaskPriority::Batch;
+    const LoadResult loaded = courseCatalog.load(fileName, options);
+    for (const auto& warning : loaded.warnings) {
+        std::cerr << warning << '\n';
+    }
+    if (!loaded.ok) {
+        return 1;
+    }
+
+    DiskCatalogWriter writer;
+    std::string error;
+    bool written = writer.open(outputPath, error);
+    for (auto id = courseCatalog.sortedIds().begin(); written && id != courseCatalog.sortedIds().end(); ++id) {
+        written = writer.add(*courseCatalog.get(*id), error);
+    }
+    if (!written || !writer.finish(error)) {
+        std::cerr << outputPath << ": " << error << ".\n";
+        return 1;
+    }
+    std::cerr << "Wrote " << writer.courseCount() << " courses in " << writer.pageCount() << " pages of "
+              << kDiskCatalogPageSize << " bytes.\n";
+    return 0;
+}
+
+/**
+ * Looks courses up in a disk catalog without loading it (--disk-catalog). Each argument is
+ * a course ID, or a prefix ending in '*' to list every course under it. Returns nonzero if
+ * the file cannot be opened or a node it reached was damaged.
+ */
+int queryDiskCatalog(const std::string& fileName, const std::vector<std::string>& queries) {
+    DiskCatalog catalog;
+    std::string error;
+    if (!catalog.open(fileName, error)) {
+        std::cerr << fileName << ": " << error << ".\n";
+        return 1;
+    }
+    std::cout << catalog.size() << " courses, tree height " << catalog.height() << '\n';
+
+    const CourseIdScheme& idScheme = activeLoadOptions().idScheme;
+    int status = 0;
+    for (const auto& input : queries) {
+        error.clear();
+        if (!input.empty() && input.back() == '*') {
+            const std::string prefix = toUpper(trim(input.substr(0, input.size() - 1)));
+            std::size_t matches = 0;
+            const bool intact = catalog.scanPrefix(prefix, [&](const Course& course) {
+                std::cout << "  " << course.courseNumber << ", " << course.courseName << '\n';
+                ++matches;
+            }, error);
+            std::cout << "  " << matches << " courses start with '" << prefix << "'"
+                      << (intact ? std::string() : "; stopped: " + error) << '\n';
+            status = intact ? status : 1;
+            continue;
+        }
+
+        const auto id = normalizeCourseIdInput(input, idScheme);
+        if (!id) {
+            std::cout << "  " << input << ": not a course number\n";
+        } else if (const std::optional<Course> course = catalog.get(id->id, error)) {
+            std::cout << "  " << course->courseNumber << ", " << course->courseName << '\n';
+        } else {
+            std::cout << "  " << id->id << ": " << (error.empty() ? "not in this catalog" : error) << '\n';
+            status = error.empty() ? status : 1;
+        }
+    }
+
+    const DiskCatalogCacheStats cache = catalog.cacheStats();
+    std::cout << "Page cache: " << cache.hits << " hits, " << cache.misses << " misses, " << cache.evictions
+              << " evictions, " << cache.bytesRead << " bytes read\n";
+    return status;
+}
+
+// Splits a comma-separated argument; "-" and "" mean an empty list.
+std::vector<std::string> splitListArgument(const std::string& argument) {
+    std::vector<std::string> items;
+    if (argument == "-") {
+        return items;
+    }
+    std::stringstream stream(argument);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!trim(item).empty()) {
+            items.push_back(trim(item));
+        }
+    }
+    return items;
+}
+
+/**
+ * Section planner (--open-sections): loads the catalog and its sections file, then lists
+ * every section of a course the student can take next that fits around their schedule.
+ * taken is a comma-separated list of completed course IDs; schedule lists the sections
+ * already chosen as COURSE:SECTION. Returns nonzero when either file cannot be loaded or
+ * an ID or section is not recognized.
+ */
+int listOpenSections(const std::string& fileName, const std::string& sectionsFile, const std::string& taken,
+                     const std::string& schedule) {
+    const LoadResult loaded = courseCatalog.load(fileName, activeLoadOptions());
+    for (const auto& warning : loaded.warnings) {
+        std::cerr << warning << '\n';
+    }
+    if (!loaded.ok) {
+        return 1;
+    }
+    Timetable timetable;
+    const CourseIdScheme& idScheme = activeLoadOptions().idScheme;
+    const TimetableLoadResult sections = timetable.load(sectionsFile, courseCatalog, idScheme);
+    for (const auto& warning : sections.warnings) {
+        std::cerr << sectionsFile << ": " << warning << '\n';
+    }
+    if (!sections.ok) {
+        return 1;
+    }
+
+    std::vector<std::string> takenIds;
+    for (const auto& input : splitListArgument(taken)) {
+        const auto id = normalizeCourseIdInput(input, idScheme);
+        if (!id) {
+            std::cerr << "'" << input << "' is not a course number.\n";
+            return 1;
+        }
+        takenIds.push_back(id->id);
+    }
+    std::vector<std::uint32_t> chosen;
+    for (const auto& input : splitListArgument(schedule)) {
+        const std::size_t colon = input.find(':');
+        const auto id = normalizeCourseIdInput(input.substr(0, colon), idScheme);
+        const std::optional<std::uint32_t> section =
+            id && colon != std::string::npos ? timetable.find(id->id, toUpper(trim(input.substr(colon + 1))))
+                                             : std::nullopt;
+        if (!section) {
+            std::cerr << "No section '" << input << "' in " << sectionsFile << " (expected COURSE:SECTION).\n";
+            return 1;
+        }
+        chosen.push_back(*section);
+    }
+
+    const auto describe = [&timetable](std::uint32_t handle) {
+        const Section& section = timetable.sections()[handle];
+        const Course* course = courseCatalog.get(section.courseNumber);
+        std::cout << "  " << std::left << std::setw(10) << section.courseNumber << std::setw(5) << section.sectionId
+                  << std::setw(17) << formatSectionTime(section) << std::right << std::setw(4) << section.capacity
+                  << " seats  " << (course ? course->courseName : std::string()) << '\n';
+    };
+    std::vector<std::uint32_t> overlaps;
+    for (std::size_t i = 0; i < chosen.size(); ++i) {
+        const Section& section = timetable.sections()[chosen[i]];
+        overlaps.clear();
+        timetable.overlapping(section.days, section.startMinute, section.endMinute, overlaps);
+        std::sort(overlaps.begin(), overlaps.end());  // A clash on several days is reported once.
+        overlaps.erase(std::unique(overlaps.begin(), overlaps.end()), overlaps.end());
+        for (const std::uint32_t other : overlaps) {
+            if (std::find(chosen.begin(), chosen.begin() + static_cast<std::ptrdiff_t>(i), other) !=
+                chosen.begin() + static_cast<std::ptrdiff_t>(i)) {
+                std::cout << "Warning: " << section.courseNumber << ":" << section.sectionId << " clashes with "
+                          << timetable.sections()[other].courseNumber << ":" << timetable.sections()[other].sectionId
+                          << ".\n";
+            }
+        }
+    }
+
+    const std::vector<std::uint32_t> open = timetable.openSections(takenIds, chosen);
+
+    std::size_t courses = 0;
+    for (std::size_t i = 0; i < open.size(); ++i) {
+        const Section& section = timetable.sections()[open[i]];
+        courses += (i == 0 || section.courseNumber != timetable.sections()[open[i - 1]].courseNumber) ? 1 : 0;
+        describe(open[i]);
+    }
+    std::cout << open.size() << " open sections in " << courses << " courses (of " << timetable.size()
+              << " sections).\n";
+    return 0;
+}
+
+/**
+ * Binary mode (--binary-queries [FILE]): loads FILE and answers framed queries from stdin
+ * on stdout. Diagnostics go to stderr so they never corrupt the response stream.
+ */
+int serveBinaryQueryMode(const std::string& fileName) {
+    const LoadResult loaded = courseCatalog.load(fileName, activeLoadOptions());
+    for (const auto& warning : loaded.warnings) {
+        std::cerr << warning << '\n';
+    }
+    if (!loaded.ok) {
+        return 1;
+    }
+
+    std::ios::sync_with_stdio(false);  // Lets the server see how much pipelined input is buffered.
+    const std::size_t answered = serveBinaryQueries(std::cin, std::cout, courseCatalog);
+    std::cerr << "Answered " << answered << " binary queries.\n";
+    return 0;
+}
+
+/**
+ * Writes the full catalog book (every course with direct and transitive prerequisites) to
+ * outputPath, or to stdout when it is empty. Progress and diagnostics go to stderr.
+ */
+int writeCatalogReportMode(const std::string& fileName, const std::string& outputPath) {
+    LoadOptions options = activeLoadOptions();
+    options.priority = TaskPriority::Batch;
+    const LoadResult loaded = courseCatalog.load(fileName, options);
+    for (const auto& warning : loaded.warnings) {
+        std::cerr << warning << '\n';
+    }
+    if (!loaded.ok) {
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!outputPath.empty()) {
+        file.open(outputPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "Unable to open '" << outputPath << "' for writing.\n";
+            return 1;
+        }
+    } else {
+        std::ios::sync_with_stdio(false);
+    }
+
+    const CatalogReportResult report = writeCatalogReport(courseCatalog, outputPath.empty() ? std::cout : file);
+    if (report.cyclicCourses != 0) {
+        std::cerr << report.cyclicCourses << " courses are part of a prerequisite cycle.\n";
+    }
+    if (!report.ok) {
+        std::cerr << "Report stopped after " << report.courses << " courses: the output could not be written.\n";
+        return 1;
+    }
+    std::cerr << "Wrote " << report.courses << " courses (" << report.bytesWritten << " bytes).\n";
+    return 0;
+}
+
+/**
+ * Loads one tenant per NAME[:QUOTA_MB]=FILE spec, builds each tenant's query index from its
+ * own memory resource, and prints what every tenant is using. Returns nonzero when a spec
+ * is malformed or a tenant's catalog could not be loaded within its quota.
+ */
+int reportTenantUsage(const std::vector<std::string>& specs) {
+    TenantRegistry registry;
+    std::vector<std::unique_ptr<QueryProcessor>> processors;
+    int status = 0;
+    for (const auto& spec : specs) {
+        const std::size_t equals = spec.find('=');
+        if (equals == std::string::npos || equals == 0 || equals + 1 == spec.size()) {
+            std::cerr << "Expected NAME[:QUOTA_MB]=FILE, got '" << spec << "'.\n";
+            return 1;
+        }
+        std::string name = spec.substr(0, equals);
+        std::size_t quotaBytes = 0;
+        if (const std::size_t colon = name.find(':'); colon != std::string::npos) {
+            const std::string quota = name.substr(colon + 1);
+            if (quota.empty() || quota.size() > 9 ||
+                !std::all_of(quota.begin(), quota.end(), [](unsigned char ch) { return std::isdigit(ch); })) {
+                std::cerr << "Quota for '" << name.substr(0, colon) << "' must be a whole number of MB.\n";
+                return 1;
+            }
+            quotaBytes = static_cast<std::size_t>(std::stoul(quota)) << 20;
+            name.resize(colon);
+        }
+
+        Tenant& tenant = registry.add(name, quotaBytes);
+        const LoadResult loaded = tenant.load(spec.substr(equals + 1), activeLoadOptions());
+        for (const auto& warning : loaded.warnings) {
+            std::cerr << name << ": " << warning << '\n';
+        }
+        if (tenant.catalog().size() == 0) {
+            status = 1;
+            continue;
+        }
+
+        try {
+            auto processor = std::make_unique<QueryProcessor>(tenant.catalog(), tenant.memory());
+            std::string response;
+            const std::string warmup = encodeGetRequest(0, tenant.catalog().generation(), {});
+            processor->handle(std::string_view(warmup).substr(4), response);
+            processors.push_back(std::move(processor));
+        } catch (const std::bad_alloc&) {
+            std::cerr << name << ": query index does not fit in the remaining quota.\n";
+            status = 1;
+        }
+    }
+
+    const auto megabytes = [](std::size_t bytes) { return static_cast<double>(bytes) / (1 << 20); };
+    std::cout << std::left << std::setw(16) << "Tenant" << std::right << std::setw(10) << "Courses"
+              << std::setw(12) << "Catalog MB" << std::setw(12) << "Scratch MB" << std::setw(10) << "Quota MB"
+              << std::setw(10) << "Refused" << '\n';
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& usage : registry.usage()) {
+        std::cout << std::left << std::setw(16) << usage.name << std::right << std::setw(10) << usage.courses
+                  << std::setw(12) << megabytes(usage.catalogBytes)
+                  << std::setw(12) << megabytes(usage.scratchBytes);
+        if (usage.quotaBytes == 0) {
+            std::cout << std::setw(10) << "-";
+        } else {
+            std::cout << std::setw(10) << megabytes(usage.quotaBytes);
+        }
+        std::cout << std::setw(10) << usage.rejectedAllocations << '\n';
+    }
+    return status;
+}
+
 /**
  * Prompts for a course ID, cleans it up, and prints the matching course details
  * (including prerequisite titles) when present in the course directory.
@@ -478,11 +1001,16 @@ void handleCourseLookup() {
         return;
     }
 
-    auto sanitizedId = normalizeCourseIdInput(input);  // Clean up the user input.
+    const CourseIdScheme& idScheme = activeLoadOptions().idScheme;
+    auto sanitizedId = normalizeCourseIdInput(input, idScheme);  // Clean up the user input.
     if (!sanitizedId) {
-        std::cout << ansi(TextStyle::Error)
-                  << "Course number must start with letters and end with digits.\n"
-                  << ansi(TextStyle::Reset);
+        std::cout << ansi(TextStyle::Error);
+        if (idScheme.normalize == kLettersDigitsIds.normalize) {
+            std::cout << "Course number must start with letters and end with digits.\n";
+        } else {
+            std::cout << "Course number must look like " << idScheme.example << ".\n";
+        }
+        std::cout << ansi(TextStyle::Reset);
         return;
     }
 
@@ -520,6 +1048,9 @@ void launchDashboard() {
     std::string command = "\"";  // Quote the executable in case the build path has spaces.
     command += advisorGuiExecutable;
     command += "\"";
+    if (requestedWorkers != 0) {
+        command += " --workers " + std::to_string(requestedWorkers);
+    }
     if (!currentCatalogPath.empty()) {
         command += " \"";
         command += currentCatalogPath;
@@ -569,6 +1100,16 @@ void runMenu() {
             "4. Launch Qt dashboard",
             std::string(numberColor) + "4. " + textColor + "Launch Qt dashboard"
         });
+        menuLines.push_back({
+            "5. Merge an override file into the catalog",
+            std::string(numberColor) + "5. " + textColor + "Merge an override file into the catalog"
+        });
+        if (catalogReplica) {
+            menuLines.push_back({
+                "6. Check for catalog updates",
+                std::string(numberColor) + "6. " + textColor + "Check for catalog updates"
+            });
+        }
         menuLines.push_back({
             "9. Exit",
             std::string(numberColor) + "9. " + textColor + "Exit"
@@ -633,21 +1174,107 @@ void runMenu() {
         } else if (choice == "4") {
             launchDashboard();
             waitForEnter();
+        } else if (choice == "5") {
+            if (!loadedData) {
+                std::cout << ansi(TextStyle::Warning)
+                          << "Please load courses first (option 1).\n"
+                          << ansi(TextStyle::Reset);
+                waitForEnter();
+                continue;
+            }
+            std::cout << promptColor << "Enter override file name: " << resetColor;
+            std::string fileName;
+            if (!std::getline(std::cin, fileName)) {
+                std::cout << '\n' << ansi(TextStyle::Info)
+                          << "Input stream closed. Exiting.\n" << ansi(TextStyle::Reset);
+                break;
+            }
+            fileName = trim(fileName);
+            removeTrailingComma(fileName);
+
+            std::cout << promptColor << "Combine prerequisites? (u)nion or (r)eplace [r]: " << resetColor;
+            std::string mode;
+            std::getline(std::cin, mode);
+            mode = toLowerCopy(trim(mode));
+            const PrerequisiteMerge prerequisiteMode =
+                (mode == "u" || mode == "union") ? PrerequisiteMerge::Union : PrerequisiteMerge::Replace;
+
+            mergeCoursesFromFile(fileName, prerequisiteMode);
+            waitForEnter();
+        } else if (choice == "6" && catalogReplica) {
+            syncReplicaCatalog();
+            waitForEnter();
         } else if (choice == "9") {
             std::cout << ansi(TextStyle::Success) << "Goodbye.\n" << ansi(TextStyle::Reset);
             break;
         } else {
             std::cout << ansi(TextStyle::Error)
-                      << "Error, please enter option 1, 2, 3, 4, or 9.\n"
+                      << (catalogReplica ? "Error, please enter option 1, 2, 3, 4, 5, 6, or 9.\n"
+                                         : "Error, please enter option 1, 2, 3, 4, 5, or 9.\n")
                       << ansi(TextStyle::Reset);
             waitForEnter();
         }
     }
 }
 
+// Runs the mode the remaining arguments select; without one, the interactive menu.
+int runMode(const std::vector<std::string>& args) {
+    if (args.size() >= 2 && args[0] == "--publish-delta") {
+        return publishCatalogGeneration(args[1], args.size() >= 3 ? args[2] : kDefaultCourseCSVFile);
+    }
+    if (!args.empty() && args[0] == "--binary-queries") {
+        return serveBinaryQueryMode(args.size() >= 2 ? args[1] : kDefaultCourseCSVFile);
+    }
+    if (args.size() >= 2 && args[0] == "--catalog-report") {
+        return writeCatalogReportMode(args[1], args.size() >= 3 ? args[2] : std::string());
+    }
+    if (args.size() >= 2 && args[0] == "--verify-snapshot") {
+        return verifySnapshotFile(args[1], std::vector<std::string>(args.begin() + 2, args.end()));
+    }
+    if (args.size() >= 3 && args[0] == "--build-disk-catalog") {
+        return buildDiskCatalogMode(args[1], args[2]);
+    }
+    if (args.size() >= 2 && args[0] == "--disk-catalog") {
+        return queryDiskCatalog(args[1], std::vector<std::string>(args.begin() + 2, args.end()));
+    }
+    if (args.size() >= 3 && args[0] == "--open-sections") {
+        return listOpenSections(args[1], args[2], args.size() >= 4 ? args[3] : std::string(),
+                                args.size() >= 5 ? args[4] : std::string());
+    }
+    if (args.size() >= 2 && args[0] == "--tenant-report") {
+        return reportTenantUsage(std::vector<std::string>(args.begin() + 1, args.end()));
+    }
+    if (args.size() >= 2 && args[0] == "--apply-deltas") {
+        catalogReplica.emplace(args[1]);
+        syncReplicaCatalog();
+    }
+
+    runMenu();
+    return 0;
+}
+
 }  // namespace
 
-// Main starts the menu loop.
+/**
+ * Main starts the menu loop. Optional flags:
+ *   --publish-delta DIR [FILE]  publish FILE as the next catalog generation and exit
+ *   --apply-deltas DIR          start from (and keep following) the generations in DIR
+ *   --binary-queries [FILE]     answer binary protocol queries on stdin/stdout and exit
+ *   --catalog-report FILE [OUT] write every course with its transitive prerequisites and exit
+ *   --verify-snapshot FILE [ID...]
+ *                               look IDs up in a published snapshot, check every section, and exit
+ *   --build-disk-catalog FILE OUT
+ *                               write FILE's courses to OUT as an on-disk B+tree and exit
+ *   --disk-catalog FILE [ID|PREFIX*...]
+ *                               look IDs up (or list a prefix) in a disk catalog without loading it, and exit
+ *   --open-sections FILE SECTIONS [TAKEN [SCHEDULE]]
+ *                               list sections of eligible courses that fit the schedule, and exit
+ *   --tenant-report NAME[:QUOTA_MB]=FILE...
+ *                               load one catalog per tenant, print per-tenant memory use, and exit
+ * Any of them may be preceded by:
+ *   --workers N                 size the shared worker pool (default: CATALOG_WORKERS, else one per core)
+ *   --pool-stats                print worker pool queue and steal counters to stderr on exit
+ */
 int main(int argc, char** argv) {
     if (argc > 0 && argv[0] != nullptr) {
         std::filesystem::path executablePath = std::filesystem::absolute(argv[0]);
@@ -661,6 +1288,33 @@ int main(int argc, char** argv) {
             advisorGuiExecutable = guiPath.string();
         }
     }
-    runMenu();
-    return 0;
+
+    std::vector<std::string> args(argv + std::min(argc, 1), argv + argc);
+    bool printPoolStats = false;
+    // Worker pool options come first and apply to every mode.
+    while (!args.empty()) {
+        if (args[0] == "--pool-stats") {
+            printPoolStats = true;
+            args.erase(args.begin());
+        } else if (args.size() >= 2 && args[0] == "--workers") {
+            const std::string& count = args[1];
+            const bool numeric = !count.empty() && count.size() <= 4 &&
+                                 std::all_of(count.begin(), count.end(), [](unsigned char ch) { return std::isdigit(ch); });
+            requestedWorkers = numeric ? static_cast<std::size_t>(std::stoul(count)) : 0;
+            if (requestedWorkers == 0) {
+                std::cerr << "--workers needs a whole number from 1 to 9999, got '" << count << "'.\n";
+                return 1;
+            }
+            WorkerPool::configureShared(requestedWorkers);
+            args.erase(args.begin(), args.begin() + 2);
+        } else {
+            break;
+        }
+    }
+
+    const int status = runMode(args);
+    if (printPoolStats) {
+        std::cerr << formatWorkerPoolStats(WorkerPool::shared().stats());
+    }
+    return status;
 }
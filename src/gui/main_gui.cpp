@@ -3,14 +3,25 @@
 
 #include <QApplication>
 
-// Qt entry point: optionally preload a CSV (allows the CLI to hand off state) then
-// start the dashboard event loop.
+#include <cstdlib>
+#include <string_view>
+
+// Qt entry point: optionally size the worker pool and preload a CSV (allows the CLI to hand
+// off state) then start the dashboard event loop.
 int main(int argc, char** argv) {
     QApplication app(argc, argv);
 
+    int firstFileArgument = 1;
+    if (argc > 2 && std::string_view(argv[1]) == "--workers") {
+        if (const int workers = std::atoi(argv[2]); workers > 0) {
+            WorkerPool::configureShared(static_cast<std::size_t>(workers));  // Same meaning as the CLI flag.
+        }
+        firstFileArgument = 3;
+    }
+
     Catalog catalog;  // GUI keeps its own catalog instance but shares the same core code.
-    if (argc > 1) {
-        catalog.load(argv[1]);  // Optional preload lets the CLI hand off the active file.
+    if (argc > firstFileArgument) {
+        catalog.load(argv[firstFileArgument]);  // Optional preload lets the CLI hand off the active file.
     }
 
     MainWindow window(std::move(catalog));
@@ -2,6 +2,8 @@
 
 #include <QAction>
 #include <QApplication>
+#include <QBrush>
+#include <QColor>
 #include <QFileDialog>
 #include <QHBoxLayout>
 #include <QItemSelectionModel>
@@ -11,12 +13,19 @@
 #include <QListWidget>
 #include <QMenuBar>
 #include <QMessageBox>
+#include <QPromise>
+#include <QPushButton>
 #include <QSplitter>
+#include <QStackedWidget>
 #include <QStatusBar>
+#include <QStringList>
 #include <QStyle>
 #include <QTimer>
 #include <QVBoxLayout>
-#include <QStringList>
+
+#include <algorithm>
+#include <exception>
+#include <memory>
 
 // Constructs the advisor dashboard window and wires up the shared catalog.
 MainWindow::MainWindow(Catalog catalogToUse, QWidget* parent)
@@ -30,11 +39,24 @@ MainWindow::MainWindow(Catalog catalogToUse, QWidget* parent)
     searchDelayTimer->setInterval(300);
     connect(searchDelayTimer, &QTimer::timeout, this, &MainWindow::performSearch);
 
+    comparisonWatcher = new QFutureWatcher<CatalogComparison>(this);  // Delivers background diffs to the UI thread.
+    connect(comparisonWatcher, &QFutureWatcher<CatalogComparison>::finished,
+            this, &MainWindow::handleComparisonFinished);
+
+    cancelComparisonButton = new QPushButton(tr("Cancel"), this);  // Only visible while a comparison runs.
+    cancelComparisonButton->setVisible(false);
+    statusBar()->addPermanentWidget(cancelComparisonButton);
+    connect(cancelComparisonButton, &QPushButton::clicked, this, &MainWindow::cancelComparison);
+
     refreshCourseList();
+    catalog.subscribe([this](const CatalogChangeSet& changes) { applyCatalogChanges(changes); });
     statusBar()->showMessage("Ready");  // Match the CLI startup message tone.
 }
 
-MainWindow::~MainWindow() = default;
+MainWindow::~MainWindow() {
+    comparisonCancellation.cancel();       // Closing the window should not wait for a full diff.
+    comparisonWatcher->waitForFinished();  // Never let a worker outlive the window it reports to.
+}
 
 // Builds the File and View menus that drive the dashboard actions.
 void MainWindow::createMenus() {
@@ -51,6 +73,14 @@ void MainWindow::createMenus() {
     auto* viewMenu = menuBar()->addMenu(tr("View"));
     auto* missingAction = viewMenu->addAction(tr("Show Missing Prereqs"));
     connect(missingAction, &QAction::triggered, this, &MainWindow::showMissingPrerequisites);
+    auto* poolStatsAction = viewMenu->addAction(tr("Worker Pool Statistics"));
+    connect(poolStatsAction, &QAction::triggered, this, &MainWindow::showWorkerPoolStats);
+    viewMenu->addSeparator();
+    compareAction = viewMenu->addAction(tr("Compare Catalogs…"));
+    exitDiffAction = viewMenu->addAction(tr("Exit Diff Mode"));
+    exitDiffAction->setEnabled(false);
+    connect(compareAction, &QAction::triggered, this, &MainWindow::compareCatalogs);
+    connect(exitDiffAction, &QAction::triggered, this, &MainWindow::exitDiffMode);
 }
 
 // Lays out the search tools, course list, details pane, and warning list.
@@ -108,7 +138,12 @@ void MainWindow::createLayout() {
     splitter->addWidget(detailWidget);
     splitter->setStretchFactor(0, 1);
     splitter->setStretchFactor(1, 2);
-    rootLayout->addWidget(splitter, 1);
+
+    // The stack keeps the browse splitter as page 0 and the diff view as page 1.
+    viewStack = new QStackedWidget(centralWidget);
+    viewStack->addWidget(splitter);
+    viewStack->addWidget(createDiffPage(viewStack));
+    rootLayout->addWidget(viewStack, 1);
 
     setCentralWidget(centralWidget);
 
@@ -118,13 +153,55 @@ void MainWindow::createLayout() {
     connect(searchField, &QLineEdit::textChanged, this, &MainWindow::handleSearchEdited);
 }
 
+// Lays out the diff list on the left and the prerequisite changes on the right.
+QWidget* MainWindow::createDiffPage(QWidget* parent) {
+    auto* diffSplitter = new QSplitter(Qt::Horizontal, parent);
+
+    courseDiffModel = new CourseDiffModel(diffSplitter);
+    diffListView = new QListView(diffSplitter);
+    diffListView->setModel(courseDiffModel);
+    diffListView->setSelectionMode(QAbstractItemView::SingleSelection);
+    diffListView->setUniformItemSizes(true);  // Lets the view skip measuring every row in huge diffs.
+
+    auto* detailWidget = new QWidget(diffSplitter);
+    auto* detailLayout = new QVBoxLayout(detailWidget);
+    detailLayout->setContentsMargins(8, 0, 0, 0);
+    detailLayout->setSpacing(8);
+
+    diffSummaryLabel = new QLabel(detailWidget);
+    diffSummaryLabel->setWordWrap(true);
+    detailLayout->addWidget(diffSummaryLabel);
+
+    diffCourseLabel = new QLabel(tr("Select a change to view details"), detailWidget);
+    diffCourseLabel->setWordWrap(true);
+    diffCourseLabel->setProperty("heading", true);
+    detailLayout->addWidget(diffCourseLabel);
+
+    auto* prereqTitle = new QLabel(tr("Prerequisite changes"), detailWidget);
+    detailLayout->addWidget(prereqTitle);
+
+    diffPrerequisiteList = new QListWidget(detailWidget);
+    diffPrerequisiteList->setSelectionMode(QAbstractItemView::NoSelection);
+    diffPrerequisiteList->setUniformItemSizes(true);
+    detailLayout->addWidget(diffPrerequisiteList, 1);
+
+    diffSplitter->addWidget(diffListView);
+    diffSplitter->addWidget(detailWidget);
+    diffSplitter->setStretchFactor(0, 1);
+    diffSplitter->setStretchFactor(1, 2);
+
+    connect(diffListView->selectionModel(), &QItemSelectionModel::currentChanged,
+            this, &MainWindow::handleDiffSelection);
+    return diffSplitter;
+}
+
 // Prompts the user for a CSV catalog file and loads it when chosen.
 void MainWindow::openCatalog() {
     const QString filePath = QFileDialog::getOpenFileName(
         this,
         tr("Open Catalog"),
         currentCatalogPath,
-        tr("CSV Files (*.csv);;All Files (*)"));
+        tr("Catalog Files (*.csv *.jsonl *.ndjson);;All Files (*)"));
     if (filePath.isEmpty()) {
         return;
     }
@@ -220,6 +297,180 @@ void MainWindow::showMissingPrerequisites() {
         tr("The following prerequisites reference missing courses:\n\n%1").arg(lines.join('\n')));
 }
 
+// Shows the shared worker pool's queue and steal counters, the same text as the CLI's --pool-stats.
+void MainWindow::showWorkerPoolStats() {
+    QMessageBox::information(this, tr("Worker Pool Statistics"),
+                             QString::fromStdString(formatWorkerPoolStats(WorkerPool::shared().stats())));
+}
+
+// Asks for the baseline and updated files, then loads and diffs both in the background.
+void MainWindow::compareCatalogs() {
+    if (comparisonWatcher->isRunning()) {
+        statusBar()->showMessage(tr("A comparison is already running."), 4000);
+        return;
+    }
+
+    const QString beforePath = QFileDialog::getOpenFileName(
+        this,
+        tr("Select Baseline Catalog"),
+        currentCatalogPath,
+        tr("Catalog Files (*.csv *.jsonl *.ndjson);;All Files (*)"));
+    if (beforePath.isEmpty()) {
+        return;
+    }
+    const QString afterPath = QFileDialog::getOpenFileName(
+        this,
+        tr("Select Updated Catalog"),
+        beforePath,
+        tr("Catalog Files (*.csv *.jsonl *.ndjson);;All Files (*)"));
+    if (afterPath.isEmpty()) {
+        return;
+    }
+
+    compareAction->setEnabled(false);
+    cancelComparisonButton->setEnabled(true);
+    cancelComparisonButton->setVisible(true);
+    statusBar()->showMessage(tr("Comparing %1 with %2…").arg(beforePath, afterPath));
+
+    // Both catalogs live only on the worker pool; the UI receives just the diff.
+    comparisonCancellation = CancellationSource();
+    auto promise = std::make_shared<QPromise<CatalogComparison>>();
+    promise->start();
+    comparisonWatcher->setFuture(promise->future());
+    WorkerPool::shared().submit(
+        TaskPriority::Interactive,
+        [promise, before = beforePath.toStdString(), after = afterPath.toStdString(),
+         cancellation = comparisonCancellation.token()]() {
+            // Pool tasks must not throw, so a failed load or diff travels through the promise.
+            try {
+                CatalogComparison comparison;
+                LoadOptions options;
+                options.cancellation = cancellation;
+                Catalog beforeCatalog;
+                Catalog afterCatalog;
+                TaskGroup loads(TaskPriority::Interactive);
+                loads.run([&] { comparison.before = beforeCatalog.load(before, options); });
+                comparison.after = afterCatalog.load(after, options);
+                loads.wait();
+                if (comparison.before.ok && comparison.after.ok) {
+                    comparison.diff = diffCatalogs(beforeCatalog, afterCatalog, cancellation);
+                }
+                promise->addResult(std::move(comparison));
+            } catch (...) {
+                promise->setException(std::current_exception());
+            }
+            promise->finish();
+        });
+}
+
+// Moves the finished diff into the model and flips the window into diff mode.
+void MainWindow::handleComparisonFinished() {
+    compareAction->setEnabled(true);
+    cancelComparisonButton->setVisible(false);
+    CatalogComparison comparison;
+    try {
+        comparison = comparisonWatcher->future().takeResult();  // Rethrows what the worker caught.
+    } catch (const std::exception& error) {
+        statusBar()->showMessage(tr("Comparison failed: %1").arg(QString::fromLocal8Bit(error.what())), 4000);
+        return;
+    } catch (...) {
+        statusBar()->showMessage(tr("Comparison failed."), 4000);
+        return;
+    }
+
+    if (comparisonCancellation.cancelled()) {
+        statusBar()->showMessage(tr("Comparison cancelled."), 4000);
+        return;  // The partial results are released as the comparison goes out of scope.
+    }
+
+    for (const LoadResult* side : {&comparison.before, &comparison.after}) {
+        if (!side->ok) {
+            updateWarningsPane(*side);  // Reuse the warning panel so the failure is visible.
+            statusBar()->showMessage(
+                tr("Unable to load catalog: %1").arg(QString::fromStdString(side->path)), 4000);
+            return;
+        }
+    }
+
+    const CatalogDiff& diff = comparison.diff;
+    diffSummaryLabel->setText(
+        tr("%1 → %2\n%3 added, %4 removed, %5 changed, %6 unchanged")
+            .arg(QString::fromStdString(comparison.before.path),
+                 QString::fromStdString(comparison.after.path))
+            .arg(diff.added)
+            .arg(diff.removed)
+            .arg(diff.changed)
+            .arg(diff.unchanged));
+    courseDiffModel->setDiff(std::move(comparison.diff));
+
+    diffCourseLabel->setText(tr("Select a change to view details"));
+    diffPrerequisiteList->clear();
+    viewStack->setCurrentIndex(1);
+    exitDiffAction->setEnabled(true);
+    statusBar()->showMessage(tr("Comparison finished: %1 differences")
+                                 .arg(courseDiffModel->rowCount()));
+}
+
+// Lists each prerequisite of the selected row, coloured by how it changed.
+void MainWindow::handleDiffSelection(const QModelIndex& index) {
+    diffPrerequisiteList->clear();
+    const CourseDiffEntry* entry = courseDiffModel->entryForRow(index.row());
+    if (!entry) {
+        return;
+    }
+
+    const QString id = QString::fromStdString(entry->courseNumber);
+    const QString beforeName = QString::fromStdString(entry->beforeName);
+    const QString afterName = QString::fromStdString(entry->afterName);
+    switch (entry->kind) {
+        case CourseChangeKind::Added:
+            diffCourseLabel->setText(tr("%1 — %2 (added)").arg(id, afterName));
+            break;
+        case CourseChangeKind::Removed:
+            diffCourseLabel->setText(tr("%1 — %2 (removed)").arg(id, beforeName));
+            break;
+        case CourseChangeKind::Changed:
+            diffCourseLabel->setText(beforeName == afterName
+                                         ? tr("%1 — %2").arg(id, afterName)
+                                         : tr("%1 — %2 → %3").arg(id, beforeName, afterName));
+            break;
+    }
+
+    const auto addRows = [this](const std::vector<std::string>& ids, const QString& prefix,
+                                const QColor& colour) {
+        for (const auto& prereqId : ids) {
+            auto* item = new QListWidgetItem(prefix + QString::fromStdString(prereqId));
+            if (colour.isValid()) {
+                item->setForeground(QBrush(colour));
+            }
+            diffPrerequisiteList->addItem(item);
+        }
+    };
+    addRows(entry->addedPrerequisites, QStringLiteral("+ "), QColor(0x2e, 0x7d, 0x32));
+    addRows(entry->removedPrerequisites, QStringLiteral("- "), QColor(0xc6, 0x28, 0x28));
+    addRows(entry->keptPrerequisites, QStringLiteral("  "), QColor());
+
+    if (diffPrerequisiteList->count() == 0) {
+        diffPrerequisiteList->addItem(tr("Prerequisites: none"));
+    }
+}
+
+// Signals the worker; it stops at the next checkpoint and the finished handler cleans up.
+void MainWindow::cancelComparison() {
+    comparisonCancellation.cancel();
+    cancelComparisonButton->setEnabled(false);
+    statusBar()->showMessage(tr("Cancelling comparison…"));
+}
+
+// Drops the diff (freeing its memory) and returns to the regular browser.
+void MainWindow::exitDiffMode() {
+    courseDiffModel->setDiff({});
+    diffPrerequisiteList->clear();
+    viewStack->setCurrentIndex(0);
+    exitDiffAction->setEnabled(false);
+    statusBar()->showMessage(tr("Ready"));
+}
+
 // Loads the catalog from disk, refreshes the models, and surfaces any warnings.
 void MainWindow::loadCatalogFromPath(const QString& path) {
     LoadResult result = catalog.load(path.toStdString());
@@ -231,8 +482,7 @@ void MainWindow::loadCatalogFromPath(const QString& path) {
         return;
     }
 
-    currentCatalogPath = QString::fromStdString(result.path);
-    refreshCourseList();  // Pull in the new IDs for the list view.
+    currentCatalogPath = QString::fromStdString(result.path);  // The list view was already updated by applyCatalogChanges.
     updateStatusFromLoad(result);
     updateWarningsPane(result);  // Keep the warning panel in sync with the latest messages.
 }
@@ -240,11 +490,13 @@ void MainWindow::loadCatalogFromPath(const QString& path) {
 // Fills the detail pane with the selected course and its prerequisite status.
 void MainWindow::populateCourseDetails(const Course* course) {
     if (!course) {
+        displayedCourseId.clear();
         courseTitleLabel->setText(tr("Course not found."));
         prerequisiteList->clear();
         return;
     }
 
+    displayedCourseId = QString::fromStdString(course->courseNumber);
     courseTitleLabel->setText(
         tr("%1 — %2").arg(QString::fromStdString(course->courseNumber),
                           QString::fromStdString(course->courseName)));
@@ -277,8 +529,47 @@ void MainWindow::refreshCourseList() {
     courseListModel->setCourseIds(catalog.ids());
 }
 
+// Refreshes the detail pane only when the shown course or one of its prerequisites changed.
+void MainWindow::applyCatalogChanges(const CatalogChangeSet& changes) {
+    courseListModel->applyChanges(changes, catalog.sortedIds());
+    if (displayedCourseId.isEmpty() || changes.empty()) {
+        return;
+    }
+
+    const std::vector<std::string>& ids = catalog.sortedIds();
+    const auto touched = [&changes, &ids](const std::string& id) {
+        if (std::binary_search(changes.removed.begin(), changes.removed.end(), id)) {
+            return true;
+        }
+        const auto position = std::lower_bound(ids.begin(), ids.end(), id);
+        if (position == ids.end() || *position != id) {
+            return false;
+        }
+        const auto index = static_cast<std::size_t>(position - ids.begin());
+        return std::binary_search(changes.added.begin(), changes.added.end(), index) ||
+               std::binary_search(changes.changed.begin(), changes.changed.end(), index);
+    };
+
+    const std::string shownId = displayedCourseId.toStdString();
+    const Course* course = catalog.get(shownId);
+    bool stale = touched(shownId);
+    if (course && !stale) {
+        stale = std::any_of(course->prerequisites.begin(), course->prerequisites.end(), touched);
+    }
+    if (stale) {
+        populateCourseDetails(course);
+    }
+}
+
 // Announces the latest load result in the status bar so the user knows what happened.
 void MainWindow::updateStatusFromLoad(const LoadResult& result) {
+    if (result.unchanged) {
+        // The core skipped the parse, so the models already show this data.
+        statusBar()->showMessage(tr("%1 is unchanged; %2 courses still loaded")
+                                     .arg(QString::fromStdString(result.path))
+                                     .arg(result.courses));
+        return;
+    }
     statusBar()->showMessage(
         tr("Loaded %1 courses from %2").arg(result.courses).arg(QString::fromStdString(result.path)));
 }
@@ -1,7 +1,18 @@
 #include "gui/models.hpp"
 
+#include <QBrush>
+#include <QColor>
+
+#include <algorithm>
 #include <utility>
 
+namespace {
+
+// Beyond this many inserted/removed rows a single reset is cheaper than per-row signals.
+constexpr std::size_t kIncrementalRowLimit = 512;
+
+}  // namespace
+
 CourseListModel::CourseListModel(QObject* parent)
     : QAbstractListModel(parent) {}
 
@@ -31,6 +42,34 @@ void CourseListModel::setCourseIds(std::vector<std::string> ids) {
     endResetModel();
 }
 
+// Applies a catalog change set row by row; changed courses keep their IDs, so they need no update here.
+void CourseListModel::applyChanges(const CatalogChangeSet& changes, const std::vector<std::string>& sortedIds) {
+    if (changes.added.size() + changes.removed.size() > kIncrementalRowLimit) {
+        setCourseIds(sortedIds);
+        return;
+    }
+
+    // Remove from the back so the rows still to be removed keep their positions.
+    for (auto it = changes.removed.rbegin(); it != changes.removed.rend(); ++it) {
+        const auto row = std::lower_bound(courseIds.begin(), courseIds.end(), *it);
+        if (row == courseIds.end() || *row != *it) {
+            continue;
+        }
+        const int index = static_cast<int>(row - courseIds.begin());
+        beginRemoveRows(QModelIndex(), index, index);
+        courseIds.erase(row);
+        endRemoveRows();
+    }
+
+    // Added indices refer to the final list; inserting in ascending order lands each one in place.
+    for (const std::size_t added : changes.added) {
+        const int index = static_cast<int>(added);
+        beginInsertRows(QModelIndex(), index, index);
+        courseIds.insert(courseIds.begin() + index, sortedIds[added]);
+        endInsertRows();
+    }
+}
+
 // Convenience helper so other widgets can resolve the ID for a given row index.
 QString CourseListModel::courseIdForRow(int row) const {
     if (row < 0 || row >= static_cast<int>(courseIds.size())) {
@@ -38,3 +77,72 @@ QString CourseListModel::courseIdForRow(int row) const {
     }
     return QString::fromStdString(courseIds[row]);  // Helper for selection syncing.
 }
+
+CourseDiffModel::CourseDiffModel(QObject* parent)
+    : QAbstractListModel(parent) {}
+
+// Returns how many changed courses the diff view should render.
+int CourseDiffModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid()) {
+        return 0;
+    }
+    return static_cast<int>(catalogDiff.entries.size());
+}
+
+// Formats a diff row lazily; only visible rows are ever asked for.
+QVariant CourseDiffModel::data(const QModelIndex& index, int role) const {
+    const CourseDiffEntry* entry = index.isValid() ? entryForRow(index.row()) : nullptr;
+    if (!entry) {
+        return {};
+    }
+
+    if (role == Qt::DisplayRole) {
+        const QString id = QString::fromStdString(entry->courseNumber);
+        switch (entry->kind) {
+            case CourseChangeKind::Added:
+                return QStringLiteral("+ %1").arg(id);
+            case CourseChangeKind::Removed:
+                return QStringLiteral("- %1").arg(id);
+            case CourseChangeKind::Changed:
+            default:
+                return QStringLiteral("~ %1").arg(id);
+        }
+    }
+
+    if (role == Qt::ForegroundRole) {
+        switch (entry->kind) {
+            case CourseChangeKind::Added:
+                return QBrush(QColor(0x2e, 0x7d, 0x32));  // Green for new courses.
+            case CourseChangeKind::Removed:
+                return QBrush(QColor(0xc6, 0x28, 0x28));  // Red for dropped courses.
+            case CourseChangeKind::Changed:
+            default:
+                return QBrush(QColor(0xef, 0x6c, 0x00));  // Amber for edited courses.
+        }
+    }
+
+    if (role == Qt::UserRole) {
+        return QString::fromStdString(entry->courseNumber);
+    }
+
+    return {};
+}
+
+// Swaps in a freshly computed diff from the background comparison.
+void CourseDiffModel::setDiff(CatalogDiff diff) {
+    beginResetModel();
+    catalogDiff = std::move(diff);
+    endResetModel();
+}
+
+// Bounds-checked access so the detail pane never reads past the diff.
+const CourseDiffEntry* CourseDiffModel::entryForRow(int row) const {
+    if (row < 0 || row >= static_cast<int>(catalogDiff.entries.size())) {
+        return nullptr;
+    }
+    return &catalogDiff.entries[row];
+}
+
+const CatalogDiff& CourseDiffModel::diff() const {
+    return catalogDiff;
+}
@@ -0,0 +1,178 @@
+// Writes a catalog deep enough for two interior levels to a disk catalog and checks lookups,
+// scans and prefix scans against the in-memory catalog, with and without the node cache, and
+// that damaged pages and headers are reported rather than read.
+
+#include "catalog/catalog.hpp"
+#include "catalog/disk_catalog.hpp"
+#include "test_support.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* const kSubjects[] = {"ARTH", "BIOL", "CHEM", "CSCI", "MATH", "PHYS"};
+
+// Long titles keep leaves to a few dozen records, and long IDs keep interior fanout low, so
+// the tree reaches three levels at a size the test writes in well under a second.
+std::vector<Course> makeCourses() {
+    std::vector<Course> courses;
+    for (const char* subject : kSubjects) {
+        for (int number = 0; number < 4000; ++number) {
+            Course course;
+            course.courseNumber = std::string(subject) + "-" + std::to_string(100000 + number * 3) + "-SECTIONED";
+            course.courseName = "Topics in " + std::string(subject) + " " + std::to_string(number) + ": " +
+                                std::string(60 + number % 40, 'x');
+            if (number % 7 == 0 && number >= 3) {
+                course.prerequisites.push_back(std::string(subject) + "-" + std::to_string(100000 + (number - 3) * 3) +
+                                               "-SECTIONED");
+            }
+            courses.push_back(std::move(course));
+        }
+    }
+    // One record larger than a page, so its leaf spans several.
+    Course huge;
+    huge.courseNumber = "CSCI-100001-SECTIONED";
+    huge.courseName = "Capstone";
+    for (int i = 0; i < 600; ++i) {
+        huge.prerequisites.push_back("CSCI-" + std::to_string(100000 + i * 3) + "-SECTIONED");
+    }
+    courses.push_back(std::move(huge));
+    return courses;
+}
+
+bool sameCourse(const Course& left, const Course& right) {
+    return left.courseNumber == right.courseNumber && left.courseName == right.courseName &&
+           left.prerequisites == right.prerequisites;
+}
+
+void checkAgainstCatalog(const DiskCatalog& disk, const Catalog& catalog, const std::string& label) {
+    const std::vector<std::string>& ids = catalog.sortedIds();
+    check(disk.size() == ids.size(), label + ": same course count");
+    std::string error;
+
+    bool allFound = true;
+    for (std::size_t i = 0; i < ids.size() && allFound; i += 7) {
+        const auto course = disk.get(ids[i], error);
+        allFound = course && sameCourse(*course, *catalog.get(ids[i]));
+        check(allFound, label + ": get(" + ids[i] + ") matches");
+    }
+    for (const char* missing : {"", "AAAA", "CSCI-100000-SECTIONEC", "CSCI-100000-SECTIONEDX", "ZZZZ", "~"}) {
+        check(!disk.get(missing, error), label + ": get('" + missing + "') finds nothing");
+    }
+    check(error.empty(), label + ": misses report no damage");
+
+    std::size_t next = 0;
+    bool inOrder = true;
+    const bool scanned = disk.scan("", [&](const Course& course) {
+        inOrder = inOrder && next < ids.size() && sameCourse(course, *catalog.get(ids[next]));
+        ++next;
+        return true;
+    }, error);
+    check(scanned && inOrder && next == ids.size(), label + ": full scan returns every course in order");
+
+    // Starting points that are IDs, that fall between IDs, and that come after every ID.
+    for (const std::string& from : {ids[ids.size() / 3], ids[ids.size() / 3] + "!", std::string("CSCI"), ids.back(),
+                                    ids.back() + "~"}) {
+        std::size_t expected = 0;
+        while (expected < ids.size() && ids[expected] < from) {
+            ++expected;
+        }
+        const std::size_t first = expected;
+        bool matches = true;
+        disk.scan(from, [&](const Course& course) {
+            matches = matches && expected < ids.size() && course.courseNumber == ids[expected];
+            ++expected;
+            return expected - first < 500;
+        }, error);
+        check(matches, label + ": scan from '" + from + "' starts at the first ID not below it");
+        check(expected - first == std::min<std::size_t>(500, ids.size() - first),
+              label + ": scan from '" + from + "' stops when asked");
+    }
+
+    for (const char* prefix : {"", "C", "CSCI-1001", "MATH-10", "PHYS-111111", "BIOL-103", "Q"}) {
+        std::vector<std::string> expected;
+        for (const std::string& id : ids) {
+            if (id.starts_with(prefix)) {
+                expected.push_back(id);
+            }
+        }
+        std::vector<std::string> found;
+        const bool ok = disk.scanPrefix(prefix, [&](const Course& course) { found.push_back(course.courseNumber); },
+                                        error);
+        check(ok && found == expected, label + ": scanPrefix('" + prefix + "') matches the catalog");
+    }
+}
+
+void flipByte(const std::filesystem::path& path, std::streamoff offset) {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekg(offset);
+    const char byte = static_cast<char>(file.get());
+    file.seekp(offset);
+    file.put(static_cast<char>(byte ^ 0x20));
+}
+
+void checkCorruption(const Catalog& catalog, const std::filesystem::path& source) {
+    const std::vector<std::string>& ids = catalog.sortedIds();
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "disk_catalog_test_damaged.cdb";
+    std::filesystem::copy_file(source, path, std::filesystem::copy_options::overwrite_existing);
+
+    // Page 1 is the first leaf written, so it holds the lowest IDs.
+    flipByte(path, kDiskCatalogPageSize + 200);
+    DiskCatalog disk;
+    std::string error;
+    check(disk.open(path, error), "damaged leaf: the header still opens");
+    check(!disk.get(ids.front(), error) && error.find("CRC-32C") != std::string::npos,
+          "damaged leaf: get reports a CRC failure, got '" + error + "'");
+    error.clear();
+    check(!disk.scan("", [](const Course&) { return true; }, error) && error.find("CRC-32C") != std::string::npos,
+          "damaged leaf: a scan through it reports a CRC failure");
+    error.clear();
+    const auto last = disk.get(ids.back(), error);
+    check(last && sameCourse(*last, *catalog.get(ids.back())) && error.empty(),
+          "damaged leaf: courses in other nodes still read");
+
+    std::filesystem::copy_file(source, path, std::filesystem::copy_options::overwrite_existing);
+    flipByte(path, 12);
+    DiskCatalog damagedHeader;
+    error.clear();
+    check(!damagedHeader.open(path, error) && error.find("CRC-32C") != std::string::npos,
+          "damaged header: open reports a CRC failure, got '" + error + "'");
+    std::filesystem::remove(path);
+}
+
+}  // namespace
+
+int main() {
+    Catalog catalog;
+    check(catalog.build(makeCourses(), "disk catalog test").ok, "the source catalog builds");
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "disk_catalog_test.cdb";
+    std::string error;
+    check(writeDiskCatalog(catalog, path, error), "the disk catalog writes: " + error);
+
+    DiskCatalog cached;
+    check(cached.open(path, error), "the disk catalog opens: " + error);
+    check(cached.height() >= 3, "the tree has more than one interior level, height " + std::to_string(cached.height()));
+    checkAgainstCatalog(cached, catalog, "8 MiB cache");
+
+    DiskCatalog uncached;
+    check(uncached.open(path, error, 1), "the disk catalog opens with no cache: " + error);
+    checkAgainstCatalog(uncached, catalog, "no cache");
+    check(uncached.cacheStats().evictions != 0, "no cache: nodes are evicted");
+
+    Catalog empty;
+    const std::filesystem::path emptyPath = std::filesystem::temp_directory_path() / "disk_catalog_test_empty.cdb";
+    check(writeDiskCatalog(empty, emptyPath, error), "an empty catalog writes");
+    DiskCatalog emptyDisk;
+    check(emptyDisk.open(emptyPath, error) && emptyDisk.size() == 0 && !emptyDisk.get("CSCI", error),
+          "an empty disk catalog opens and finds nothing");
+
+    checkCorruption(catalog, path);
+    std::filesystem::remove(path);
+    std::filesystem::remove(emptyPath);
+    return finishTest("Disk catalog lookups and scans match the catalog.");
+}
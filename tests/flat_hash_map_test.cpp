@@ -0,0 +1,210 @@
+// Applies the same random inserts, erases and lookups to FlatHashMap and std::unordered_map and
+// checks that they always agree, including under tombstone-heavy churn and a pmr allocator.
+
+#include "catalog/flat_hash_map.hpp"
+#include "test_support.hpp"
+
+#include <cstddef>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Long enough that keys and values live on the heap, so a lost or doubled move shows up.
+std::string keyFor(std::size_t number) { return "course-key-" + std::to_string(number) + "-with-a-long-tail"; }
+
+// Sends every key to one of a handful of hashes, so probes run through long shared chains.
+struct ClusteredHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view text) const noexcept { return std::hash<std::string_view>{}(text) % 5; }
+};
+
+template <typename Map>
+bool sameContents(const Map& map, const std::unordered_map<std::string, std::string>& expected) {
+    if (map.size() != expected.size()) {
+        return false;
+    }
+    std::size_t visited = 0;
+    for (const auto& [key, value] : map) {
+        const auto found = expected.find(key);
+        if (found == expected.end() || found->second != value) {
+            return false;
+        }
+        ++visited;
+    }
+    return visited == expected.size();
+}
+
+// keySpace bounds the live entries; a small one keeps erasing and re-inserting the same keys.
+template <typename Map>
+void runRandomOperations(Map& map, std::size_t operations, std::size_t keySpace, std::uint64_t seed,
+                         const std::string& label) {
+    std::unordered_map<std::string, std::string> expected;
+    std::mt19937_64 random(seed);
+    bool agreed = true;
+    for (std::size_t step = 0; step < operations && agreed; ++step) {
+        const std::string key = keyFor(random() % keySpace);
+        switch (random() % 5) {
+        case 0:
+        case 1: {
+            const std::string value = "value-" + std::to_string(step) + "-also-on-the-heap";
+            const auto [mapIt, mapInserted] = map.try_emplace(key, value);
+            const auto [expectedIt, expectedInserted] = expected.try_emplace(key, value);
+            agreed = mapInserted == expectedInserted && mapIt->second == expectedIt->second;
+            break;
+        }
+        case 2:
+        case 3:
+            agreed = map.erase(key) == expected.erase(key);
+            break;
+        default: {
+            const auto found = map.find(std::string_view(key));
+            const auto expectedFound = expected.find(key);
+            agreed = (found == map.end()) == (expectedFound == expected.end()) &&
+                     (found == map.end() || found->second == expectedFound->second);
+            agreed = agreed && map.contains(key) == (expectedFound != expected.end());
+            break;
+        }
+        }
+        if (!agreed) {
+            check(false, label + ": diverged from std::unordered_map at step " + std::to_string(step));
+        }
+    }
+    check(sameContents(map, expected), label + ": same entries after " + std::to_string(operations) + " operations");
+}
+
+void checkDifferential() {
+    for (std::uint64_t seed : {1, 2, 3}) {
+        const std::string label = "seed " + std::to_string(seed);
+        FlatHashMap<std::string, std::string, StringHash> wide;
+        runRandomOperations(wide, 200'000, 20'000, seed, label + " wide");
+        FlatHashMap<std::string, std::string, StringHash> narrow;
+        runRandomOperations(narrow, 200'000, 40, seed, label + " narrow");
+        FlatHashMap<std::string, std::string, ClusteredHash> clustered;
+        runRandomOperations(clustered, 20'000, 300, seed, label + " clustered");
+    }
+}
+
+// Counts what passes through it, to see whether a map allocates and whether it gives it all back.
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+    std::size_t bytesInUse = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        bytesInUse += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override {
+        bytesInUse -= bytes;
+        std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+using PmrMap = FlatHashMap<std::string, std::string, StringHash, std::equal_to<>,
+                           std::pmr::polymorphic_allocator<std::pair<std::string, std::string>>>;
+
+// A fixed number of live entries with constant erase-then-insert churn leaves the table full of
+// tombstones; they must be cleared in place, without allocating or growing the table.
+void checkTombstoneChurn() {
+    for (std::size_t live : {10, 500, 20'000}) {
+        const std::string label = "churn " + std::to_string(live);
+        CountingResource resource;
+        PmrMap map(&resource);
+        std::unordered_map<std::string, std::string> expected;
+        for (std::size_t i = 0; i < live; ++i) {
+            map.try_emplace(keyFor(i), keyFor(i + 1));
+            expected.try_emplace(keyFor(i), keyFor(i + 1));
+        }
+        const std::size_t capacity = map.capacity();
+        const std::size_t allocations = resource.allocations;
+
+        std::vector<std::string> liveKeys;
+        for (std::size_t i = 0; i < live; ++i) {
+            liveKeys.push_back(keyFor(i));
+        }
+        std::mt19937_64 random(live);
+        std::size_t nextKey = live;
+        bool agreed = true;
+        for (std::size_t step = 0; step < 20 * capacity && agreed; ++step) {
+            std::string& victim = liveKeys[random() % live];
+            if (step % 2 == 0) {
+                const auto found = map.find(victim);
+                agreed = found != map.end();
+                if (agreed) {
+                    map.erase(found);
+                }
+            } else {
+                agreed = map.erase(victim) == 1;
+            }
+            agreed = agreed && expected.erase(victim) == 1 && !map.contains(victim);
+            victim = keyFor(nextKey++);
+            agreed = agreed && map.try_emplace(victim, victim).second && expected.try_emplace(victim, victim).second;
+            agreed = agreed && map.contains(victim) && map.size() == live;
+        }
+        check(agreed, label + ": erase and insert agree with std::unordered_map");
+        check(sameContents(map, expected), label + ": same entries after churn");
+        check(map.capacity() == capacity, label + ": tombstones do not grow the table");
+        check(resource.allocations == allocations, label + ": tombstones are cleared without allocating");
+        for (const auto& [key, value] : expected) {
+            const auto found = map.find(key);
+            if (found == map.end() || found->second != value) {
+                check(false, label + ": " + key + " still found after churn");
+                break;
+            }
+        }
+    }
+}
+
+void checkPmrAllocator() {
+    CountingResource first;
+    CountingResource second;
+    {
+        PmrMap map(&first);
+        runRandomOperations(map, 50'000, 5'000, 11, "pmr");
+        check(map.get_allocator().resource() == &first, "pmr: map keeps its resource");
+        check(first.allocations != 0 && second.allocations == 0, "pmr: slots come from the map's resource");
+
+        PmrMap copy(map);
+        check(copy.get_allocator().resource() == std::pmr::get_default_resource(),
+              "pmr: a copy takes the default resource, as std containers do");
+
+        // Unequal resources: move assignment must move entries one by one into second's memory.
+        PmrMap other(&second);
+        other.try_emplace(keyFor(0), "replaced");
+        std::unordered_map<std::string, std::string> expected(map.begin(), map.end());
+        other = std::move(map);
+        check(other.get_allocator().resource() == &second, "pmr: move assignment keeps the target's resource");
+        check(sameContents(other, expected), "pmr: move assignment across resources moves every entry");
+        check(second.allocations != 0, "pmr: moved entries live in the target's resource");
+
+        PmrMap sameResource(&second);
+        const std::size_t before = second.allocations;
+        sameResource = std::move(other);
+        check(second.allocations == before, "pmr: move assignment with an equal resource takes the table");
+        check(sameContents(sameResource, expected), "pmr: entries survive a table move");
+
+        sameResource.clear();
+        check(sameResource.empty() && sameResource.begin() == sameResource.end(), "pmr: clear empties the map");
+        sameResource.try_emplace(keyFor(1), "again");
+        check(sameResource.size() == 1 && sameResource.find(keyFor(1))->second == "again",
+              "pmr: a cleared map is usable");
+    }
+    check(first.bytesInUse == 0 && second.bytesInUse == 0, "pmr: every byte goes back to its resource");
+}
+
+}  // namespace
+
+int main() {
+    checkDifferential();
+    checkTombstoneChurn();
+    checkPmrAllocator();
+    return finishTest("FlatHashMap agrees with std::unordered_map.");
+}
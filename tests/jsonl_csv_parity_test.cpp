@@ -0,0 +1,72 @@
+// Loads the same records as CSV and as JSON Lines and checks that both give identical courses.
+
+#include "catalog/catalog.hpp"
+#include "test_support.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::string describe(const Course* course) {
+    if (course == nullptr) {
+        return "(missing)";
+    }
+    std::string text = course->courseNumber + " " + course->courseName + " [";
+    for (const auto& prereq : course->prerequisites) {
+        text += prereq + " ";
+    }
+    return text + "]";
+}
+
+// Loads both files and compares every course they produce.
+void expectParity(const std::string& label, const std::string& csv, const std::string& jsonl,
+                  const std::vector<std::pair<std::string, std::size_t>>& expectedPrerequisiteCounts) {
+    Catalog fromCsv;
+    Catalog fromJson;
+    const LoadResult csvResult = fromCsv.load(writeTempFile("parity_test.csv", csv).string(), LoadOptions());
+    const LoadResult jsonResult = fromJson.load(writeTempFile("parity_test.jsonl", jsonl).string(), LoadOptions());
+    check(csvResult.ok && jsonResult.ok, label + ": both files load");
+    check(fromCsv.sortedIds() == fromJson.sortedIds(), label + ": same course IDs");
+
+    for (const auto& id : fromCsv.sortedIds()) {
+        const Course* csvCourse = fromCsv.get(id);
+        const Course* jsonCourse = fromJson.get(id);
+        check(describe(csvCourse) == describe(jsonCourse),
+              label + ": " + describe(csvCourse) + " vs " + describe(jsonCourse));
+    }
+    for (const auto& [id, count] : expectedPrerequisiteCounts) {
+        const Course* course = fromJson.get(id);
+        check(course != nullptr && course->prerequisites.size() == count,
+              label + ": " + id + " has " + std::to_string(count) + " prerequisites");
+    }
+}
+
+}  // namespace
+
+int main() {
+    expectParity("numbered prerequisite keys",
+                 "Course ID,Course Title,Prereq 1,Prereq 2\n"
+                 "CSCI401,B,,\nCSCI402,C,,\nCSCI400,A,CSCI401,CSCI402\n",
+                 "{\"id\":\"CSCI401\",\"name\":\"B\"}\n{\"id\":\"CSCI402\",\"name\":\"C\"}\n"
+                 "{\"id\":\"CSCI400\",\"name\":\"A\",\"prereq 1\":\"CSCI401\",\"prereq 2\":\"CSCI402\"}\n",
+                 {{"CSCI400", 2}});
+
+    expectParity("prerequisite keys around the name",
+                 "Course ID,Prereq 2,Course Title,Prereq 1\n"
+                 "CSCI401,,B,\nCSCI402,,C,\nCSCI400,CSCI402,A,CSCI401\n",
+                 "{\"id\":\"CSCI401\",\"name\":\"B\"}\n{\"id\":\"CSCI402\",\"name\":\"C\"}\n"
+                 "{\"id\":\"CSCI400\",\"prereq 2\":\"CSCI402\",\"name\":\"A\",\"prereq 1\":\"CSCI401\"}\n",
+                 {{"CSCI400", 2}});
+
+    expectParity("array after a single prerequisite key",
+                 "Course ID,Prereq 2,Course Title,Prerequisites,Prerequisites\n"
+                 "CSCI401,,B,,\nCSCI402,,C,,\nCSCI403,,D,,\nCSCI400,CSCI402,A,CSCI401,CSCI403\n",
+                 "{\"id\":\"CSCI401\",\"name\":\"B\"}\n{\"id\":\"CSCI402\",\"name\":\"C\"}\n"
+                 "{\"id\":\"CSCI403\",\"name\":\"D\"}\n"
+                 "{\"id\":\"CSCI400\",\"prereq2\":\"CSCI402\",\"name\":\"A\",\"prerequisites\":[\"CSCI401\",\"CSCI403\"]}\n",
+                 {{"CSCI400", 3}});
+
+    return finishTest("JSON Lines and CSV loads agree.");
+}
@@ -0,0 +1,158 @@
+// Pipes request frames through serveBinaryQueries in a stringstream and decodes the replies,
+// covering every opcode, stale and out-of-range handles, and malformed or oversized frames.
+
+#include "catalog/catalog.hpp"
+#include "catalog/query_protocol.hpp"
+#include "catalog/wire_format.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Writes a request frame by hand, for bodies the encoders would never produce.
+std::string rawFrame(std::uint8_t opcode, std::uint32_t requestId, const std::string& body) {
+    std::string payload;
+    payload.push_back(static_cast<char>(opcode));
+    putU32(payload, requestId);
+    payload += body;
+    std::string frame;
+    putU32(frame, static_cast<std::uint32_t>(payload.size()));
+    return frame + payload;
+}
+
+std::vector<QueryResponse> serve(const std::string& requests, const Catalog& catalog, std::string& replies,
+                                 std::size_t& answered) {
+    std::istringstream input(requests);
+    std::ostringstream output;
+    answered = serveBinaryQueries(input, output, catalog);
+    replies = output.str();
+    std::vector<QueryResponse> responses;
+    std::string_view buffer = replies;
+    QueryResponse response;
+    while (takeQueryResponse(buffer, response)) {
+        responses.push_back(response);
+    }
+    check(buffer.empty(), "replies end on a frame boundary");
+    return responses;
+}
+
+void checkQueries(const Catalog& catalog) {
+    const std::vector<std::string>& ids = catalog.sortedIds();
+    const std::uint64_t generation = catalog.generation();
+    const auto handleOf = [&ids](const std::string& id) {
+        return static_cast<std::uint32_t>(std::lower_bound(ids.begin(), ids.end(), id) - ids.begin());
+    };
+
+    std::string requests = encodeInfoRequest(1);
+    requests += encodeResolveRequest(2, {"CSCI200", "NOPE100", "MATH101", ""});
+    requests += encodeGetRequest(3, generation, {handleOf("CSCI300"), static_cast<std::uint32_t>(ids.size()),
+                                                 handleOf("MATH101")});
+    requests += encodeGetRequest(4, generation + 1, {0});
+    requests += rawFrame(42, 5, "");
+    // Resolve promising two IDs but carrying one, then Info with a stray trailing byte.
+    std::string shortBody;
+    putVarint(shortBody, 2);
+    putString(shortBody, "CSCI200");
+    requests += rawFrame(static_cast<std::uint8_t>(QueryOpcode::Resolve), 6, shortBody);
+    requests += rawFrame(static_cast<std::uint8_t>(QueryOpcode::Info), 7, "x");
+    // A payload too short to hold its own request ID.
+    std::string tiny;
+    putU32(tiny, 2);
+    tiny += "\x01\x08";
+    requests += tiny;
+    requests += encodeInfoRequest(8);
+
+    std::string replies;
+    std::size_t answered = 0;
+    const std::vector<QueryResponse> responses = serve(requests, catalog, replies, answered);
+    check(answered == 9 && responses.size() == 9, "every request gets one reply, in order");
+    if (responses.size() != 9) {
+        return;
+    }
+    const std::uint32_t expectedIds[] = {1, 2, 3, 4, 5, 6, 7, 0, 8};
+    for (std::size_t i = 0; i < responses.size(); ++i) {
+        check(responses[i].requestId == expectedIds[i], "reply " + std::to_string(i) + " echoes its request ID");
+    }
+
+    ByteReader info{responses[0].body};
+    check(responses[0].status == QueryStatus::Ok && info.u64() == generation && info.varint() == ids.size() &&
+              info.ok && info.remaining() == 0,
+          "Info reports the generation and course count");
+
+    ByteReader resolve{responses[1].body};
+    const bool resolveHeader = resolve.u64() == generation && resolve.varint() == 4;
+    check(responses[1].status == QueryStatus::Ok && resolveHeader && resolve.varint() == handleOf("CSCI200") + 1 &&
+              resolve.varint() == 0 && resolve.varint() == handleOf("MATH101") + 1 && resolve.varint() == 0 &&
+              resolve.ok && resolve.remaining() == 0,
+          "Resolve returns handle + 1 for known IDs and 0 for unknown and empty ones");
+
+    ByteReader get{responses[2].body};
+    check(responses[2].status == QueryStatus::Ok && get.u64() == generation, "Get replies at the current generation");
+    // CSCI300: two prerequisites, one of which the catalog lacks.
+    check(get.u8() == 1 && get.view() == "CSCI300" && get.view() == "Operating Systems" && get.varint() == 2 &&
+              get.varint() == handleOf("CSCI200") + 1 && get.varint() == 0 && get.view() == "PHYS999",
+          "Get returns the course, a known prerequisite's handle and a missing one's ID");
+    check(get.u8() == 0, "Get marks an out-of-range handle as not found");
+    check(get.u8() == 1 && get.view() == "MATH101" && get.view() == "Calculus I" && get.varint() == 0 && get.ok &&
+              get.remaining() == 0,
+          "Get keeps answering after an out-of-range handle");
+
+    ByteReader stale{responses[3].body};
+    check(responses[3].status == QueryStatus::StaleGeneration && stale.u64() == generation && stale.remaining() == 0,
+          "Get with another generation is refused with the current one");
+    check(responses[4].status == QueryStatus::UnknownOpcode && responses[4].body.empty(),
+          "an unknown opcode is refused without a body");
+    check(responses[5].status == QueryStatus::BadRequest && responses[5].body.empty(),
+          "a truncated body is refused without a partial reply");
+    check(responses[6].status == QueryStatus::BadRequest, "trailing bytes are refused");
+    check(responses[7].status == QueryStatus::BadRequest, "a payload shorter than its header is refused");
+    check(responses[8].status == QueryStatus::Ok, "the session goes on after malformed requests");
+}
+
+void checkSessionEnds(const Catalog& catalog) {
+    // An oversized length cannot be skipped, so the session ends after refusing it.
+    std::string requests = encodeInfoRequest(1);
+    putU32(requests, kMaxQueryFrameBytes + 1);
+    requests += encodeInfoRequest(2);
+    std::string replies;
+    std::size_t answered = 0;
+    std::vector<QueryResponse> responses = serve(requests, catalog, replies, answered);
+    check(answered == 1 && responses.size() == 2 && responses[0].status == QueryStatus::Ok &&
+              responses[1].status == QueryStatus::BadRequest && responses[1].requestId == 0,
+          "an oversized frame is refused and ends the session");
+
+    // A stream cut off inside a frame: the complete requests are answered, the partial one dropped.
+    requests = encodeInfoRequest(1);
+    const std::string cut = encodeResolveRequest(2, {"CSCI200"});
+    requests += cut.substr(0, cut.size() - 3);
+    responses = serve(requests, catalog, replies, answered);
+    check(answered == 1 && responses.size() == 1 && responses[0].requestId == 1,
+          "a frame cut off by the end of the stream gets no reply");
+
+    responses = serve("", catalog, replies, answered);
+    check(answered == 0 && replies.empty(), "an empty session writes nothing");
+}
+
+}  // namespace
+
+int main() {
+    Catalog catalog;
+    const LoadResult built = catalog.build(
+        {
+            {"CSCI100", "Introduction to Programming", {}},
+            {"CSCI200", "Data Structures", {"CSCI100"}},
+            {"CSCI300", "Operating Systems", {"CSCI200", "PHYS999"}},
+            {"MATH101", "Calculus I", {}},
+        },
+        "query protocol test");
+    check(built.ok, "the catalog builds");
+    checkQueries(catalog);
+    checkSessionEnds(catalog);
+    return finishTest("Binary query protocol replies match the requests.");
+}
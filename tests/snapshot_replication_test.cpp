@@ -0,0 +1,263 @@
+// Round-trips a catalog through sectioned snapshots and deltas, checks that damaged headers,
+// sections and deltas are caught, and follows a publisher's directory with replicas that
+// apply deltas and fall back to snapshots.
+
+#include "catalog/catalog.hpp"
+#include "catalog/replication.hpp"
+#include "catalog/snapshot.hpp"
+#include "test_support.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Courses CS10000 up, in steps of ten so IDs between them are known to be missing. tag goes
+// into every tenth title, so catalogs with different tags differ in a tenth of their records.
+std::vector<Course> makeCourses(std::size_t count, const std::string& tag) {
+    std::vector<Course> courses;
+    for (std::size_t i = 0; i < count; ++i) {
+        Course course;
+        course.courseNumber = "CS" + std::to_string(10000 + i * 10);
+        course.courseName = "Course " + std::to_string(i) + (i % 10 == 0 ? " " + tag : std::string()) +
+                            " with a title long enough to fill sections quickly";
+        if (i > 0) {
+            course.prerequisites.push_back("CS" + std::to_string(10000 + (i / 2) * 10));
+        }
+        courses.push_back(std::move(course));
+    }
+    return courses;
+}
+
+bool sameCourse(const Course& left, const Course& right) {
+    return left.courseNumber == right.courseNumber && left.courseName == right.courseName &&
+           left.prerequisites == right.prerequisites;
+}
+
+bool sameCourses(const std::vector<Course>& left, const std::vector<Course>& right) {
+    if (left.size() != right.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < left.size(); ++i) {
+        if (!sameCourse(left[i], right[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool catalogHolds(const Catalog& catalog, const std::vector<Course>& courses) {
+    if (catalog.size() != courses.size()) {
+        return false;
+    }
+    for (const Course& course : courses) {
+        const Course* held = catalog.get(course.courseNumber);
+        if (held == nullptr || !sameCourse(*held, course)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string flipped(std::string bytes, std::size_t offset) {
+    bytes[offset] = static_cast<char>(bytes[offset] ^ 0x01);
+    return bytes;
+}
+
+void checkSnapshotRoundTrip(const CatalogImage& image) {
+    const std::string bytes = encodeSnapshot(image);
+    CatalogImage decoded;
+    std::string error;
+    check(decodeSnapshot(bytes, decoded, error), "snapshot decodes: " + error);
+    check(decoded.generation == image.generation && decoded.checksum == image.checksum &&
+              sameCourses(decoded.courses, image.courses),
+          "snapshot round trip keeps generation, checksum and every course");
+
+    SnapshotReader reader;
+    check(reader.open(bytes, error), "snapshot reader opens: " + error);
+    check(reader.sectionCount() >= 4, "the image spans several sections, got " + std::to_string(reader.sectionCount()));
+    check(reader.courseCount() == image.courses.size(), "reader counts every course");
+
+    std::size_t expectedFirst = 0;
+    for (std::size_t section = 0; section < reader.sectionCount(); ++section) {
+        const std::string label = "section " + std::to_string(section);
+        const std::size_t first = reader.sectionFirstCourse(section);
+        const std::size_t count = reader.sectionCourseCount(section);
+        check(first == expectedFirst && count != 0, label + ": sections tile the image in order");
+        expectedFirst = first + count;
+
+        std::vector<Course> records(count);
+        check(reader.readSection(section, std::span<Course>(records), error) &&
+                  sameCourses(records, std::vector<Course>(image.courses.begin() + first,
+                                                           image.courses.begin() + first + count)),
+              label + ": readSection decodes its courses");
+
+        for (const std::size_t index : {first, first + count - 1}) {
+            const Course& expected = image.courses[index];
+            const auto found = reader.find(expected.courseNumber, error);
+            check(found && sameCourse(*found, expected), label + ": find(" + expected.courseNumber + ")");
+        }
+        // Just past the section's last ID, which sorts before the next section's first.
+        const std::string gap = image.courses[first + count - 1].courseNumber + "5";
+        check(!reader.find(gap, error), label + ": find(" + gap + ") after its last ID finds nothing");
+    }
+    check(expectedFirst == image.courses.size(), "sections cover every course");
+    for (const char* missing : {"", "AA100", "CS0", "CS10005", "ZZ999"}) {
+        check(!reader.find(missing, error), std::string("find('") + missing + "') finds nothing");
+    }
+    check(error.empty(), "misses report no damage");
+    check(reader.verifyAll() && reader.corruptSections().empty(), "an intact snapshot verifies");
+}
+
+void checkSnapshotDamage(const CatalogImage& image) {
+    const std::string bytes = encodeSnapshot(image);
+    std::string error;
+
+    // Byte 12 is inside the generation, right after the magic.
+    const std::string badHeader = flipped(bytes, 12);
+    SnapshotReader reader;
+    check(!reader.open(badHeader, error) && error.find("CRC-32C") != std::string::npos,
+          "a damaged header is reported, got '" + error + "'");
+    CatalogImage untouched;
+    untouched.generation = 99;
+    check(!decodeSnapshot(badHeader, untouched, error) && untouched.generation == 99 && untouched.courses.empty(),
+          "a damaged header fails decoding and leaves the image untouched");
+
+    // The last byte belongs to the last section's records.
+    const std::string badSection = flipped(bytes, bytes.size() - 1);
+    error.clear();
+    SnapshotReader damaged;
+    check(damaged.open(badSection, error), "a damaged section does not stop the header opening");
+    const std::size_t last = damaged.sectionCount() - 1;
+    check(!damaged.find(image.courses.back().courseNumber, error) && error.find("CRC-32C") != std::string::npos,
+          "find in a damaged section reports it, got '" + error + "'");
+    error.clear();
+    const auto intact = damaged.find(image.courses.front().courseNumber, error);
+    check(intact && error.empty(), "other sections still read");
+    check(!damaged.verifyAll() && damaged.corruptSections() == std::vector<std::size_t>{last},
+          "verifyAll names only the damaged section");
+    check(!decodeSnapshot(badSection, untouched, error) && untouched.generation == 99,
+          "a damaged section fails decoding and leaves the image untouched");
+
+    check(!decodeSnapshot(std::string_view(bytes).substr(0, bytes.size() / 2), untouched, error),
+          "a truncated snapshot fails decoding");
+}
+
+void checkDeltas(const CatalogImage& before, const CatalogImage& after) {
+    const std::string delta = encodeDelta(before, after);
+    check(delta.size() < encodeSnapshot(after).size() / 4, "a delta of a tenth of the records is small");
+    CatalogImage applied = before;
+    std::string error;
+    check(applyDelta(delta, applied, error) && applied.generation == after.generation &&
+              applied.checksum == after.checksum && sameCourses(applied.courses, after.courses),
+          "applying a delta gives the later image: " + error);
+    check(!applyDelta(delta, applied, error) && applied.generation == after.generation,
+          "a delta does not apply twice");
+    CatalogImage damaged = before;
+    check(!applyDelta(flipped(delta, delta.size() - 1), damaged, error) && damaged.generation == before.generation &&
+              sameCourses(damaged.courses, before.courses),
+          "a damaged delta is refused and leaves the image untouched");
+}
+
+void checkReplication() {
+    const fs::path directory = fs::temp_directory_path() / "snapshot_replication_test";
+    fs::remove_all(directory);
+    CatalogPublisher publisher(directory.string());
+    CatalogReplica follower(directory.string());
+    Catalog followerCatalog;
+
+    std::vector<std::vector<Course>> versions;
+    for (const char* tag : {"one", "two", "three", "four", "five", "six"}) {
+        versions.push_back(makeCourses(3000 + versions.size() * 50, tag));
+    }
+    const auto publish = [&](std::size_t version) {
+        Catalog source;
+        source.build(versions[version], "version " + std::to_string(version));
+        const PublishResult published = publisher.publish(source);
+        check(published.ok && published.generation == version + 1,
+              "publish version " + std::to_string(version) + " as generation " + std::to_string(version + 1));
+        return published;
+    };
+
+    publish(0);
+    LoadResult synced = follower.sync(followerCatalog);
+    check(synced.ok && follower.generation() == 1 && catalogHolds(followerCatalog, versions[0]),
+          "a new replica starts from the snapshot");
+
+    // A chain of deltas, applied without touching the snapshot.
+    check(publish(1).deltaBytes != 0 && publish(2).deltaBytes != 0, "later generations ship deltas");
+    check(!fs::exists(directory / "snapshot-1.bin") && fs::exists(directory / "snapshot-3.bin"),
+          "only the newest snapshot is kept");
+    synced = follower.sync(followerCatalog);
+    check(synced.ok && synced.warnings.empty() && follower.generation() == 3 &&
+              catalogHolds(followerCatalog, versions[2]),
+          "the replica follows the delta chain to generation 3");
+
+    // Unchanged catalogs publish nothing and sync to the same generation.
+    Catalog same;
+    same.build(versions[2], "version 2 again");
+    check(publisher.publish(same).unchanged, "publishing the same catalog writes nothing");
+    synced = follower.sync(followerCatalog);
+    check(synced.ok && follower.generation() == 3, "a current replica stays put");
+
+    // A missing delta: fall back to the newest snapshot.
+    publish(3);
+    fs::remove(directory / "delta-3-4.bin");
+    synced = follower.sync(followerCatalog);
+    check(synced.ok && follower.generation() == 4 && catalogHolds(followerCatalog, versions[3]),
+          "a replica missing a delta loads the newest snapshot");
+
+    // A damaged delta: warn, then fall back to the snapshot.
+    publish(4);
+    const fs::path deltaPath = directory / "delta-4-5.bin";
+    std::string delta;
+    {
+        std::ifstream in(deltaPath, std::ios::binary);
+        delta.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    std::ofstream(deltaPath, std::ios::binary | std::ios::trunc) << flipped(delta, delta.size() - 1);
+    synced = follower.sync(followerCatalog);
+    check(synced.ok && follower.generation() == 5 && catalogHolds(followerCatalog, versions[4]),
+          "a replica given a damaged delta loads the newest snapshot");
+    check(!synced.warnings.empty() && synced.warnings.front().find("delta-4-5.bin") != std::string::npos,
+          "the damaged delta is reported");
+
+    // A replica that starts late, and a publisher that restarts and resumes numbering.
+    CatalogPublisher restarted(directory.string());
+    Catalog source;
+    source.build(versions[5], "version 5");
+    const PublishResult resumed = restarted.publish(source);
+    check(resumed.ok && resumed.generation == 6 && resumed.deltaBytes != 0,
+          "a restarted publisher resumes from the newest snapshot");
+    CatalogReplica late(directory.string());
+    Catalog lateCatalog;
+    check(late.sync(lateCatalog).ok && late.generation() == 6 && catalogHolds(lateCatalog, versions[5]),
+          "a late replica starts from the newest snapshot");
+    synced = follower.sync(followerCatalog);
+    check(synced.ok && follower.generation() == 6 && catalogHolds(followerCatalog, versions[5]),
+          "the first replica takes the restarted publisher's delta");
+    fs::remove_all(directory);
+}
+
+}  // namespace
+
+int main() {
+    Catalog first;
+    first.build(makeCourses(20000, "first"), "first");
+    Catalog second;
+    second.build(makeCourses(20500, "second"), "second");
+    const CatalogImage before = imageOf(first, 7);
+    const CatalogImage after = imageOf(second, 8);
+
+    checkSnapshotRoundTrip(before);
+    checkSnapshotDamage(before);
+    checkDeltas(before, after);
+    checkReplication();
+    return finishTest("Snapshots, deltas and replicas round-trip and catch damage.");
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+// Checks shared by the core tests. Each test is a plain executable that ctest runs; a
+// failed check prints what it expected and the test exits nonzero at the end.
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+inline int& testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << '\n';
+        ++testFailures();
+    }
+}
+
+// Writes contents to name in the temp directory, replacing any earlier file.
+inline std::filesystem::path writeTempFile(const std::string& name, const std::string& contents) {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << contents;
+    return path;
+}
+
+// Reports the outcome; main returns this.
+inline int finishTest(const std::string& passed) {
+    if (testFailures() != 0) {
+        std::cerr << testFailures() << " check(s) failed.\n";
+        return 1;
+    }
+    std::cout << passed << '\n';
+    return 0;
+}
@@ -0,0 +1,182 @@
+// Loads random sections into a Timetable and checks overlapping() and openSections() against
+// a scan over every section, including back-to-back meetings and sections on several days.
+
+#include "catalog/catalog.hpp"
+#include "catalog/timetable.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char kDayLetters[] = "MTWRFSU";
+
+std::string courseId(std::size_t index) { return "CS" + std::to_string(100 + index); }
+
+std::string clock(std::uint16_t minute) {
+    const std::string hours = std::to_string(minute / 60);
+    const std::string minutes = std::to_string(minute % 60);
+    return (hours.size() < 2 ? "0" : "") + hours + ":" + (minutes.size() < 2 ? "0" : "") + minutes;
+}
+
+std::string sectionRow(const std::string& course, const std::string& section, std::uint8_t days,
+                       std::uint16_t start, std::uint16_t end) {
+    std::string letters;
+    for (std::size_t day = 0; day < kDaysPerWeek; ++day) {
+        if ((days & (1u << day)) != 0) {
+            letters += kDayLetters[day];
+        }
+    }
+    return course + "," + section + "," + letters + "," + clock(start) + "," + clock(end) + ",30\n";
+}
+
+// A catalog of `courses` courses whose prerequisites come from the courses before them.
+std::vector<Course> makeCourses(std::size_t courses, std::mt19937& random) {
+    std::vector<Course> list;
+    for (std::size_t i = 0; i < courses; ++i) {
+        Course course{courseId(i), "Course " + std::to_string(i), {}};
+        for (std::size_t p = i == 0 ? 3 : random() % 4; p < 3; ++p) {
+            course.prerequisites.push_back(courseId(random() % i));
+        }
+        list.push_back(std::move(course));
+    }
+    return list;
+}
+
+// Random sections, plus a pinned pair that meets back to back on Monday and Wednesday.
+std::string makeSections(std::size_t courses, std::mt19937& random) {
+    std::string text = "Course,Section,Days,Start,End,Capacity\n";
+    text += sectionRow(courseId(0), "A", kMonday | kWednesday, 9 * 60, 9 * 60 + 50);
+    text += sectionRow(courseId(1), "A", kMonday | kWednesday, 9 * 60 + 50, 10 * 60 + 40);
+    const std::uint8_t patterns[] = {kMonday | kWednesday | kFriday, kTuesday | kThursday, kMonday, kFriday,
+                                     kSaturday, kMonday | kTuesday | kWednesday | kThursday | kFriday};
+    for (std::size_t i = 2; i < courses; ++i) {
+        const std::size_t sectionCount = random() % 4;  // Some courses are not offered.
+        for (std::size_t s = 0; s < sectionCount; ++s) {
+            const std::uint16_t start = static_cast<std::uint16_t>(7 * 60 + (random() % 150) * 5);
+            const std::uint16_t length = static_cast<std::uint16_t>(random() % 3 == 0 ? 75 : 50);
+            text += sectionRow(courseId(i), std::to_string(s + 1), patterns[random() % std::size(patterns)], start,
+                               static_cast<std::uint16_t>(start + length));
+        }
+    }
+    return text;
+}
+
+std::vector<std::uint32_t> bruteOverlapping(const Timetable& timetable, std::uint8_t days, std::uint16_t start,
+                                            std::uint16_t end) {
+    std::vector<std::uint32_t> handles;
+    for (std::size_t day = 0; day < kDaysPerWeek; ++day) {
+        for (std::uint32_t handle = 0; handle < timetable.size(); ++handle) {
+            const Section& section = timetable.sections()[handle];
+            if ((days & section.days & (1u << day)) != 0 && section.startMinute < end && start < section.endMinute) {
+                handles.push_back(handle);
+            }
+        }
+    }
+    return handles;
+}
+
+std::vector<std::uint32_t> sorted(std::vector<std::uint32_t> handles) {
+    std::sort(handles.begin(), handles.end());
+    return handles;
+}
+
+bool clash(const Section& left, const Section& right) {
+    return (left.days & right.days) != 0 && left.startMinute < right.endMinute &&
+           right.startMinute < left.endMinute;
+}
+
+std::vector<std::uint32_t> bruteOpenSections(const Timetable& timetable, const Catalog& catalog,
+                                             const std::vector<std::string>& taken,
+                                             const std::vector<std::uint32_t>& schedule) {
+    const auto isTaken = [&](const std::string& id) { return std::find(taken.begin(), taken.end(), id) != taken.end(); };
+    std::vector<std::uint32_t> open;
+    for (std::uint32_t handle = 0; handle < timetable.size(); ++handle) {
+        const Section& section = timetable.sections()[handle];
+        const auto& prerequisites = catalog.get(section.courseNumber)->prerequisites;
+        bool eligible = !isTaken(section.courseNumber) && std::all_of(prerequisites.begin(), prerequisites.end(), isTaken);
+        for (const std::uint32_t scheduled : schedule) {
+            const Section& other = timetable.sections()[scheduled];
+            eligible = eligible && other.courseNumber != section.courseNumber && !clash(section, other);
+        }
+        if (eligible) {
+            open.push_back(handle);
+        }
+    }
+    return open;
+}
+
+void checkBackToBack(const Timetable& timetable, const Catalog& catalog) {
+    const auto first = timetable.find(courseId(0), "A");
+    const auto second = timetable.find(courseId(1), "A");
+    check(first && second, "back to back: both pinned sections load");
+    if (!first || !second) {
+        return;
+    }
+    const auto contains = [](const std::vector<std::uint32_t>& handles, std::uint32_t handle) {
+        return std::find(handles.begin(), handles.end(), handle) != handles.end();
+    };
+    std::vector<std::uint32_t> handles;
+    timetable.overlapping(kMonday, 9 * 60 + 50, 10 * 60 + 40, handles);
+    check(!contains(handles, *first) && contains(handles, *second),
+          "back to back: a range starting at a section's end does not overlap it");
+    handles.clear();
+    timetable.overlapping(kWednesday, 9 * 60 + 49, 9 * 60 + 50, handles);
+    check(contains(handles, *first) && !contains(handles, *second), "back to back: its last minute still overlaps");
+    handles.clear();
+    timetable.overlapping(kMonday | kWednesday | kFriday, 9 * 60, 9 * 60 + 1, handles);
+    check(std::count(handles.begin(), handles.end(), *first) == 2,
+          "multi-day: a section is listed once per matching day");
+
+    const std::vector<std::uint32_t> open =
+        timetable.openSections(catalog.get(courseId(1))->prerequisites, {*first});
+    check(contains(open, *second), "back to back: the next section does not clash with the scheduled one");
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 random(42);
+    const std::size_t courseCount = 400;
+    Catalog catalog;
+    check(catalog.build(makeCourses(courseCount, random), "timetable test").ok, "the catalog builds");
+    const std::string path = writeTempFile("timetable_test_sections.csv", makeSections(courseCount, random)).string();
+    Timetable timetable;
+    const TimetableLoadResult loaded = timetable.load(path, catalog);
+    check(loaded.ok && loaded.warnings.empty() && timetable.size() > 400, "the sections load without warnings");
+
+    for (int query = 0; query < 2000; ++query) {
+        const auto days = static_cast<std::uint8_t>(1 + random() % 127);
+        const auto start = static_cast<std::uint16_t>(6 * 60 + random() % (16 * 60));
+        const auto end = static_cast<std::uint16_t>(start + 1 + random() % 180);
+        std::vector<std::uint32_t> handles;
+        timetable.overlapping(days, start, end, handles);
+        if (sorted(handles) != sorted(bruteOverlapping(timetable, days, start, end))) {
+            check(false, "overlapping(" + std::to_string(days) + ", " + clock(start) + ", " + clock(end) +
+                             ") matches a scan of every section");
+            break;
+        }
+    }
+
+    for (int query = 0; query < 500; ++query) {
+        std::vector<std::string> taken;
+        for (std::size_t i = random() % 120; i > 0; --i) {
+            taken.push_back(courseId(random() % courseCount));
+        }
+        std::vector<std::uint32_t> schedule;
+        for (std::size_t i = random() % 5; i > 0; --i) {
+            schedule.push_back(static_cast<std::uint32_t>(random() % timetable.size()));
+        }
+        if (timetable.openSections(taken, schedule) != bruteOpenSections(timetable, catalog, taken, schedule)) {
+            check(false, "openSections matches a scan of every section, query " + std::to_string(query));
+            break;
+        }
+    }
+
+    checkBackToBack(timetable, catalog);
+    return finishTest("Timetable queries match a scan of every section.");
+}
@@ -0,0 +1,235 @@
+// Runs the same slice jobs and task groups on pools of several sizes and checks that results,
+// nesting and error handling do not depend on how many workers there are.
+
+#include "catalog/worker_pool.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::size_t kPoolSizes[] = {1, 2, 3, 8};
+
+// Floating-point sums and string concatenation both change if slices are combined out of order.
+void checkReductions(WorkerPool& pool, const std::string& label) {
+    const std::size_t count = 10'000;
+    double serialSum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        serialSum += 1.0 / static_cast<double>(i + 1);
+    }
+    for (std::size_t grain : {1, 7, 64, 4096, 20'000}) {
+        const std::string where = label + " grain " + std::to_string(grain);
+        const double sum = pool.reduceSlices(
+            TaskPriority::Batch, count, grain, 0.0,
+            [](std::size_t first, std::size_t last) {
+                double part = 0;
+                for (std::size_t i = first; i < last; ++i) {
+                    part += 1.0 / static_cast<double>(i + 1);
+                }
+                return part;
+            },
+            [](double total, double part) { return total + part; });
+        double expectedSum = 0;
+        for (std::size_t first = 0; first < count; first += grain) {
+            double part = 0;
+            for (std::size_t i = first; i < std::min(count, first + grain); ++i) {
+                part += 1.0 / static_cast<double>(i + 1);
+            }
+            expectedSum += part;
+        }
+        check(sum == expectedSum, where + ": sum combines slices in order");
+        check(grain != 20'000 || sum == serialSum, where + ": one slice gives the serial sum");
+
+        const std::string text = pool.reduceSlices(
+            TaskPriority::Interactive, 500, grain, std::string(),
+            [](std::size_t first, std::size_t last) {
+                std::string part;
+                for (std::size_t i = first; i < last; ++i) {
+                    part += std::to_string(i) + ",";
+                }
+                return part;
+            },
+            [](std::string total, std::string part) { return total + part; });
+        std::string expectedText;
+        for (std::size_t i = 0; i < 500; ++i) {
+            expectedText += std::to_string(i) + ",";
+        }
+        check(text == expectedText, where + ": concatenation keeps slice order");
+    }
+}
+
+void checkCoverage(WorkerPool& pool, const std::string& label) {
+    for (std::size_t count : {0, 1, 5, 1000}) {
+        for (std::size_t grain : {0, 1, 3, 1000, 5000}) {
+            std::vector<std::atomic<int>> visits(count);
+            std::atomic<bool> oversized{false};
+            pool.forEachSlice(TaskPriority::Batch, count, grain, [&](std::size_t first, std::size_t last) {
+                if (first >= last || last - first > std::max<std::size_t>(1, grain)) {
+                    oversized = true;
+                }
+                for (std::size_t i = first; i < last; ++i) {
+                    ++visits[i];
+                }
+            });
+            bool once = true;
+            for (const auto& visit : visits) {
+                once = once && visit.load() == 1;
+            }
+            const std::string where = label + " count " + std::to_string(count) + " grain " + std::to_string(grain);
+            check(once, where + ": every index runs exactly once");
+            check(!oversized, where + ": slices are nonempty and at most grain long");
+        }
+    }
+}
+
+// Groups waited for from inside pool tasks; with one worker this only finishes if a waiting
+// worker runs the queued tasks itself.
+void checkNesting(WorkerPool& pool, const std::string& label) {
+    std::atomic<std::size_t> leaves{0};
+    TaskGroup outer(TaskPriority::Interactive, pool);
+    for (int i = 0; i < 8; ++i) {
+        outer.run([&] {
+            TaskGroup inner(TaskPriority::Batch, pool);
+            for (int j = 0; j < 8; ++j) {
+                inner.run([&] {
+                    pool.forEachSlice(TaskPriority::Batch, 100, 10, [&](std::size_t first, std::size_t last) {
+                        leaves += last - first;
+                    });
+                });
+            }
+            inner.wait();
+        });
+    }
+    outer.wait();
+    check(leaves == 8 * 8 * 100, label + ": nested groups run every leaf");
+
+    std::atomic<int> depthReached{0};
+    std::function<void(int)> descend = [&](int depth) {
+        depthReached = std::max(depthReached.load(), depth);
+        if (depth == 6) {
+            return;
+        }
+        TaskGroup group(depth % 2 == 0 ? TaskPriority::Interactive : TaskPriority::Batch, pool);
+        group.run([&descend, depth] { descend(depth + 1); });
+        group.run([&descend, depth] { descend(depth + 1); });
+        group.wait();
+    };
+    descend(0);
+    check(depthReached == 6, label + ": groups nest six deep");
+}
+
+void checkExceptions(WorkerPool& pool, const std::string& label) {
+    std::atomic<std::size_t> ran{0};
+    std::string message;
+    try {
+        pool.forEachSlice(TaskPriority::Batch, 100, 1, [&](std::size_t first, std::size_t) {
+            ++ran;
+            if (first == 37) {
+                throw std::runtime_error("slice 37");
+            }
+        });
+    } catch (const std::runtime_error& error) {
+        message = error.what();
+    }
+    check(message == "slice 37", label + ": forEachSlice rethrows the slice's exception");
+    check(ran == 100, label + ": the other slices still run");
+
+    message.clear();
+    try {
+        pool.reduceSlices(
+            TaskPriority::Interactive, 10, 2, 0,
+            [](std::size_t first, std::size_t) -> int {
+                if (first == 4) {
+                    throw std::logic_error("map");
+                }
+                return 1;
+            },
+            [](int total, int part) { return total + part; });
+    } catch (const std::logic_error& error) {
+        message = error.what();
+    }
+    check(message == "map", label + ": reduceSlices rethrows the map's exception");
+
+    TaskGroup group(TaskPriority::Batch, pool);
+    std::atomic<int> finished{0};
+    for (int i = 0; i < 10; ++i) {
+        group.run([&, i] {
+            if (i == 3) {
+                throw std::runtime_error("task 3");
+            }
+            ++finished;
+        });
+    }
+    message.clear();
+    try {
+        group.wait();
+    } catch (const std::runtime_error& error) {
+        message = error.what();
+    }
+    check(message == "task 3", label + ": wait rethrows the task's exception");
+    check(finished == 9, label + ": the group's other tasks still run");
+
+    // The error is reported once; the group is usable again afterwards.
+    group.run([&] { ++finished; });
+    bool threw = false;
+    try {
+        group.wait();
+    } catch (...) {
+        threw = true;
+    }
+    check(!threw && finished == 10, label + ": a group runs cleanly after reporting an error");
+
+    threw = false;
+    try {
+        TaskGroup unwaited(TaskPriority::Interactive, pool);
+        unwaited.run([] { throw std::runtime_error("dropped"); });
+    } catch (...) {
+        threw = true;
+    }
+    check(!threw, label + ": the destructor waits without throwing");
+}
+
+// On a one-worker pool a batch job started from the worker must hand it over to interactive
+// work queued meanwhile, after the slice in progress rather than after the whole job.
+void checkBatchYield() {
+    WorkerPool pool(1);
+    std::atomic<std::size_t> slicesDone{0};
+    std::atomic<std::size_t> slicesBeforeInteractive{0};
+    TaskGroup group(TaskPriority::Batch, pool);
+    group.run([&] {
+        pool.forEachSlice(TaskPriority::Batch, 50, 1, [&](std::size_t first, std::size_t) {
+            if (first == 0) {
+                pool.submit(TaskPriority::Interactive, [&] { slicesBeforeInteractive = slicesDone.load(); });
+            }
+            ++slicesDone;
+        });
+    });
+    group.wait();
+    check(slicesDone == 50, "yield: the batch job finishes");
+    check(slicesBeforeInteractive == 1, "yield: interactive work runs after the first slice, got " +
+                                            std::to_string(slicesBeforeInteractive.load()));
+    check(pool.stats().batchYields >= 1, "yield: the yield is counted");
+}
+
+}  // namespace
+
+int main() {
+    for (std::size_t size : kPoolSizes) {
+        WorkerPool pool(size);
+        const std::string label = std::to_string(size) + " worker(s)";
+        check(pool.size() == size, label + ": pool has the requested size");
+        checkReductions(pool, label);
+        checkCoverage(pool, label);
+        checkNesting(pool, label);
+        checkExceptions(pool, label);
+    }
+    checkBatchYield();
+    return finishTest("Worker pool results match across pool sizes.");
+}